@@ -0,0 +1,1682 @@
+#include "bit_manip/bit_manip.h"
+#include "bit_manip/bit_sliced.h"
+#include "bit_manip/bit_stream.h"
+#include "bit_manip/bitset.h"
+#include "bit_manip/block_codec.h"
+#include "bit_manip/block_pack.h"
+#include "bit_manip/bulk.h"
+#include "bit_manip/dispatch.h"
+#include "bit_manip/elias_fano.h"
+#include "bit_manip/endian.h"
+#include "bit_manip/hilbert.h"
+#include "bit_manip/layout.h"
+#include "bit_manip/morton.h"
+#include "bit_manip/packed_vector.h"
+#include "bit_manip/permute.h"
+#include "bit_manip/rank_select.h"
+#include "bit_manip/roaring.h"
+#include "bit_manip/scatter_gather.h"
+#include "bit_manip/slot_allocator.h"
+#include "bit_manip/stream_vbyte.h"
+#include "bit_manip/transpose.h"
+#include "bit_manip/varint.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <bit>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+constexpr std::size_t value_count {4096};
+
+template <std::unsigned_integral T>
+std::vector<T> MakeValues(const std::size_t size) {
+    std::vector<T> vals(size);
+    std::uint64_t seed {0x9E3779B97F4A7C15};
+    for (auto& val : vals) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        val = static_cast<T>(seed);
+    }
+
+    return vals;
+}
+
+//! Hide a value from the optimizer so it is treated as a runtime argument.
+template <typename T>
+T Opaque(T val) {
+    benchmark::DoNotOptimize(val);
+    return val;
+}
+
+template <std::unsigned_integral T>
+constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+
+template <std::unsigned_integral T>
+void BM_GetBitsConst(benchmark::State& state) {
+    const auto vals {MakeValues<T>(value_count)};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(GetBits(val, width<T> / 4, width<T> / 2));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_GetBitsRuntime(benchmark::State& state) {
+    const auto vals {MakeValues<T>(value_count)};
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(GetBits(val, begin, count));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_SetBitsConst(benchmark::State& state) {
+    auto vals {MakeValues<T>(value_count)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            SetBits(val, static_cast<T>(0x5A), width<T> / 4, width<T> / 2);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_SetBitsRuntime(benchmark::State& state) {
+    auto vals {MakeValues<T>(value_count)};
+    const auto bits {Opaque(static_cast<T>(0x5A))};
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            SetBits(val, bits, begin, count);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_ClearBitsRuntime(benchmark::State& state) {
+    auto vals {MakeValues<T>(value_count)};
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            ClearBits(val, begin, count);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_FillBitsRuntime(benchmark::State& state) {
+    auto vals {MakeValues<T>(value_count)};
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            FillBits(val, begin, count);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_IsBitSetRuntime(benchmark::State& state) {
+    const auto vals {MakeValues<T>(value_count)};
+    const auto idx {Opaque(width<T> - 1)};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(IsBitSet(val, idx));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_SetBitRuntime(benchmark::State& state) {
+    auto vals {MakeValues<T>(value_count)};
+    const auto idx {Opaque(width<T> - 1)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            SetBit(val, idx);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_ClearBitRuntime(benchmark::State& state) {
+    auto vals {MakeValues<T>(value_count)};
+    const auto idx {Opaque(width<T> - 1)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            ClearBit(val, idx);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_GetBitsBulk(benchmark::State& state) {
+    const auto vals {MakeValues<T>(state.range(0))};
+    std::vector<T> out(vals.size());
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        GetBits(vals, std::span {out}, begin, count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::string {ToString(GetKernelPaths().bulk)});
+    state.SetBytesProcessed(state.iterations() * vals.size() * sizeof(T));
+}
+
+template <std::unsigned_integral T>
+void BM_SetBitsBulk(benchmark::State& state) {
+    auto vals {MakeValues<T>(state.range(0))};
+    const auto bits {MakeValues<T>(vals.size())};
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        SetBits(std::span {vals}, bits, begin, count);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::string {ToString(GetKernelPaths().bulk)});
+    state.SetBytesProcessed(state.iterations() * vals.size() * sizeof(T));
+}
+
+//! The per-element loop that the bulk operations replace.
+template <std::unsigned_integral T>
+void BM_GetBitsLoop(benchmark::State& state) {
+    const auto vals {MakeValues<T>(state.range(0))};
+    std::vector<T> out(vals.size());
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != vals.size(); ++i) {
+            out[i] = GetBits(vals[i], begin, count);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * vals.size() * sizeof(T));
+}
+
+void BM_GetByteRuntime(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto begin {Opaque(std::size_t {CHAR_BIT})};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(GetByte(val, begin));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_GetWordRuntime(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto begin {Opaque(std::size_t {CHAR_BIT})};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(GetWord(val, begin));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_GetDwordRuntime(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto begin {Opaque(std::size_t {CHAR_BIT})};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(GetDword(val, begin));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_SetByteRuntime(benchmark::State& state) {
+    auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto byte {Opaque(std::uint8_t {0x5A})};
+    const auto begin {Opaque(std::size_t {CHAR_BIT})};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            SetByte(val, byte, begin);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_SetWordRuntime(benchmark::State& state) {
+    auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto word {Opaque(std::uint16_t {0x5A5A})};
+    const auto begin {Opaque(std::size_t {CHAR_BIT})};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            SetWord(val, word, begin);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_SetDwordRuntime(benchmark::State& state) {
+    auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto dword {Opaque(std::uint32_t {0x5A5A5A5A})};
+    const auto begin {Opaque(std::size_t {CHAR_BIT})};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            SetDword(val, dword, begin);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_GetHighLowConst(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(GetHighDword(val));
+            benchmark::DoNotOptimize(GetLowDword(val));
+            benchmark::DoNotOptimize(GetHighWord(static_cast<std::uint32_t>(val)));
+            benchmark::DoNotOptimize(GetLowWord(static_cast<std::uint32_t>(val)));
+            benchmark::DoNotOptimize(GetHighByte(static_cast<std::uint16_t>(val)));
+            benchmark::DoNotOptimize(GetLowByte(static_cast<std::uint16_t>(val)));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_CombineBytes(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint8_t>(value_count + 1)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != value_count; ++i) {
+            benchmark::DoNotOptimize(CombineBytes(vals[i + 1], vals[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+void BM_CombineWords(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint16_t>(value_count + 1)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != value_count; ++i) {
+            benchmark::DoNotOptimize(CombineWords(vals[i + 1], vals[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+void BM_CombineDwords(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint32_t>(value_count + 1)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != value_count; ++i) {
+            benchmark::DoNotOptimize(CombineDwords(vals[i + 1], vals[i]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+using Header = BitLayout<std::uint32_t, Field<"ver", 0, 4>, Field<"len", 4, 12>,
+                         Field<"flags", 16, 8>, Field<"type", 24, 8>>;
+
+//! Decode headers field by field with runtime positions.
+void BM_HeaderGetBits(benchmark::State& state) {
+    const auto words {MakeValues<std::uint32_t>(value_count)};
+    const auto begins {Opaque(std::array<std::size_t, 4> {0, 4, 16, 24})};
+    const auto counts {Opaque(std::array<std::size_t, 4> {4, 12, 8, 8})};
+    for (auto _ : state) {
+        for (const auto word : words) {
+            for (std::size_t i {0}; i != begins.size(); ++i) {
+                benchmark::DoNotOptimize(GetBits(word, begins[i], counts[i]));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * words.size());
+}
+
+void BM_HeaderUnpack(benchmark::State& state) {
+    const auto words {MakeValues<std::uint32_t>(value_count)};
+    for (auto _ : state) {
+        for (const auto word : words) {
+            benchmark::DoNotOptimize(Header::Unpack(word));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * words.size());
+}
+
+template <std::size_t Width>
+PackedVector<Width> MakePackedVector(const std::size_t size) {
+    PackedVector<Width> vec;
+    vec.reserve(size);
+    for (const auto val : MakeValues<std::uint32_t>(size)) {
+        vec.push_back(val);
+    }
+
+    return vec;
+}
+
+template <std::size_t Width>
+void BM_PackedVectorGet(benchmark::State& state) {
+    const auto vec {MakePackedVector<Width>(state.range(0))};
+    const auto indices {MakeValues<std::uint32_t>(value_count)};
+    for (auto _ : state) {
+        for (const auto idx : indices) {
+            benchmark::DoNotOptimize(vec[idx % vec.size()]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * indices.size());
+}
+
+template <std::size_t Width>
+void BM_PackedVectorPushBack(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint32_t>(state.range(0))};
+    for (auto _ : state) {
+        PackedVector<Width> vec;
+        for (const auto val : vals) {
+            vec.push_back(val);
+        }
+
+        benchmark::DoNotOptimize(vec);
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::size_t Width>
+void BM_PackedVectorUnpack(benchmark::State& state) {
+    const auto vec {MakePackedVector<Width>(state.range(0))};
+    std::vector<std::uint32_t> out(vec.size());
+    for (auto _ : state) {
+        vec.Unpack(out);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vec.size());
+}
+
+Bitset MakeBitset(const std::size_t size) {
+    Bitset bits {size};
+    const auto vals {MakeValues<std::uint64_t>(size / 8)};
+    for (const auto val : vals) {
+        bits.Set(val % size);
+    }
+
+    return bits;
+}
+
+void BM_BitsetAnd(benchmark::State& state) {
+    auto lhs {MakeBitset(state.range(0))};
+    const auto rhs {MakeBitset(state.range(0))};
+    for (auto _ : state) {
+        lhs &= rhs;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::string {ToString(GetKernelPaths().bitwise)});
+    state.SetBytesProcessed(state.iterations() * lhs.words().size_bytes());
+}
+
+void BM_BitsetOr(benchmark::State& state) {
+    auto lhs {MakeBitset(state.range(0))};
+    const auto rhs {MakeBitset(state.range(0))};
+    for (auto _ : state) {
+        lhs |= rhs;
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::string {ToString(GetKernelPaths().bitwise)});
+    state.SetBytesProcessed(state.iterations() * lhs.words().size_bytes());
+}
+
+void BM_BitsetCount(benchmark::State& state) {
+    const auto bits {MakeBitset(state.range(0))};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(bits.Count());
+    }
+
+    state.SetLabel(std::string {ToString(GetKernelPaths().popcount)});
+    state.SetBytesProcessed(state.iterations() * bits.words().size_bytes());
+}
+
+void BM_BitsetFindNext(benchmark::State& state) {
+    const auto bits {MakeBitset(state.range(0))};
+    for (auto _ : state) {
+        for (auto idx {bits.FindFirst()}; idx != Bitset::npos; idx = bits.FindNext(idx)) {
+            benchmark::DoNotOptimize(idx);
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * bits.words().size_bytes());
+}
+
+void BM_BitsetFillRange(benchmark::State& state) {
+    Bitset bits {static_cast<std::size_t>(state.range(0))};
+    for (auto _ : state) {
+        bits.Fill(3, bits.size() - 6);
+        bits.Clear(3, bits.size() - 6);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * 2 * bits.words().size_bytes());
+}
+
+//! A random bit array with a rank and select index, reused across runs of the same size.
+struct RankSelectFixture {
+    explicit RankSelectFixture(const std::size_t size) :
+        words {MakeValues<std::uint64_t>((size + 63) / 64)}, size {size} {
+        if (size % 64 != 0) {
+            ClearBits(words.back(), size % 64, 64 - size % 64);
+        }
+
+        index = RankSelect {words, size};
+    }
+
+    static const RankSelectFixture& Get(const std::size_t size) {
+        static std::unique_ptr<RankSelectFixture> fixture;
+        if (!fixture || fixture->size != size) {
+            fixture.reset();
+            fixture = std::make_unique<RankSelectFixture>(size);
+        }
+
+        return *fixture;
+    }
+
+    std::vector<std::uint64_t> words;
+    std::size_t size;
+    RankSelect index;
+};
+
+void BM_Rank1(benchmark::State& state) {
+    const auto& fixture {RankSelectFixture::Get(state.range(0))};
+    const auto queries {MakeValues<std::uint64_t>(value_count)};
+    for (auto _ : state) {
+        for (const auto query : queries) {
+            benchmark::DoNotOptimize(fixture.index.Rank1(query % fixture.size));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void BM_Select1(benchmark::State& state) {
+    const auto& fixture {RankSelectFixture::Get(state.range(0))};
+    const auto queries {MakeValues<std::uint64_t>(value_count)};
+    for (auto _ : state) {
+        for (const auto query : queries) {
+            benchmark::DoNotOptimize(fixture.index.Select1(query % fixture.index.ones()));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void BM_ExtractBits(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto mask {Opaque(std::uint64_t {0x5555'0F0F'00FF'8421})};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(ExtractBits(val, mask));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_DepositBits(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto mask {Opaque(std::uint64_t {0x5555'0F0F'00FF'8421})};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(DepositBits(val, mask));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+//! The software version used on CPUs without fast BMI2.
+void BM_CompressBits(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto mask {Opaque(std::uint64_t {0x5555'0F0F'00FF'8421})};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(detail::CompressBits(val, mask));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+//! The per-bit loop that `ExtractBits` replaces.
+void BM_ExtractBitsLoop(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto mask {Opaque(std::uint64_t {0x5555'0F0F'00FF'8421})};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            std::uint64_t result {0};
+            std::size_t out {0};
+            for (auto bits {mask}; bits != 0; bits &= bits - 1) {
+                if (IsBitSet(val, std::countr_zero(bits))) {
+                    SetBit(result, out);
+                }
+
+                ++out;
+            }
+
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+//! The widths of mixed fields, cycling through 1 to 64 bits.
+std::vector<std::size_t> MakeFieldWidths(const std::size_t size) {
+    std::vector<std::size_t> widths(size);
+    for (std::size_t i {0}; i != size; ++i) {
+        widths[i] = i * 37 % 64 + 1;
+    }
+
+    return widths;
+}
+
+void BM_BitWriterMixed(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto widths {MakeFieldWidths(value_count)};
+    std::vector<std::uint8_t> buf(value_count * sizeof(std::uint64_t) + sizeof(std::uint64_t));
+    for (auto _ : state) {
+        BitWriter writer {buf};
+        for (std::size_t i {0}; i != vals.size(); ++i) {
+            writer.Write(vals[i], widths[i]);
+        }
+
+        benchmark::DoNotOptimize(writer.Flush().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_BitReaderMixed(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    const auto widths {MakeFieldWidths(value_count)};
+    BitWriter writer;
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        writer.Write(vals[i], widths[i]);
+    }
+
+    const auto bytes {writer.Release()};
+    for (auto _ : state) {
+        BitReader reader {bytes};
+        for (const auto count : widths) {
+            benchmark::DoNotOptimize(reader.Read(count));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * widths.size());
+}
+
+constexpr std::size_t slot_count {1 << 20};
+
+//! The number of slots each thread holds at once.
+constexpr std::size_t slot_batch {64};
+
+void BM_SlotAllocator(benchmark::State& state) {
+    static std::unique_ptr<SlotAllocator> slots;
+    if (state.thread_index() == 0) {
+        slots = std::make_unique<SlotAllocator>(slot_count);
+    }
+
+    std::vector<std::size_t> owned(slot_batch);
+    for (auto _ : state) {
+        for (auto& slot : owned) {
+            slot = slots->Allocate();
+        }
+
+        for (const auto slot : owned) {
+            slots->Free(slot);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * slot_batch);
+}
+
+//! A free list guarded by a mutex, which the slot allocator replaces.
+void BM_MutexFreeList(benchmark::State& state) {
+    static std::mutex mutex;
+    static std::vector<std::size_t> free_list;
+    if (state.thread_index() == 0) {
+        free_list.resize(slot_count);
+        for (std::size_t i {0}; i != slot_count; ++i) {
+            free_list[i] = slot_count - 1 - i;
+        }
+    }
+
+    std::vector<std::size_t> owned(slot_batch);
+    for (auto _ : state) {
+        for (auto& slot : owned) {
+            const std::lock_guard lock {mutex};
+            slot = free_list.back();
+            free_list.pop_back();
+        }
+
+        for (const auto slot : owned) {
+            const std::lock_guard lock {mutex};
+            free_list.push_back(slot);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * slot_batch);
+}
+
+//! The number of values in the packed column of block benchmarks.
+constexpr std::size_t column_size {1 << 16};
+
+template <std::size_t BlockSize>
+void BM_BlockPack(benchmark::State& state) {
+    const auto width {static_cast<std::size_t>(state.range(0))};
+    auto vals {MakeValues<std::uint32_t>(column_size)};
+    for (auto& val : vals) {
+        val = static_cast<std::uint32_t>(GetBits(val, 0, width));
+    }
+
+    std::vector<std::uint32_t> packed(PackedSize(vals.size(), width));
+    for (auto _ : state) {
+        Pack<BlockSize>(vals, width, packed);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::string {ToString(GetBlockPackIsa<BlockSize>())});
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::size_t BlockSize>
+void BM_BlockUnpack(benchmark::State& state) {
+    const auto width {static_cast<std::size_t>(state.range(0))};
+    const auto vals {MakeValues<std::uint32_t>(PackedSize(column_size, width))};
+    std::vector<std::uint32_t> out(column_size);
+    for (auto _ : state) {
+        Unpack<BlockSize>(vals, width, out);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetLabel(std::string {ToString(GetBlockPackIsa<BlockSize>())});
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+//! The scalar `SetBits` loop that block packing replaces.
+void BM_BlockPackScalar(benchmark::State& state) {
+    const auto width {static_cast<std::size_t>(state.range(0))};
+    const auto vals {MakeValues<std::uint32_t>(column_size)};
+    std::vector<std::uint32_t> packed(PackedSize(vals.size(), width) + 1);
+    for (auto _ : state) {
+        std::size_t pos {0};
+        for (const auto val : vals) {
+            auto combined {CombineDwords(packed[pos / 32 + 1], packed[pos / 32])};
+            SetBits(combined, val, pos % 32, width);
+            packed[pos / 32] = GetLowDword(combined);
+            packed[pos / 32 + 1] = GetHighDword(combined);
+            pos += width;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+//! Decode increasing timestamps with a period of `1000` and a small jitter.
+void BM_BlockDecode(benchmark::State& state) {
+    const auto codec {static_cast<Codec>(state.range(0))};
+    auto vals {MakeValues<std::uint32_t>(column_size)};
+    std::uint32_t time {0};
+    for (auto& val : vals) {
+        time += 1000;
+        val = time + val % 8;
+    }
+
+    std::vector<std::uint32_t> encoded(MaxEncodedSize(vals.size()));
+    encoded.resize(Encode(codec, vals, encoded));
+    std::vector<std::uint32_t> out(vals.size());
+    for (auto _ : state) {
+        Decode(encoded, out);
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["bits_per_value"] =
+        static_cast<double>(encoded.size() * 32) / static_cast<double>(vals.size());
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+//! Make a posting list of `size` increasing document IDs with gaps below `32`.
+std::vector<std::uint32_t> MakePostings(const std::size_t size) {
+    auto vals {MakeValues<std::uint32_t>(size)};
+    std::uint32_t doc {0};
+    for (auto& val : vals) {
+        doc += 1 + val % 32;
+        val = doc;
+    }
+
+    return vals;
+}
+
+void BM_EliasFanoAccess(benchmark::State& state) {
+    const EliasFano seq {MakePostings(static_cast<std::size_t>(state.range(0)))};
+    const auto queries {MakeValues<std::uint64_t>(value_count)};
+    for (auto _ : state) {
+        for (const auto query : queries) {
+            benchmark::DoNotOptimize(seq[query % seq.size()]);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+void BM_EliasFanoIterate(benchmark::State& state) {
+    const EliasFano seq {MakePostings(static_cast<std::size_t>(state.range(0)))};
+    for (auto _ : state) {
+        std::uint32_t sum {0};
+        for (const auto val : seq) {
+            sum += val;
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.counters["bits_per_value"] =
+        static_cast<double>(seq.memory_size() * CHAR_BIT) / static_cast<double>(seq.size());
+    state.SetItemsProcessed(state.iterations() * seq.size());
+}
+
+void BM_EliasFanoNextGeq(benchmark::State& state) {
+    const auto vals {MakePostings(static_cast<std::size_t>(state.range(0)))};
+    const EliasFano seq {vals};
+    const auto queries {MakeValues<std::uint32_t>(value_count)};
+    for (auto _ : state) {
+        for (const auto query : queries) {
+            benchmark::DoNotOptimize(seq.NextGeq(query % vals.back()));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+//! Make values whose bit widths are spread from 1 to the benchmark argument.
+std::vector<std::uint64_t> MakeVarintValues(const benchmark::State& state) {
+    const auto max_width {static_cast<std::uint64_t>(state.range(0))};
+    auto vals {MakeValues<std::uint64_t>(column_size)};
+    for (auto& val : vals) {
+        const auto width {static_cast<std::size_t>(GetByte(val, 0) % max_width) + 1};
+        val = GetBits(val >> CHAR_BIT, 0, width);
+    }
+
+    return vals;
+}
+
+//! Encode values whose bit widths are spread from 1 to the benchmark argument.
+std::vector<std::uint8_t> MakeVarints(const benchmark::State& state) {
+    const auto vals {MakeVarintValues(state)};
+    std::vector<std::uint8_t> encoded(vals.size() * max_varint_size);
+    encoded.resize(EncodeVarints(vals, encoded));
+    return encoded;
+}
+
+void BM_VarintEncode(benchmark::State& state) {
+    const auto vals {MakeVarintValues(state)};
+    std::vector<std::uint8_t> out(vals.size() * max_varint_size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(EncodeVarints(vals, out));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_VarintDecode(benchmark::State& state) {
+    const auto encoded {MakeVarints(state)};
+    std::vector<std::uint64_t> out(column_size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DecodeVarints(encoded, out));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+void BM_VarintDecodeChecked(benchmark::State& state) {
+    const auto encoded {MakeVarints(state)};
+    std::vector<std::uint64_t> out(column_size);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DecodeVarintsChecked(encoded, out));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+//! The per-byte loop that bulk decoding replaces.
+void BM_VarintDecodeLoop(benchmark::State& state) {
+    const auto encoded {MakeVarints(state)};
+    std::vector<std::uint64_t> out(column_size);
+    for (auto _ : state) {
+        std::size_t pos {0};
+        for (auto& val : out) {
+            val = 0;
+            for (std::size_t shift {0};; shift += 7) {
+                const auto byte {encoded[pos++]};
+                val |= static_cast<std::uint64_t>(GetBits(byte, 0, 7)) << shift;
+                if (!IsBitSet(byte, 7)) {
+                    break;
+                }
+            }
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+//! Make values whose bit widths are spread from 1 to the benchmark argument, as for varints.
+std::vector<std::uint32_t> MakeStreamVByteValues(const benchmark::State& state) {
+    const auto max_width {static_cast<std::uint64_t>(state.range(0))};
+    const auto vals {MakeValues<std::uint64_t>(column_size)};
+    std::vector<std::uint32_t> narrow(vals.size());
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        const auto width {static_cast<std::size_t>(GetByte(vals[i], 0) % max_width) + 1};
+        narrow[i] = static_cast<std::uint32_t>(GetBits(vals[i] >> CHAR_BIT, 0, width));
+    }
+
+    return narrow;
+}
+
+void BM_StreamVByteDecode(benchmark::State& state) {
+    const auto vals {MakeStreamVByteValues(state)};
+    std::vector<std::uint8_t> encoded(StreamVByteMaxSize(vals.size()));
+    encoded.resize(EncodeStreamVByte(vals, encoded));
+    std::vector<std::uint32_t> out(vals.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DecodeStreamVByte(encoded, out));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+//! Decode sorted values whose gaps have bit widths spread from 1 to the benchmark argument.
+void BM_StreamVByteDecodeDelta(benchmark::State& state) {
+    auto vals {MakeStreamVByteValues(state)};
+    for (std::size_t i {1}; i != vals.size(); ++i) {
+        vals[i] += vals[i - 1];
+    }
+
+    std::vector<std::uint8_t> encoded(StreamVByteMaxSize(vals.size()));
+    encoded.resize(EncodeStreamVByteDelta(vals, encoded));
+    std::vector<std::uint32_t> out(vals.size());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(DecodeStreamVByteDelta(encoded, out));
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * out.size());
+}
+
+void BM_MortonEncode2D(benchmark::State& state) {
+    const auto xs {MakeValues<std::uint32_t>(value_count)};
+    const auto ys {MakeValues<std::uint32_t>(value_count + 1)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != xs.size(); ++i) {
+            benchmark::DoNotOptimize(MortonEncode2D(xs[i], ys[i + 1]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * xs.size());
+}
+
+//! The per-bit loop that `MortonEncode2D` replaces.
+void BM_MortonEncode2DLoop(benchmark::State& state) {
+    const auto xs {MakeValues<std::uint32_t>(value_count)};
+    const auto ys {MakeValues<std::uint32_t>(value_count + 1)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != xs.size(); ++i) {
+            std::uint64_t key {0};
+            for (std::size_t bit {0}; bit != width<std::uint32_t>; ++bit) {
+                SetBits(key, GetBits(xs[i], bit, 1), bit * 2, 1);
+                SetBits(key, GetBits(ys[i + 1], bit, 1), bit * 2 + 1, 1);
+            }
+
+            benchmark::DoNotOptimize(key);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * xs.size());
+}
+
+void BM_MortonEncode2DBulk(benchmark::State& state) {
+    const auto xs {MakeValues<std::uint32_t>(column_size)};
+    const auto ys {MakeValues<std::uint32_t>(column_size + 1)};
+    std::vector<std::uint64_t> keys(xs.size());
+    for (auto _ : state) {
+        MortonEncode2D(xs, std::span {ys}.subspan(1), keys);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+//! Make coordinates of 3D keys.
+std::vector<std::uint32_t> MakeMorton3DCoords(const std::size_t size, const std::size_t skip) {
+    auto coords {MakeValues<std::uint32_t>(size + skip)};
+    coords.erase(coords.begin(), coords.begin() + static_cast<std::ptrdiff_t>(skip));
+    for (auto& coord : coords) {
+        coord = GetBits(coord, 0, morton_3d_width);
+    }
+
+    return coords;
+}
+
+void BM_MortonEncode3DBulk(benchmark::State& state) {
+    const auto xs {MakeMorton3DCoords(column_size, 0)};
+    const auto ys {MakeMorton3DCoords(column_size, 1)};
+    const auto zs {MakeMorton3DCoords(column_size, 2)};
+    std::vector<std::uint64_t> keys(column_size);
+    for (auto _ : state) {
+        MortonEncode3D(xs, ys, zs, keys);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_MortonDecode3DBulk(benchmark::State& state) {
+    std::vector<std::uint64_t> keys(column_size);
+    MortonEncode3D(MakeMorton3DCoords(column_size, 0), MakeMorton3DCoords(column_size, 1),
+                   MakeMorton3DCoords(column_size, 2), keys);
+    std::vector<std::uint32_t> xs(column_size);
+    std::vector<std::uint32_t> ys(column_size);
+    std::vector<std::uint32_t> zs(column_size);
+    for (auto _ : state) {
+        MortonDecode3D(keys, xs, ys, zs);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_HilbertEncode2D(benchmark::State& state) {
+    const auto xs {MakeValues<std::uint32_t>(value_count)};
+    const auto ys {MakeValues<std::uint32_t>(value_count + 1)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != xs.size(); ++i) {
+            benchmark::DoNotOptimize(HilbertEncode2D(xs[i], ys[i + 1]));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * xs.size());
+}
+
+//! The classic loop that rotates the quadrant of one level at a time.
+void BM_HilbertEncode2DLoop(benchmark::State& state) {
+    const auto xs {MakeValues<std::uint32_t>(value_count)};
+    const auto ys {MakeValues<std::uint32_t>(value_count + 1)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != xs.size(); ++i) {
+            auto x {xs[i]};
+            auto y {ys[i + 1]};
+            std::uint64_t key {0};
+            for (auto level {width<std::uint32_t>}; level != 0; --level) {
+                const auto rx {GetBits(x, level - 1, 1)};
+                const auto ry {GetBits(y, level - 1, 1)};
+                key = (key << 2) | ((3 * rx) ^ ry);
+                if (ry == 0) {
+                    if (rx == 1) {
+                        x = ~x;
+                        y = ~y;
+                    }
+
+                    std::swap(x, y);
+                }
+            }
+
+            benchmark::DoNotOptimize(key);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * xs.size());
+}
+
+void BM_HilbertEncode2DBulk(benchmark::State& state) {
+    const auto xs {MakeValues<std::uint32_t>(column_size)};
+    const auto ys {MakeValues<std::uint32_t>(column_size + 1)};
+    std::vector<std::uint64_t> keys(xs.size());
+    for (auto _ : state) {
+        HilbertEncode2D(xs, std::span {ys}.subspan(1), keys);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_HilbertDecode2DBulk(benchmark::State& state) {
+    const auto keys {MakeValues<std::uint64_t>(column_size)};
+    std::vector<std::uint32_t> xs(keys.size());
+    std::vector<std::uint32_t> ys(keys.size());
+    for (auto _ : state) {
+        HilbertDecode2D(keys, xs, ys);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_HilbertEncode3DBulk(benchmark::State& state) {
+    const auto xs {MakeMorton3DCoords(column_size, 0)};
+    const auto ys {MakeMorton3DCoords(column_size, 1)};
+    const auto zs {MakeMorton3DCoords(column_size, 2)};
+    std::vector<std::uint64_t> keys(column_size);
+    for (auto _ : state) {
+        HilbertEncode3D(xs, ys, zs, keys);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+//! The size of a record with big-endian word, double word and quad word fields.
+constexpr std::size_t record_size {14};
+
+void BM_LoadBE(benchmark::State& state) {
+    const auto bytes {MakeValues<std::uint8_t>(value_count * record_size)};
+    for (auto _ : state) {
+        std::uint64_t sum {0};
+        for (std::size_t pos {0}; pos != bytes.size(); pos += record_size) {
+            const auto* const record {bytes.data() + pos};
+            sum += LoadBE<std::uint16_t>(record) + LoadBE<std::uint32_t>(record + 2)
+                   + LoadBE<std::uint64_t>(record + 6);
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+//! Assemble big-endian fields by hand from bytes.
+void BM_LoadBECombine(benchmark::State& state) {
+    const auto bytes {MakeValues<std::uint8_t>(value_count * record_size)};
+    for (auto _ : state) {
+        std::uint64_t sum {0};
+        for (std::size_t pos {0}; pos != bytes.size(); pos += record_size) {
+            const auto* const record {bytes.data() + pos};
+            const auto word {[record](const std::size_t i) noexcept {
+                return CombineBytes(record[i], record[i + 1]);
+            }};
+            const auto dword {[&](const std::size_t i) noexcept {
+                return CombineWords(word(i), word(i + 2));
+            }};
+            sum += word(0) + dword(2) + CombineDwords(dword(6), dword(10));
+        }
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * value_count);
+}
+
+template <typename T>
+void BM_ByteSwap(benchmark::State& state) {
+    auto vals {MakeValues<T>(column_size)};
+    for (auto _ : state) {
+        ByteSwap(std::span {vals});
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <typename T>
+void BM_ByteSwapLoop(benchmark::State& state) {
+    auto vals {MakeValues<T>(column_size)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            val = ByteSwap(Opaque(val));
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_ReverseBits(benchmark::State& state) {
+    auto vals {MakeValues<T>(column_size)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            val = ReverseBits(Opaque(val));
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+//! Reverse bits one at a time.
+template <std::unsigned_integral T>
+void BM_ReverseBitsLoop(benchmark::State& state) {
+    auto vals {MakeValues<T>(column_size)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            T reversed {0};
+            for (std::size_t i {0}; i != width<T>; ++i) {
+                if (IsBitSet(val, i)) {
+                    SetBit(reversed, width<T> - 1 - i);
+                }
+            }
+
+            val = reversed;
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_ReverseBitsBulk(benchmark::State& state) {
+    auto vals {MakeValues<T>(column_size)};
+    for (auto _ : state) {
+        ReverseBits(std::span {vals});
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+//! Interleave the low and high halves of quad words, the inverse of a perfect outer shuffle.
+BitPermutation<std::uint64_t> MakeShufflePermutation() {
+    BitPermutation<std::uint64_t>::Sources sources {};
+    for (std::size_t i {0}; i != sources.size(); ++i) {
+        sources[i] = static_cast<std::uint8_t>(i % 2 * 32 + i / 2);
+    }
+
+    return BitPermutation<std::uint64_t> {sources};
+}
+
+void BM_BitPermutation(benchmark::State& state) {
+    const auto perm {MakeShufflePermutation()};
+    auto vals {MakeValues<std::uint64_t>(column_size)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            val = perm(Opaque(val));
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_BitPermutationBulk(benchmark::State& state) {
+    const auto perm {MakeShufflePermutation()};
+    auto vals {MakeValues<std::uint64_t>(column_size)};
+    for (auto _ : state) {
+        perm(vals, vals);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+//! The number of rows in a segment filter.
+constexpr std::size_t row_count {std::size_t {1} << 24};
+
+//! Make sorted row IDs, each kept with a probability of `permille / 1000`.
+std::vector<std::uint32_t> MakeRowIds(const std::size_t permille, const std::size_t offset) {
+    const auto rands {MakeValues<std::uint16_t>(row_count + offset)};
+    std::vector<std::uint32_t> rows;
+    for (std::size_t row {0}; row != row_count; ++row) {
+        if (rands[row + offset] % 1000 < permille) {
+            rows.push_back(static_cast<std::uint32_t>(row));
+        }
+    }
+
+    return rows;
+}
+
+Bitset MakeRowBitset(const std::span<const std::uint32_t> rows) {
+    Bitset bits {row_count};
+    for (const auto row : rows) {
+        bits.Set(row);
+    }
+
+    return bits;
+}
+
+template <bool Union>
+void BM_RoaringBitmap(benchmark::State& state) {
+    const auto lhs_rows {MakeRowIds(static_cast<std::size_t>(state.range(0)), 0)};
+    const auto rhs_rows {MakeRowIds(static_cast<std::size_t>(state.range(0)), 1)};
+    const RoaringBitmap lhs {lhs_rows};
+    const RoaringBitmap rhs {rhs_rows};
+    for (auto _ : state) {
+        auto result {Union ? lhs | rhs : lhs & rhs};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["bytes"] = static_cast<double>(lhs.SerializedSize());
+}
+
+template <bool Union>
+void BM_RoaringBitset(benchmark::State& state) {
+    const auto lhs {MakeRowBitset(MakeRowIds(static_cast<std::size_t>(state.range(0)), 0))};
+    const auto rhs {MakeRowBitset(MakeRowIds(static_cast<std::size_t>(state.range(0)), 1))};
+    for (auto _ : state) {
+        auto result {Union ? lhs | rhs : lhs & rhs};
+        benchmark::DoNotOptimize(result);
+    }
+
+    state.counters["bytes"] = static_cast<double>(lhs.words().size_bytes());
+}
+
+//! Make a column of prices below 10000, one for each row.
+std::vector<std::uint16_t> MakePrices() {
+    auto prices {MakeValues<std::uint16_t>(row_count)};
+    for (auto& price : prices) {
+        price %= 10000;
+    }
+
+    return prices;
+}
+
+void BM_BitSlicedBuild(benchmark::State& state) {
+    const auto prices {MakePrices()};
+    for (auto _ : state) {
+        BitSlicedIndex<std::uint16_t> index {prices};
+        benchmark::DoNotOptimize(index);
+    }
+
+    state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+void BM_BitSlicedBetween(benchmark::State& state) {
+    const auto prices {MakePrices()};
+    const BitSlicedIndex<std::uint16_t> index {prices};
+    for (auto _ : state) {
+        auto rows {index.Between(2500, 7499)};
+        benchmark::DoNotOptimize(rows);
+    }
+
+    state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+//! Compare each row and pack the results into a bitset.
+void BM_BitSlicedBetweenLoop(benchmark::State& state) {
+    const auto prices {MakePrices()};
+    for (auto _ : state) {
+        Bitset rows {prices.size()};
+        const auto words {rows.words()};
+        for (std::size_t row {0}; row != prices.size(); ++row) {
+            const bool match {2500 <= prices[row] && prices[row] <= 7499};
+            words[row / Bitset::word_width] |= static_cast<Bitset::Word>(match)
+                                               << (row % Bitset::word_width);
+        }
+
+        benchmark::DoNotOptimize(rows);
+    }
+
+    state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+void BM_BitSlicedSum(benchmark::State& state) {
+    const auto prices {MakePrices()};
+    const BitSlicedIndex<std::uint16_t> index {prices};
+    const auto rows {index.Between(2500, 7499)};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.Sum(rows));
+    }
+
+    state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+void BM_BitSlicedTopK(benchmark::State& state) {
+    const auto prices {MakePrices()};
+    const BitSlicedIndex<std::uint16_t> index {prices};
+    for (auto _ : state) {
+        auto rows {index.TopK(1000)};
+        benchmark::DoNotOptimize(rows);
+    }
+
+    state.SetItemsProcessed(state.iterations() * prices.size());
+}
+
+void BM_Transpose8x8(benchmark::State& state) {
+    auto vals {MakeValues<std::uint64_t>(value_count)};
+    for (auto _ : state) {
+        for (auto& val : vals) {
+            val = Transpose8x8(val);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_Transpose64x64(benchmark::State& state) {
+    auto vals {MakeValues<std::uint64_t>(value_count)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != vals.size(); i += 64) {
+            Transpose64x64(std::span<std::uint64_t, 64> {vals.data() + i, 64});
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size() / 64);
+}
+
+//! Transpose 64 × 64 bit matrices one bit at a time.
+void BM_Transpose64x64Loop(benchmark::State& state) {
+    const auto vals {MakeValues<std::uint64_t>(value_count)};
+    std::vector<std::uint64_t> out(vals.size());
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != vals.size(); i += 64) {
+            for (std::size_t row {0}; row != 64; ++row) {
+                std::uint64_t col {0};
+                for (std::size_t j {0}; j != 64; ++j) {
+                    if (GetBits(vals[i + j], row, 1) != 0) {
+                        SetBit(col, j);
+                    }
+                }
+
+                out[i + row] = col;
+            }
+        }
+
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size() / 64);
+}
+
+//! Transpose `value_count * 16` rows into columns.
+template <std::unsigned_integral T>
+void BM_TransposeBulk(benchmark::State& state) {
+    const auto rows {MakeValues<T>(value_count * 16)};
+    const auto words {rows.size() / 64};
+    std::vector<std::uint64_t> cols(width<T> * words);
+    std::array<std::uint64_t*, width<T>> ptrs;
+    for (std::size_t j {0}; j != ptrs.size(); ++j) {
+        ptrs[j] = cols.data() + j * words;
+    }
+
+    for (auto _ : state) {
+        Transpose<T>(rows, ptrs);
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * rows.size() * sizeof(T));
+}
+
+template <std::unsigned_integral T>
+void BM_CountBitsRuntime(benchmark::State& state) {
+    const auto vals {MakeValues<T>(value_count)};
+    const auto begin {Opaque(width<T> / 4)};
+    const auto count {Opaque(width<T> / 2)};
+    for (auto _ : state) {
+        for (const auto val : vals) {
+            benchmark::DoNotOptimize(CountBits(val, begin, count));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+void BM_PopcountSpan(benchmark::State& state) {
+    const auto words {MakeValues<std::uint64_t>(state.range(0))};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(PopcountSpan(words));
+    }
+
+    state.SetLabel(std::string {ToString(GetKernelPaths().popcount)});
+    state.SetBytesProcessed(state.iterations() * words.size() * sizeof(std::uint64_t));
+}
+
+void BM_PopcountLoop(benchmark::State& state) {
+    const auto words {MakeValues<std::uint64_t>(state.range(0))};
+    for (auto _ : state) {
+        std::size_t count {0};
+        for (const auto word : words) {
+            count += static_cast<std::size_t>(std::popcount(word));
+        }
+
+        benchmark::DoNotOptimize(count);
+    }
+
+    state.SetBytesProcessed(state.iterations() * words.size() * sizeof(std::uint64_t));
+}
+
+//! A field of bits in a value.
+struct Field {
+    std::size_t begin;
+    std::size_t count;
+};
+
+//! Make fields of random widths from zero to the full value, as in mixed-width decoders.
+template <std::unsigned_integral T>
+std::vector<Field> MakeRandomFields(const std::size_t size) {
+    std::vector<Field> fields(size);
+    const auto seeds {MakeValues<std::uint64_t>(size)};
+    for (std::size_t i {0}; i != size; ++i) {
+        const auto count {seeds[i] % (width<T> + 1)};
+        fields[i] = {(seeds[i] >> 32) % (width<T> - count + 1), count};
+    }
+
+    return fields;
+}
+
+template <std::unsigned_integral T>
+void BM_GetBitsRandomWidth(benchmark::State& state) {
+    const auto vals {MakeValues<T>(value_count)};
+    const auto fields {MakeRandomFields<T>(value_count)};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != vals.size(); ++i) {
+            benchmark::DoNotOptimize(GetBits(vals[i], fields[i].begin, fields[i].count));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+template <std::unsigned_integral T>
+void BM_SetBitsRandomWidth(benchmark::State& state) {
+    auto vals {MakeValues<T>(value_count)};
+    const auto fields {MakeRandomFields<T>(value_count)};
+    const auto bits {Opaque(static_cast<T>(0x5A))};
+    for (auto _ : state) {
+        for (std::size_t i {0}; i != vals.size(); ++i) {
+            SetBits(vals[i], bits, fields[i].begin, fields[i].count);
+        }
+
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+}  // namespace
+
+//! Register a benchmark template for every unsigned integral width, with optional settings.
+#define BIT_MANIP_BENCHMARK_ALL_WIDTHS(func, ...)          \
+    BENCHMARK_TEMPLATE(func, std::uint8_t) __VA_ARGS__;   \
+    BENCHMARK_TEMPLATE(func, std::uint16_t) __VA_ARGS__;  \
+    BENCHMARK_TEMPLATE(func, std::uint32_t) __VA_ARGS__;  \
+    BENCHMARK_TEMPLATE(func, std::uint64_t) __VA_ARGS__
+
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_GetBitsConst);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_GetBitsRuntime);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_SetBitsConst);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_SetBitsRuntime);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_ClearBitsRuntime);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_FillBitsRuntime);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_IsBitSetRuntime);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_SetBitRuntime);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_ClearBitRuntime);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_GetBitsBulk, ->Arg(1 << 16)->Arg(1 << 22));
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_SetBitsBulk, ->Arg(1 << 16)->Arg(1 << 22));
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_GetBitsLoop, ->Arg(1 << 16)->Arg(1 << 22));
+
+BENCHMARK(BM_GetByteRuntime);
+BENCHMARK(BM_GetWordRuntime);
+BENCHMARK(BM_GetDwordRuntime);
+BENCHMARK(BM_SetByteRuntime);
+BENCHMARK(BM_SetWordRuntime);
+BENCHMARK(BM_SetDwordRuntime);
+BENCHMARK(BM_GetHighLowConst);
+BENCHMARK(BM_CombineBytes);
+BENCHMARK(BM_CombineWords);
+BENCHMARK(BM_CombineDwords);
+BENCHMARK(BM_HeaderGetBits);
+BENCHMARK(BM_HeaderUnpack);
+BENCHMARK_TEMPLATE(BM_PackedVectorGet, 11)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PackedVectorGet, 17)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PackedVectorPushBack, 11)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PackedVectorPushBack, 17)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PackedVectorUnpack, 11)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PackedVectorUnpack, 17)->Arg(1 << 20);
+BENCHMARK(BM_BitsetAnd)->Arg(1 << 20)->Arg(1 << 26);
+BENCHMARK(BM_BitsetOr)->Arg(1 << 20)->Arg(1 << 26);
+BENCHMARK(BM_BitsetCount)->Arg(1 << 20)->Arg(1 << 26);
+BENCHMARK(BM_BitsetFindNext)->Arg(1 << 20);
+BENCHMARK(BM_BitsetFillRange)->Arg(1 << 20);
+BENCHMARK(BM_Rank1)->Arg(1'000'000)->Arg(1'000'000'000)->Arg(10'000'000'000);
+BENCHMARK(BM_Select1)->Arg(1'000'000)->Arg(1'000'000'000)->Arg(10'000'000'000);
+BENCHMARK(BM_ExtractBits);
+BENCHMARK(BM_DepositBits);
+BENCHMARK(BM_CompressBits);
+BENCHMARK(BM_ExtractBitsLoop);
+BENCHMARK(BM_BitWriterMixed);
+BENCHMARK(BM_BitReaderMixed);
+BENCHMARK(BM_SlotAllocator)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_MutexFreeList)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_BlockPack, 128)->Arg(5)->Arg(13)->Arg(27);
+BENCHMARK_TEMPLATE(BM_BlockPack, 256)->Arg(5)->Arg(13)->Arg(27);
+BENCHMARK_TEMPLATE(BM_BlockUnpack, 128)->Arg(5)->Arg(13)->Arg(27);
+BENCHMARK_TEMPLATE(BM_BlockUnpack, 256)->Arg(5)->Arg(13)->Arg(27);
+BENCHMARK(BM_BlockPackScalar)->Arg(5)->Arg(13)->Arg(27);
+BENCHMARK(BM_BlockDecode)
+    ->Arg(static_cast<int>(Codec::frame_of_reference))
+    ->Arg(static_cast<int>(Codec::delta))
+    ->Arg(static_cast<int>(Codec::delta_of_delta));
+BENCHMARK(BM_EliasFanoAccess)->Arg(1 << 20);
+BENCHMARK(BM_EliasFanoIterate)->Arg(1 << 20);
+BENCHMARK(BM_EliasFanoNextGeq)->Arg(1 << 20);
+BENCHMARK(BM_VarintEncode)->Arg(7)->Arg(14)->Arg(28)->Arg(64);
+BENCHMARK(BM_VarintDecode)->Arg(7)->Arg(14)->Arg(28)->Arg(64);
+BENCHMARK(BM_VarintDecodeChecked)->Arg(7)->Arg(14)->Arg(28)->Arg(64);
+BENCHMARK(BM_VarintDecodeLoop)->Arg(7)->Arg(14)->Arg(28)->Arg(64);
+BENCHMARK(BM_StreamVByteDecode)->Arg(7)->Arg(14)->Arg(28);
+BENCHMARK(BM_StreamVByteDecodeDelta)->Arg(7)->Arg(14)->Arg(28);
+BENCHMARK(BM_MortonEncode2D);
+BENCHMARK(BM_MortonEncode2DLoop);
+BENCHMARK(BM_MortonEncode2DBulk);
+BENCHMARK(BM_MortonEncode3DBulk);
+BENCHMARK(BM_MortonDecode3DBulk);
+BENCHMARK(BM_HilbertEncode2D);
+BENCHMARK(BM_HilbertEncode2DLoop);
+BENCHMARK(BM_HilbertEncode2DBulk);
+BENCHMARK(BM_HilbertDecode2DBulk);
+BENCHMARK(BM_HilbertEncode3DBulk);
+BENCHMARK(BM_LoadBE);
+BENCHMARK(BM_LoadBECombine);
+BENCHMARK(BM_ByteSwap<std::uint16_t>);
+BENCHMARK(BM_ByteSwap<std::uint32_t>);
+BENCHMARK(BM_ByteSwap<std::uint64_t>);
+BENCHMARK(BM_ByteSwapLoop<std::uint32_t>);
+BENCHMARK(BM_ReverseBits<std::uint32_t>);
+BENCHMARK(BM_ReverseBitsLoop<std::uint32_t>);
+BENCHMARK(BM_ReverseBitsBulk<std::uint8_t>);
+BENCHMARK(BM_ReverseBitsBulk<std::uint32_t>);
+BENCHMARK(BM_ReverseBitsBulk<std::uint64_t>);
+BENCHMARK(BM_BitPermutation);
+BENCHMARK(BM_BitPermutationBulk);
+BENCHMARK(BM_RoaringBitmap<false>)->Name("BM_RoaringAnd")->Arg(1)->Arg(10)->Arg(500);
+BENCHMARK(BM_RoaringBitset<false>)->Name("BM_RoaringAndBitset")->Arg(1)->Arg(10)->Arg(500);
+BENCHMARK(BM_RoaringBitmap<true>)->Name("BM_RoaringOr")->Arg(1)->Arg(10)->Arg(500);
+BENCHMARK(BM_RoaringBitset<true>)->Name("BM_RoaringOrBitset")->Arg(1)->Arg(10)->Arg(500);
+BENCHMARK(BM_BitSlicedBuild);
+BENCHMARK(BM_BitSlicedBetween);
+BENCHMARK(BM_BitSlicedBetweenLoop);
+BENCHMARK(BM_BitSlicedSum);
+BENCHMARK(BM_BitSlicedTopK);
+BENCHMARK(BM_Transpose8x8);
+BENCHMARK(BM_Transpose64x64);
+BENCHMARK(BM_Transpose64x64Loop);
+BENCHMARK(BM_TransposeBulk<std::uint8_t>);
+BENCHMARK(BM_TransposeBulk<std::uint16_t>);
+BENCHMARK(BM_TransposeBulk<std::uint64_t>);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_CountBitsRuntime);
+BENCHMARK(BM_PopcountSpan)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK(BM_PopcountLoop)->Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 22);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_GetBitsRandomWidth);
+BIT_MANIP_BENCHMARK_ALL_WIDTHS(BM_SetBitsRandomWidth);
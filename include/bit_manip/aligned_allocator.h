@@ -0,0 +1,52 @@
+/**
+ * @file aligned_allocator.h
+ * @brief An allocator for over-aligned storage.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace bit {
+
+//! The size of a cache line, which is also the width of the widest vector register.
+inline constexpr std::size_t cache_line_size {64};
+
+//! An allocator whose storage starts at a multiple of `Alignment` bytes.
+template <typename T, std::size_t Alignment = cache_line_size>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0);
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    constexpr AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    constexpr AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    [[nodiscard]] T* allocate(const std::size_t size) {
+        return static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t {Alignment}));
+    }
+
+    void deallocate(T* const ptr, const std::size_t size) noexcept {
+        ::operator delete(ptr, size * sizeof(T), std::align_val_t {Alignment});
+    }
+
+    template <typename U>
+    friend constexpr bool operator==(const AlignedAllocator&,
+                                     const AlignedAllocator<U, Alignment>&) noexcept {
+        return true;
+    }
+};
+
+}  // namespace bit
@@ -0,0 +1,162 @@
+/**
+ * @file atomic.h
+ * @brief Atomic bit manipulation of integral values shared between threads.
+ *
+ * @details
+ * Each operation is the atomic counterpart of one in `bit_manip.h`,
+ * applied through `std::atomic_ref` so that plain integral values can be shared.
+ * Setting or clearing bits is a single `fetch_or` or `fetch_and`.
+ * Only storing arbitrary field values needs a compare-and-swap loop.
+ * All accesses to a shared value must be atomic while any thread may modify it.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace bit {
+
+//! Integral types that support atomic bitwise operations.
+template <typename T>
+concept AtomicBitWord = std::integral<T> && !std::same_as<std::remove_cv_t<T>, bool>;
+
+namespace detail {
+
+//! Wrap a value in an atomic reference after checking its alignment.
+template <AtomicBitWord T>
+std::atomic_ref<T> AtomicRef(T& val) noexcept {
+    assert(reinterpret_cast<std::uintptr_t>(&val) % std::atomic_ref<T>::required_alignment == 0);
+    return std::atomic_ref<T> {val};
+}
+
+//! Build a mask with `count` bits set starting at `begin`.
+template <AtomicBitWord T>
+constexpr T FieldMask(const std::size_t begin, const std::size_t count) noexcept {
+    T mask {0};
+    FillBits(mask, begin, count);
+    return mask;
+}
+
+//! Build a mask with a single bit set.
+template <AtomicBitWord T>
+constexpr T BitMask(const std::size_t idx) noexcept {
+    return static_cast<T>(static_cast<std::make_unsigned_t<T>>(1) << idx);
+}
+
+}  // namespace detail
+
+//! Atomically check if a bit is set in an integral value.
+template <AtomicBitWord T>
+bool AtomicIsBitSet(T& val, const std::size_t idx,
+                    const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return IsBitSet(detail::AtomicRef(val).load(order), idx);
+}
+
+//! Atomically get the specified bits in an integral value.
+template <AtomicBitWord T>
+T AtomicGetBits(T& val, const std::size_t begin, const std::size_t count,
+                const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    return GetBits(detail::AtomicRef(val).load(order), begin, count);
+}
+
+//! Atomically set a bit in an integral value.
+template <AtomicBitWord T>
+void AtomicSetBit(T& val, const std::size_t idx,
+                  const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    detail::AtomicRef(val).fetch_or(detail::BitMask<T>(idx), order);
+}
+
+//! Atomically clear a bit in an integral value.
+template <AtomicBitWord T>
+void AtomicClearBit(T& val, const std::size_t idx,
+                    const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    detail::AtomicRef(val).fetch_and(static_cast<T>(~detail::BitMask<T>(idx)), order);
+}
+
+//! Atomically flip a bit in an integral value.
+template <AtomicBitWord T>
+void AtomicFlipBit(T& val, const std::size_t idx,
+                   const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    detail::AtomicRef(val).fetch_xor(detail::BitMask<T>(idx), order);
+}
+
+/**
+ * @brief Atomically set a bit in an integral value.
+ *
+ * @return Whether the bit was already set.
+ */
+template <AtomicBitWord T>
+bool AtomicTestAndSetBit(T& val, const std::size_t idx,
+                         const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    const auto mask {detail::BitMask<T>(idx)};
+    return (detail::AtomicRef(val).fetch_or(mask, order) & mask) != 0;
+}
+
+/**
+ * @brief Atomically clear a bit in an integral value.
+ *
+ * @return Whether the bit was set.
+ */
+template <AtomicBitWord T>
+bool AtomicTestAndClearBit(T& val, const std::size_t idx,
+                           const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    const auto mask {detail::BitMask<T>(idx)};
+    return (detail::AtomicRef(val).fetch_and(static_cast<T>(~mask), order) & mask) != 0;
+}
+
+//! Atomically clear the specified bits in an integral value.
+template <AtomicBitWord T>
+void AtomicClearBits(T& val, const std::size_t begin, const std::size_t count,
+                     const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    detail::AtomicRef(val).fetch_and(static_cast<T>(~detail::FieldMask<T>(begin, count)), order);
+}
+
+//! Atomically fill the specified bits in an integral value.
+template <AtomicBitWord T>
+void AtomicFillBits(T& val, const std::size_t begin, const std::size_t count,
+                    const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    detail::AtomicRef(val).fetch_or(detail::FieldMask<T>(begin, count), order);
+}
+
+/**
+ * @brief Atomically set the value of the specified bits in an integral value.
+ *
+ * @details
+ * A field value of all ones or all zeros is stored with a single `fetch_or` or `fetch_and`.
+ * Other values use a compare-and-swap loop.
+ *
+ * @return The previous value.
+ */
+template <AtomicBitWord T, std::integral Bits>
+T AtomicSetBits(T& val, const Bits bits, const std::size_t begin,
+                const std::size_t count = sizeof(Bits) * CHAR_BIT,
+                const std::memory_order order = std::memory_order_seq_cst) noexcept {
+    const auto mask {detail::FieldMask<T>(begin, count)};
+    T field {0};
+    SetBits(field, bits, begin, count);
+    auto ref {detail::AtomicRef(val)};
+    if (field == mask) {
+        return ref.fetch_or(mask, order);
+    } else if (field == 0) {
+        return ref.fetch_and(static_cast<T>(~mask), order);
+    }
+
+    auto old {ref.load(std::memory_order_relaxed)};
+    while (!ref.compare_exchange_weak(old, static_cast<T>((old & ~mask) | field), order)) {
+    }
+
+    return old;
+}
+
+}  // namespace bit
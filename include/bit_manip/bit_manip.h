@@ -10,6 +10,9 @@
  * - Setting bits, bytes, words or double words in an integral value.
  * - Filling bits, bytes, words or double words in an integral value.
  * - Combining bits, bytes, words or double words to a larger integral value.
+ * - Counting set bits, leading zeros or trailing zeros in an integral value.
+ *
+ * Masks of runtime widths are built without branching on the width.
  *
  * @par GitHub
  * https://github.com/Zhuagenborn
@@ -17,45 +20,113 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <climits>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
+
+#if defined(__BMI2__)
+    #include <immintrin.h>
+#endif
 
 namespace bit {
 
-//! Get the specified bits in an integral value.
+namespace detail {
+
+//! The width of the widest mask.
+constexpr std::size_t max_mask_width {sizeof(std::uint64_t) * CHAR_BIT};
+
+//! Masks with the low `i` bits set, for each `i` from zero to the widest mask.
+inline constexpr auto low_masks {[] {
+    std::array<std::uint64_t, max_mask_width + 1> masks {};
+    for (std::size_t i {1}; i != masks.size(); ++i) {
+        masks[i] = (masks[i - 1] << 1) | 1;
+    }
+
+    return masks;
+}()};
+
+//! A range of bits clamped to a value.
+struct BitRange {
+    std::size_t begin;
+    std::size_t count;
+};
+
+/**
+ * @brief Clamp a range of bits to a value of `T`.
+ *
+ * @details
+ * A range covering the whole value starts at zero whatever `begin` is.
+ * The start is masked arithmetically, so the only comparison is the clamp itself.
+ */
+template <std::integral T>
+constexpr BitRange ClampRange(const std::size_t begin, const std::size_t count) noexcept {
+    constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+    const auto clamped {std::min(count, width)};
+    // The quotient is one only for a whole value.
+    return {begin & (clamped / width - 1), clamped};
+}
+
+}  // namespace detail
+
+/**
+ * @brief Build a mask with the low `count` bits set.
+ *
+ * @details
+ * A `count` of at least the width of `T` sets all bits.
+ * The mask never depends on a branch on `count`:
+ * it is built with `BZHI` when BMI2 is enabled at compile time and looked up in a table otherwise.
+ */
+template <std::integral T>
+constexpr std::make_unsigned_t<T> LowMask(const std::size_t count) noexcept {
+    using Mask = std::make_unsigned_t<T>;
+    const auto width {std::min(count, detail::max_mask_width)};
+#if defined(__BMI2__)
+    if (!std::is_constant_evaluated()) {
+        return static_cast<Mask>(
+            _bzhi_u64(static_cast<std::uint64_t>(-1), static_cast<unsigned>(width)));
+    }
+#endif
+    return static_cast<Mask>(detail::low_masks[width]);
+}
+
+/**
+ * @brief Get the specified bits in an integral value.
+ *
+ * @details
+ * The result has the type of `val` but is never sign-extended.
+ * Signed values are shifted as their unsigned type,
+ * so `GetBits(std::int64_t {-1}, 60, 4)` is `0xF` rather than `-1`.
+ */
 constexpr auto GetBits(const std::integral auto val, const std::size_t begin,
                        const std::size_t count) noexcept {
-    if (count < sizeof(val) * CHAR_BIT) {
-        const auto mask {((static_cast<decltype(val)>(1) << count) - 1) << begin};
-        return static_cast<decltype(val)>((val & mask) >> begin);
-    } else {
-        return val;
-    }
+    using Val = decltype(val);
+    const auto range {detail::ClampRange<Val>(begin, count)};
+    const auto bits {static_cast<std::make_unsigned_t<Val>>(val) >> range.begin};
+    return static_cast<Val>(bits & LowMask<Val>(range.count));
 }
 
 //! Clear the specified bits in an integral value.
 constexpr void ClearBits(std::integral auto& val, const std::size_t begin,
                          const std::size_t count) noexcept {
-    if (count < sizeof(val) * CHAR_BIT) {
-        const auto mask {((static_cast<std::decay_t<decltype(val)>>(1) << count) - 1) << begin};
-        val &= ~mask;
-    } else {
-        val = 0;
-    }
+    using Val = std::decay_t<decltype(val)>;
+    const auto range {detail::ClampRange<Val>(begin, count)};
+    val &= static_cast<Val>(~(LowMask<Val>(range.count) << range.begin));
 }
 
 //! Set the value of the specified bits in an integral value.
 template <std::integral Bits>
 constexpr void SetBits(std::integral auto& val, const Bits bits, const std::size_t begin,
                        const std::size_t count = sizeof(Bits) * CHAR_BIT) noexcept {
-    if (count < sizeof(val) * CHAR_BIT) {
-        ClearBits(val, begin, count);
-        const auto mask {((static_cast<std::decay_t<decltype(val)>>(1) << count) - 1) << begin};
-        val |= (static_cast<std::decay_t<decltype(val)>>(bits) << begin) & mask;
-    } else {
-        val = static_cast<std::decay_t<decltype(val)>>(bits);
-    }
+    using Val = std::decay_t<decltype(val)>;
+    const auto range {detail::ClampRange<Val>(begin, count)};
+    const auto mask {static_cast<Val>(LowMask<Val>(range.count) << range.begin)};
+    val &= static_cast<Val>(~mask);
+    val |= static_cast<Val>((static_cast<Val>(bits) << range.begin) & mask);
 }
 
 //! Fill the specified bits in an integral value.
@@ -79,6 +150,35 @@ constexpr void ClearBit(std::integral auto& val, const std::size_t idx) noexcept
     val &= ~(static_cast<std::decay_t<decltype(val)>>(1) << idx);
 }
 
+//! Count the set bits in an integral value. Signed values count their two's complement bits.
+constexpr std::size_t CountBits(const std::integral auto val) noexcept {
+    return static_cast<std::size_t>(
+        std::popcount(static_cast<std::make_unsigned_t<decltype(val)>>(val)));
+}
+
+/**
+ * @brief Count the set bits among the specified bits in an integral value.
+ *
+ * @details
+ * Signed values are counted in their two's complement bits, as `GetBits` extracts them.
+ */
+constexpr std::size_t CountBits(const std::integral auto val, const std::size_t begin,
+                                const std::size_t count) noexcept {
+    return CountBits(GetBits(static_cast<std::make_unsigned_t<decltype(val)>>(val), begin, count));
+}
+
+//! Count the consecutive zero bits from the most significant bit. A zero value has all of them.
+constexpr std::size_t CountLeadingZeros(const std::integral auto val) noexcept {
+    return static_cast<std::size_t>(
+        std::countl_zero(static_cast<std::make_unsigned_t<decltype(val)>>(val)));
+}
+
+//! Count the consecutive zero bits from the least significant bit. A zero value has all of them.
+constexpr std::size_t CountTrailingZeros(const std::integral auto val) noexcept {
+    return static_cast<std::size_t>(
+        std::countr_zero(static_cast<std::make_unsigned_t<decltype(val)>>(val)));
+}
+
 //! Get a byte from an integral value.
 constexpr std::uint8_t GetByte(const std::integral auto val, const std::size_t begin) noexcept {
     static_assert(sizeof(decltype(val)) >= sizeof(std::uint8_t));
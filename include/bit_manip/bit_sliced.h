@@ -0,0 +1,253 @@
+/**
+ * @file bit_sliced.h
+ * @brief A bit-sliced index over unsigned integer columns.
+ *
+ * @details
+ * Slice `i` is a bitset holding `IsBitSet(vals[row], i)` for every row.
+ * Range predicates compare all rows with a value from the most significant slice down,
+ * so each predicate reads every slice once and handles 64 rows per word operation.
+ * The slices are built with the bulk bit-matrix transpose.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "bitset.h"
+#include "transpose.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bit {
+
+/**
+ * @brief A bit-sliced index over a column of unsigned integers.
+ *
+ * @details
+ * Predicates return a bitset with a bit for each row.
+ * Values of `T` take `sizeof(T) * 8` slices,
+ * so the index is as large as the column plus padding to whole cache lines.
+ */
+template <std::unsigned_integral T>
+class BitSlicedIndex {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    //! The number of slices.
+    static constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+
+    //! Create an index over an empty column, which still has a slice for each bit.
+    BitSlicedIndex() : slices_(width) {}
+
+    //! Build an index over a column.
+    explicit BitSlicedIndex(const std::span<const T> vals) : size_ {vals.size()} {
+        slices_.reserve(width);
+        for (std::size_t i {0}; i != width; ++i) {
+            slices_.emplace_back(size_);
+        }
+
+        std::array<std::uint64_t*, width> cols;
+        for (std::size_t i {0}; i != width; ++i) {
+            cols[i] = slices_[i].words().data();
+        }
+
+        Transpose<T>(vals, cols);
+    }
+
+    constexpr size_type size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    //! The slice of bit `i`.
+    const Bitset& slice(const std::size_t i) const noexcept {
+        assert(i < width);
+        return slices_[i];
+    }
+
+    //! Rebuild the value of a row from the slices.
+    T operator[](const size_type row) const noexcept {
+        assert(row < size_);
+        T val {0};
+        for (std::size_t i {0}; i != width; ++i) {
+            if (slices_[i].IsSet(row)) {
+                SetBit(val, i);
+            }
+        }
+
+        return val;
+    }
+
+    //! Find the rows whose values are less than `val`.
+    Bitset LessThan(const T val) const {
+        return Match<1>({val}, [](const std::array<Comparison, 1>& cmps,
+                                  const std::size_t k) noexcept { return cmps[0].less[k]; });
+    }
+
+    //! Find the rows whose values are less than or equal to `val`.
+    Bitset LessEqual(const T val) const {
+        return Match<1>({val},
+                        [](const std::array<Comparison, 1>& cmps, const std::size_t k) noexcept {
+                            return cmps[0].less[k] | cmps[0].equal[k];
+                        });
+    }
+
+    //! Find the rows whose values are equal to `val`.
+    Bitset Equal(const T val) const {
+        return Match<1>({val}, [](const std::array<Comparison, 1>& cmps,
+                                  const std::size_t k) noexcept { return cmps[0].equal[k]; });
+    }
+
+    //! Find the rows whose values are in `[lower, upper]`.
+    Bitset Between(const T lower, const T upper) const {
+        return Match<2>({lower, upper},
+                        [](const std::array<Comparison, 2>& cmps, const std::size_t k) noexcept {
+                            return ~cmps[0].less[k] & (cmps[1].less[k] | cmps[1].equal[k]);
+                        });
+    }
+
+    /**
+     * @brief Sum all values.
+     *
+     * @details
+     * Each slice contributes its number of set bits times its place value.
+     * The sum wraps around modulo 2^64.
+     */
+    std::uint64_t Sum() const noexcept {
+        std::uint64_t sum {0};
+        for (std::size_t i {0}; i != width; ++i) {
+            sum += static_cast<std::uint64_t>(slices_[i].Count()) << i;
+        }
+
+        return sum;
+    }
+
+    //! Sum the values of the rows set in `rows`, which has a bit for each row.
+    std::uint64_t Sum(const Bitset& rows) const {
+        assert(rows.size() == size_);
+        std::uint64_t sum {0};
+        Bitset selected;
+        for (std::size_t i {0}; i != width; ++i) {
+            selected = slices_[i];
+            selected &= rows;
+            sum += static_cast<std::uint64_t>(selected.Count()) << i;
+        }
+
+        return sum;
+    }
+
+    /**
+     * @brief Find the `count` rows with the largest values.
+     *
+     * @details
+     * Going down from the most significant slice,
+     * rows with the bit set are taken while they fit and kept as the only candidates otherwise.
+     * Ties at the end are broken by taking the first rows.
+     */
+    Bitset TopK(const size_type count) const {
+        if (count >= size_) {
+            return Bitset {size_, true};
+        }
+
+        Bitset top {size_};
+        Bitset candidates {size_, true};
+        size_type top_count {0};
+        for (std::size_t i {width}; i-- != 0 && top_count != count;) {
+            auto larger {candidates & slices_[i]};
+            const auto larger_count {larger.Count()};
+            if (top_count + larger_count <= count) {
+                top |= larger;
+                top_count += larger_count;
+                candidates.AndNot(slices_[i]);
+            } else {
+                candidates = std::move(larger);
+            }
+        }
+
+        // The remaining candidates have equal values.
+        for (auto row {candidates.FindFirst()}; top_count != count;
+             row = candidates.FindNext(row), ++top_count) {
+            top.Set(row);
+        }
+
+        return top;
+    }
+
+private:
+    static constexpr std::size_t line_words {cache_line_size / sizeof(Bitset::Word)};
+
+    using Line = std::array<Bitset::Word, line_words>;
+
+    //! The rows of a cache line whose values are less than or equal to a value.
+    struct Comparison {
+        Line less;
+        Line equal;
+    };
+
+    /**
+     * @brief Compare the rows of a cache line with a value.
+     *
+     * @details
+     * A row stays equal while its bits match those of `val`,
+     * and becomes less at the first bit where `val` has a one and the row has a zero.
+     */
+    Comparison Compare(const T val, const std::size_t first) const noexcept {
+        Comparison cmp;
+        cmp.less.fill(0);
+        cmp.equal.fill(static_cast<Bitset::Word>(-1));
+        for (std::size_t i {width}; i-- != 0;) {
+            const auto* const words {slices_[i].words().data() + first};
+            const auto bit {IsBitSet(val, i) ? static_cast<Bitset::Word>(-1) : 0};
+            for (std::size_t k {0}; k != line_words; ++k) {
+                cmp.less[k] |= cmp.equal[k] & ~words[k] & bit;
+                cmp.equal[k] &= ~(words[k] ^ bit);
+            }
+        }
+
+        return cmp;
+    }
+
+    /**
+     * @brief Compare all rows with values and combine the comparisons of each word.
+     *
+     * @details
+     * Rows are processed a cache line at a time, so each slice is read once.
+     */
+    template <std::size_t Count, typename Combine>
+    Bitset Match(const std::array<T, Count>& vals, Combine combine) const {
+        // Start with the existing rows, so rows beyond the size stay cleared.
+        Bitset matches {size_, true};
+        const auto words {matches.words()};
+        for (std::size_t first {0}; first != words.size(); first += line_words) {
+            std::array<Comparison, Count> cmps;
+            for (std::size_t j {0}; j != Count; ++j) {
+                cmps[j] = Compare(vals[j], first);
+            }
+
+            for (std::size_t k {0}; k != line_words; ++k) {
+                words[first + k] &= combine(cmps, k);
+            }
+        }
+
+        return matches;
+    }
+
+    std::vector<Bitset> slices_;
+    size_type size_ {0};
+};
+
+}  // namespace bit
@@ -0,0 +1,268 @@
+/**
+ * @file bit_stream.h
+ * @brief Sequential writing and reading of variable-width bit fields.
+ *
+ * @details
+ * Fields are packed least significant bit first, following `GetBits` and `SetBits`:
+ * bit `i` of a stream is bit `i % 8` of byte `i / 8`.
+ * The writer collects fields in a 64-bit accumulator and stores it eight bytes at a time.
+ * The reader refills its accumulator with one unaligned eight-byte load
+ * and no data-dependent branch.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "endian.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace bit {
+
+//! A writer that appends bit fields to a buffer.
+class BitWriter {
+public:
+    //! Create a writer with a growable buffer.
+    BitWriter() = default;
+
+    //! Create a writer into a caller-provided buffer.
+    explicit BitWriter(const std::span<std::uint8_t> buf) noexcept :
+        buf_ {buf}, growable_ {false} {}
+
+    BitWriter(const BitWriter&) = delete;
+    BitWriter& operator=(const BitWriter&) = delete;
+
+    /**
+     * @brief Append the low `count` bits of a value.
+     *
+     * @param count The number of bits, from 1 to 64.
+     */
+    void Write(const std::uint64_t val, const std::size_t count) {
+        assert(count > 0 && count <= word_width);
+        const auto bits {GetBits(val, 0, count)};
+        acc_ |= bits << used_;
+        used_ += count;
+        if (used_ >= word_width) {
+            FlushWord(acc_);
+            used_ -= word_width;
+            // Keep the bits that did not fit. Two shifts avoid shifting by 64.
+            acc_ = (bits >> (count - used_ - 1)) >> 1;
+        }
+    }
+
+    //! Append a single bit.
+    void WriteBit(const bool bit) {
+        Write(bit, 1);
+    }
+
+    //! Append cleared bits up to the next byte boundary.
+    void AlignToByte() {
+        if (const auto rest {used_ % CHAR_BIT}; rest != 0) {
+            Write(0, CHAR_BIT - rest);
+        }
+    }
+
+    //! The number of bits written.
+    std::size_t size() const noexcept {
+        return pos_ * CHAR_BIT + used_;
+    }
+
+    //! Whether all bits fit in a caller-provided buffer.
+    bool good() const noexcept {
+        return good_;
+    }
+
+    /**
+     * @brief Store the pending bits and get the written bytes.
+     *
+     * @details
+     * The last byte is padded with cleared bits. More fields can be written afterwards.
+     */
+    std::span<const std::uint8_t> Flush() {
+        const auto bytes {(used_ + CHAR_BIT - 1) / CHAR_BIT};
+        if (bytes != 0 && Reserve(bytes)) {
+            for (std::size_t i {0}; i != bytes; ++i) {
+                buf_[pos_ + i] = GetByte(acc_, i * CHAR_BIT);
+            }
+        }
+
+        return buf_.first(std::min(pos_ + bytes, buf_.size()));
+    }
+
+    //! Flush and take the growable buffer, leaving the writer empty.
+    std::vector<std::uint8_t> Release() {
+        assert(growable_);
+        const auto bytes {Flush().size()};
+        storage_.resize(bytes);
+        buf_ = {};
+        pos_ = 0;
+        acc_ = 0;
+        used_ = 0;
+        return std::exchange(storage_, {});
+    }
+
+private:
+    static constexpr std::size_t word_width {sizeof(std::uint64_t) * CHAR_BIT};
+
+    //! Make room for `size` bytes after the written ones.
+    bool Reserve(const std::size_t size) {
+        if (pos_ + size <= buf_.size()) {
+            return true;
+        } else if (!growable_) {
+            good_ = false;
+            return false;
+        }
+
+        storage_.resize(std::max({pos_ + size, 2 * storage_.size(), std::size_t {64}}));
+        buf_ = storage_;
+        return true;
+    }
+
+    void FlushWord(const std::uint64_t word) {
+        if (Reserve(sizeof(word))) {
+            StoreLE(buf_.data() + pos_, word);
+            pos_ += sizeof(word);
+        }
+    }
+
+    std::vector<std::uint8_t> storage_;
+    std::span<std::uint8_t> buf_;
+    std::size_t pos_ {0};
+    std::uint64_t acc_ {0};
+    std::size_t used_ {0};
+    bool growable_ {true};
+    bool good_ {true};
+};
+
+//! A reader that consumes bit fields from a buffer.
+class BitReader {
+public:
+    explicit BitReader(const std::span<const std::uint8_t> buf) noexcept : buf_ {buf} {
+        Refill();
+    }
+
+    /**
+     * @brief Consume `count` bits.
+     *
+     * @param count The number of bits, from 1 to 64.
+     * @return
+     * The bits as the low bits of a quad word.
+     * Bits beyond the buffer read as cleared and make the reader no longer good.
+     */
+    std::uint64_t Read(const std::size_t count) noexcept {
+        assert(count > 0 && count <= word_width);
+        if (count > refill_width) {
+            const auto low {Read(count / 2)};
+            return low | (Read(count - count / 2) << (count / 2));
+        }
+
+        const auto val {GetBits(acc_, 0, count)};
+        Consume(count);
+        return val;
+    }
+
+    //! Consume a single bit.
+    bool ReadBit() noexcept {
+        return Read(1) != 0;
+    }
+
+    //! Get up to 56 bits without consuming them.
+    std::uint64_t Peek(const std::size_t count) const noexcept {
+        assert(count > 0 && count <= refill_width);
+        return GetBits(acc_, 0, count);
+    }
+
+    //! Skip `count` bits.
+    void Skip(std::size_t count) noexcept {
+        if (count == 0) {
+            return;
+        }
+
+        for (; count > refill_width; count -= refill_width) {
+            Consume(refill_width);
+        }
+
+        Consume(count);
+    }
+
+    //! Skip bits up to the next byte boundary.
+    void AlignToByte() noexcept {
+        if (const auto rest {position() % CHAR_BIT}; rest != 0) {
+            Skip(CHAR_BIT - rest);
+        }
+    }
+
+    //! The number of bits consumed.
+    std::size_t position() const noexcept {
+        return consumed_;
+    }
+
+    //! The number of bits left in the buffer.
+    std::size_t remaining() const noexcept {
+        return good() ? buf_.size() * CHAR_BIT - consumed_ : 0;
+    }
+
+    //! Whether no bits beyond the buffer have been consumed.
+    bool good() const noexcept {
+        return consumed_ <= buf_.size() * CHAR_BIT;
+    }
+
+private:
+    static constexpr std::size_t word_width {sizeof(std::uint64_t) * CHAR_BIT};
+
+    //! The number of bits that are always available after a refill.
+    static constexpr std::size_t refill_width {word_width - CHAR_BIT};
+
+    void Consume(const std::size_t count) noexcept {
+        assert(count > 0);
+        acc_ = (acc_ >> 1) >> (count - 1);
+        avail_ -= count;
+        consumed_ += count;
+        Refill();
+    }
+
+    /**
+     * @brief Top up the accumulator to at least 56 bits.
+     *
+     * @details
+     * It loads the eight bytes after the buffered bits and merges as many whole bytes as fit.
+     * Only the last eight bytes of the buffer take a zero-padded copy.
+     */
+    void Refill() noexcept {
+        acc_ |= LoadAt(next_) << avail_;
+        const auto bytes {(word_width - 1 - avail_) / CHAR_BIT};
+        next_ += bytes;
+        avail_ += bytes * CHAR_BIT;
+    }
+
+    std::uint64_t LoadAt(const std::size_t pos) const noexcept {
+        if (pos + sizeof(std::uint64_t) <= buf_.size()) [[likely]] {
+            return LoadLE<std::uint64_t>(buf_.data() + pos);
+        }
+
+        std::uint8_t tail[sizeof(std::uint64_t)] {};
+        if (pos < buf_.size()) {
+            std::copy(buf_.begin() + pos, buf_.end(), tail);
+        }
+
+        return LoadLE<std::uint64_t>(tail);
+    }
+
+    std::span<const std::uint8_t> buf_;
+    std::size_t next_ {0};
+    std::uint64_t acc_ {0};
+    std::size_t avail_ {0};
+    std::size_t consumed_ {0};
+};
+
+}  // namespace bit
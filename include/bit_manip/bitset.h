@@ -0,0 +1,374 @@
+/**
+ * @file bitset.h
+ * @brief A bitset whose size is chosen at runtime.
+ *
+ * @details
+ * Bits are stored in quad words, least significant bit first, following `IsBitSet`.
+ * The storage is aligned and padded to whole cache lines,
+ * so set algebra runs on full vector registers without a scalar tail.
+ * Bits beyond the size are always cleared.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "aligned_allocator.h"
+#include "bit_manip.h"
+#include "bulk.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bit {
+
+namespace detail {
+
+//! Intersect quad words or vector registers.
+struct AndWords {
+    static constexpr WordOp op {WordOp::and_words};
+
+    constexpr std::uint64_t operator()(const std::uint64_t lhs,
+                                       const std::uint64_t rhs) const noexcept {
+        return lhs & rhs;
+    }
+
+#if defined(BIT_MANIP_SIMD)
+    Simd::Reg operator()(const Simd::Reg lhs, const Simd::Reg rhs) const noexcept {
+        return Simd::And(lhs, rhs);
+    }
+#endif
+};
+
+//! Unite quad words or vector registers.
+struct OrWords {
+    static constexpr WordOp op {WordOp::or_words};
+
+    constexpr std::uint64_t operator()(const std::uint64_t lhs,
+                                       const std::uint64_t rhs) const noexcept {
+        return lhs | rhs;
+    }
+
+#if defined(BIT_MANIP_SIMD)
+    Simd::Reg operator()(const Simd::Reg lhs, const Simd::Reg rhs) const noexcept {
+        return Simd::Or(lhs, rhs);
+    }
+#endif
+};
+
+//! Compute the symmetric difference of quad words or vector registers.
+struct XorWords {
+    static constexpr WordOp op {WordOp::xor_words};
+
+    constexpr std::uint64_t operator()(const std::uint64_t lhs,
+                                       const std::uint64_t rhs) const noexcept {
+        return lhs ^ rhs;
+    }
+
+#if defined(BIT_MANIP_SIMD)
+    Simd::Reg operator()(const Simd::Reg lhs, const Simd::Reg rhs) const noexcept {
+        return Simd::Xor(lhs, rhs);
+    }
+#endif
+};
+
+//! Compute `lhs & ~rhs` on quad words or vector registers.
+struct AndNotWords {
+    static constexpr WordOp op {WordOp::and_not_words};
+
+    constexpr std::uint64_t operator()(const std::uint64_t lhs,
+                                       const std::uint64_t rhs) const noexcept {
+        return lhs & ~rhs;
+    }
+
+#if defined(BIT_MANIP_SIMD)
+    Simd::Reg operator()(const Simd::Reg lhs, const Simd::Reg rhs) const noexcept {
+        return Simd::AndNot(rhs, lhs);
+    }
+#endif
+};
+
+}  // namespace detail
+
+//! A sequence of bits with a runtime size.
+class Bitset {
+public:
+    using Word = std::uint64_t;
+    using size_type = std::size_t;
+
+    //! The number of bits in a storage word.
+    static constexpr std::size_t word_width {sizeof(Word) * CHAR_BIT};
+
+    //! The index returned when no bit is found.
+    static constexpr size_type npos {static_cast<size_type>(-1)};
+
+    Bitset() noexcept = default;
+
+    //! Create a bitset of `size` bits, all set to `val`.
+    explicit Bitset(const size_type size, const bool val = false) :
+        words_(WordCount(size)), size_ {size} {
+        if (val) {
+            Fill(0, size);
+        }
+    }
+
+    constexpr size_type size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    //! Resize the bitset. New bits are cleared.
+    void resize(const size_type size) {
+        words_.resize(WordCount(size));
+        size_ = size;
+        ClearTail();
+    }
+
+    //! The storage words. Their count is a multiple of a cache line.
+    std::span<const Word> words() const noexcept {
+        return words_;
+    }
+
+    //! The mutable storage words. Bits beyond the size must stay cleared.
+    std::span<Word> words() noexcept {
+        return words_;
+    }
+
+    //! Check if a bit is set.
+    bool IsSet(const size_type idx) const noexcept {
+        assert(idx < size_);
+        return IsBitSet(words_[idx / word_width], idx % word_width);
+    }
+
+    //! Set a bit.
+    void Set(const size_type idx) noexcept {
+        assert(idx < size_);
+        SetBit(words_[idx / word_width], idx % word_width);
+    }
+
+    //! Clear a bit.
+    void Clear(const size_type idx) noexcept {
+        assert(idx < size_);
+        ClearBit(words_[idx / word_width], idx % word_width);
+    }
+
+    //! Flip a bit.
+    void Flip(const size_type idx) noexcept {
+        assert(idx < size_);
+        words_[idx / word_width] ^= static_cast<Word>(1) << (idx % word_width);
+    }
+
+    //! Fill `count` bits starting at `begin`.
+    void Fill(const size_type begin, const size_type count) noexcept {
+        UpdateRange(begin, count, static_cast<Word>(-1),
+                    [](Word& word, const std::size_t first, const std::size_t num) noexcept {
+                        FillBits(word, first, num);
+                    });
+    }
+
+    //! Clear `count` bits starting at `begin`.
+    void Clear(const size_type begin, const size_type count) noexcept {
+        UpdateRange(begin, count, 0,
+                    [](Word& word, const std::size_t first, const std::size_t num) noexcept {
+                        ClearBits(word, first, num);
+                    });
+    }
+
+    //! Set all bits.
+    void Fill() noexcept {
+        Fill(0, size_);
+    }
+
+    //! Clear all bits.
+    void Clear() noexcept {
+        std::ranges::fill(words_, 0);
+    }
+
+    //! Flip all bits.
+    void Flip() noexcept {
+        for (auto& word : words_) {
+            word = ~word;
+        }
+
+        ClearTail();
+    }
+
+    //! Count the set bits.
+    size_type Count() const noexcept {
+        return detail::PopcountWords(words_.data(), words_.size());
+    }
+
+    //! Check if any bit is set.
+    bool Any() const noexcept {
+        return std::ranges::any_of(words_, [](const auto word) noexcept { return word != 0; });
+    }
+
+    //! Check if no bit is set.
+    bool None() const noexcept {
+        return !Any();
+    }
+
+    //! Check if all bits are set.
+    bool All() const noexcept {
+        return Count() == size_;
+    }
+
+    //! Find the first set bit, or `npos` if there is none.
+    size_type FindFirst() const noexcept {
+        return !empty() ? FindFrom(0) : npos;
+    }
+
+    //! Find the first set bit after `idx`, or `npos` if there is none.
+    size_type FindNext(const size_type idx) const noexcept {
+        return idx < size_ && idx + 1 < size_ ? FindFrom(idx + 1) : npos;
+    }
+
+    //! Intersect with another bitset of the same size.
+    Bitset& operator&=(const Bitset& other) noexcept {
+        assert(size_ == other.size_);
+        Apply(words_, other.words_, detail::AndWords {});
+        return *this;
+    }
+
+    //! Unite with another bitset of the same size.
+    Bitset& operator|=(const Bitset& other) noexcept {
+        assert(size_ == other.size_);
+        Apply(words_, other.words_, detail::OrWords {});
+        return *this;
+    }
+
+    //! Compute the symmetric difference with another bitset of the same size.
+    Bitset& operator^=(const Bitset& other) noexcept {
+        assert(size_ == other.size_);
+        Apply(words_, other.words_, detail::XorWords {});
+        return *this;
+    }
+
+    //! Clear the bits that are set in another bitset of the same size.
+    Bitset& AndNot(const Bitset& other) noexcept {
+        assert(size_ == other.size_);
+        Apply(words_, other.words_, detail::AndNotWords {});
+        return *this;
+    }
+
+    friend Bitset operator&(Bitset lhs, const Bitset& rhs) {
+        lhs &= rhs;
+        return lhs;
+    }
+
+    friend Bitset operator|(Bitset lhs, const Bitset& rhs) {
+        lhs |= rhs;
+        return lhs;
+    }
+
+    friend Bitset operator^(Bitset lhs, const Bitset& rhs) {
+        lhs ^= rhs;
+        return lhs;
+    }
+
+    friend bool operator==(const Bitset& lhs, const Bitset& rhs) noexcept {
+        return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
+    }
+
+private:
+    using Storage = std::vector<Word, AlignedAllocator<Word>>;
+
+    static constexpr std::size_t line_words {cache_line_size / sizeof(Word)};
+
+    //! The number of storage words for `size` bits, rounded up to whole cache lines.
+    static constexpr size_type WordCount(const size_type size) noexcept {
+        const auto words {(size + word_width - 1) / word_width};
+        return (words + line_words - 1) / line_words * line_words;
+    }
+
+    /**
+     * @brief Apply a word operation to all storage words.
+     *
+     * @details
+     * The vector unit processes whole registers, which always divide the padded storage.
+     */
+    template <typename Op>
+    static void Apply(Storage& lhs, const Storage& rhs, Op op) noexcept {
+        std::size_t i {0};
+#if defined(BIT_MANIP_DISPATCH) && !defined(BIT_MANIP_SIMD_AVX512)
+        if (const auto kernel {detail::GetWordsKernel(Op::op)}; kernel != nullptr) {
+            i = kernel(lhs.data(), rhs.data(), lhs.size());
+        }
+#endif
+#if defined(BIT_MANIP_SIMD)
+        using detail::Simd;
+        static_assert(cache_line_size % Simd::size == 0);
+        constexpr std::size_t lanes {Simd::size / sizeof(Word)};
+        for (; i != lhs.size(); i += lanes) {
+            const auto vals {Simd::Load(lhs.data() + i)};
+            const auto others {Simd::Load(rhs.data() + i)};
+            Simd::Store(lhs.data() + i, op(vals, others));
+        }
+#endif
+        for (; i != lhs.size(); ++i) {
+            lhs[i] = op(lhs[i], rhs[i]);
+        }
+    }
+
+    //! Update a bit range, using `edge` on partial edge words and `fill` for whole words.
+    template <typename Edge>
+    void UpdateRange(const size_type begin, const size_type count, const Word fill,
+                     Edge edge) noexcept {
+        assert(begin <= size_ && count <= size_ - begin);
+        if (count == 0) {
+            return;
+        }
+
+        const auto end {begin + count};
+        const auto first {begin / word_width};
+        const auto last {(end - 1) / word_width};
+        if (first == last) {
+            edge(words_[first], begin % word_width, count);
+            return;
+        }
+
+        edge(words_[first], begin % word_width, word_width - begin % word_width);
+        std::fill(words_.begin() + first + 1, words_.begin() + last, fill);
+        edge(words_[last], 0, end - last * word_width);
+    }
+
+    //! Find the first set bit at or after `idx`.
+    size_type FindFrom(const size_type idx) const noexcept {
+        auto word_idx {idx / word_width};
+        auto word {words_[word_idx] & (static_cast<Word>(-1) << (idx % word_width))};
+        while (word == 0) {
+            if (++word_idx == words_.size()) {
+                return npos;
+            }
+
+            word = words_[word_idx];
+        }
+
+        return word_idx * word_width + static_cast<size_type>(std::countr_zero(word));
+    }
+
+    //! Clear the bits beyond the size.
+    void ClearTail() noexcept {
+        const auto used {(size_ + word_width - 1) / word_width};
+        if (size_ % word_width != 0) {
+            ClearBits(words_[used - 1], size_ % word_width, word_width - size_ % word_width);
+        }
+
+        std::fill(words_.begin() + used, words_.end(), 0);
+    }
+
+    Storage words_;
+    size_type size_ {0};
+};
+
+}  // namespace bit
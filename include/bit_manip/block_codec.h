@@ -0,0 +1,242 @@
+/**
+ * @file block_codec.h
+ * @brief Frame-of-reference, delta and delta-of-delta coding of 32-bit unsigned integers.
+ *
+ * @details
+ * Values are coded in blocks of 128, each transformed into small integers and bit-packed
+ * at the smallest width that holds them (`block_pack.h`).
+ *
+ * - Frame of reference stores each value minus the block minimum.
+ * - Delta stores the difference from the previous value.
+ * - Delta of delta stores the zigzag-coded change between consecutive differences,
+ *   which is zero for evenly spaced values such as timestamps.
+ *
+ * Each block starts with a header double word holding the bit width, the codec and
+ * the number of values, followed by the base value and, for delta of delta, the first difference.
+ * Arithmetic wraps around, so any values round-trip, but only nearby or sorted values pack well.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "block_pack.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#if defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+namespace bit {
+
+//! Block codecs for 32-bit unsigned integers.
+enum class Codec : std::uint8_t { frame_of_reference, delta, delta_of_delta };
+
+//! The number of values in a coded block.
+inline constexpr std::size_t codec_block_size {128};
+
+//! The largest number of double words that coding `count` values can take.
+constexpr std::size_t MaxEncodedSize(const std::size_t count) noexcept {
+    constexpr std::size_t max_header {3};
+    const auto blocks {(count + codec_block_size - 1) / codec_block_size};
+    return blocks * (max_header + PackedSize(codec_block_size, sizeof(std::uint32_t) * CHAR_BIT));
+}
+
+namespace detail {
+
+constexpr std::uint32_t ZigzagEncode(const std::uint32_t val) noexcept {
+    return (val << 1) ^ static_cast<std::uint32_t>(-static_cast<std::int32_t>(val >> 31));
+}
+
+constexpr std::uint32_t ZigzagDecode(const std::uint32_t val) noexcept {
+    return (val >> 1) ^ static_cast<std::uint32_t>(-static_cast<std::int32_t>(val & 1));
+}
+
+/**
+ * @brief Replace a block of values with their inclusive prefix sums, starting from `initial`.
+ *
+ * @details
+ * With SSE2, each register adds its lanes shifted by one and two lanes,
+ * then adds the last sum of the previous register.
+ */
+inline void PrefixSum(const std::span<std::uint32_t, codec_block_size> vals,
+                      std::uint32_t initial) noexcept {
+#if defined(__SSE2__)
+    static_assert(codec_block_size % 4 == 0);
+    auto carry {_mm_set1_epi32(static_cast<int>(initial))};
+    for (std::size_t i {0}; i != vals.size(); i += 4) {
+        auto val {_mm_loadu_si128(reinterpret_cast<const __m128i*>(vals.data() + i))};
+        val = _mm_add_epi32(val, _mm_slli_si128(val, 4));
+        val = _mm_add_epi32(val, _mm_slli_si128(val, 8));
+        val = _mm_add_epi32(val, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(vals.data() + i), val);
+        carry = _mm_shuffle_epi32(val, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+#else
+    for (auto& val : vals) {
+        initial += val;
+        val = initial;
+    }
+#endif
+}
+
+//! The number of double words before the packed values of a block.
+constexpr std::size_t HeaderSize(const Codec codec) noexcept {
+    return codec == Codec::delta_of_delta ? 3 : 2;
+}
+
+//! Pack the header fields of a block into a double word.
+constexpr std::uint32_t MakeBlockMeta(const std::size_t width, const Codec codec,
+                                      const std::size_t count) noexcept {
+    return CombineWords(static_cast<std::uint16_t>(count),
+                        CombineBytes(static_cast<std::uint8_t>(codec),
+                                     static_cast<std::uint8_t>(width)));
+}
+
+/**
+ * @brief Encode up to one block of values.
+ *
+ * @return The number of written double words.
+ */
+inline std::size_t EncodeBlock(const Codec codec, const std::span<const std::uint32_t> vals,
+                               const std::span<std::uint32_t> out) noexcept {
+    assert(!vals.empty() && vals.size() <= codec_block_size);
+    // Missing values of a partial block are coded as zeros.
+    std::array<std::uint32_t, codec_block_size> codes {};
+    const auto base {codec == Codec::frame_of_reference ? std::ranges::min(vals) : vals[0]};
+    std::uint32_t first_delta {0};
+    switch (codec) {
+        case Codec::frame_of_reference: {
+            std::ranges::transform(vals, codes.begin(),
+                                   [base](const auto val) noexcept { return val - base; });
+            break;
+        }
+        case Codec::delta: {
+            for (std::size_t i {1}; i < vals.size(); ++i) {
+                codes[i] = vals[i] - vals[i - 1];
+            }
+
+            break;
+        }
+        case Codec::delta_of_delta: {
+            if (vals.size() > 1) {
+                first_delta = vals[1] - vals[0];
+            }
+
+            for (std::size_t i {2}; i < vals.size(); ++i) {
+                const auto delta {vals[i] - vals[i - 1]};
+                codes[i] = ZigzagEncode(delta - (vals[i - 1] - vals[i - 2]));
+            }
+
+            break;
+        }
+    }
+
+    const auto width {MaxBitWidth(codes)};
+    const auto header {HeaderSize(codec)};
+    assert(out.size() >= header + PackedSize(codec_block_size, width));
+    out[0] = MakeBlockMeta(width, codec, vals.size());
+    out[1] = base;
+    if (codec == Codec::delta_of_delta) {
+        out[2] = first_delta;
+    }
+
+    Pack<codec_block_size>(codes, width, out.subspan(header));
+    return header + PackedSize(codec_block_size, width);
+}
+
+/**
+ * @brief Decode one block into a full block of values.
+ *
+ * @return The number of read double words.
+ */
+inline std::size_t DecodeBlock(const std::span<const std::uint32_t> encoded,
+                               const std::span<std::uint32_t, codec_block_size> out) noexcept {
+    const auto meta {encoded[0]};
+    const std::size_t width {GetByte(meta, 0)};
+    const auto codec {static_cast<Codec>(GetByte(meta, 8))};
+    const auto base {encoded[1]};
+    const auto header {HeaderSize(codec)};
+    Unpack<codec_block_size>(encoded.subspan(header), width, out);
+    switch (codec) {
+        case Codec::frame_of_reference: {
+            for (auto& val : out) {
+                val += base;
+            }
+
+            break;
+        }
+        case Codec::delta: {
+            PrefixSum(out, base);
+            break;
+        }
+        case Codec::delta_of_delta: {
+            for (auto& val : out) {
+                val = ZigzagDecode(val);
+            }
+
+            out[1] = encoded[2];
+            PrefixSum(out, 0);
+            PrefixSum(out, base);
+            break;
+        }
+    }
+
+    return header + PackedSize(codec_block_size, width);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Encode values in blocks with a codec.
+ *
+ * @param out A span of at least `MaxEncodedSize(vals.size())` double words.
+ * @return The number of written double words.
+ */
+inline std::size_t Encode(const Codec codec, const std::span<const std::uint32_t> vals,
+                          const std::span<std::uint32_t> out) noexcept {
+    std::size_t size {0};
+    for (std::size_t i {0}; i < vals.size(); i += codec_block_size) {
+        const auto count {std::min(codec_block_size, vals.size() - i)};
+        size += detail::EncodeBlock(codec, vals.subspan(i, count), out.subspan(size));
+    }
+
+    return size;
+}
+
+/**
+ * @brief Decode values encoded by `Encode`.
+ *
+ * @param out A span with as many values as were encoded.
+ * @return The number of read double words.
+ */
+inline std::size_t Decode(const std::span<const std::uint32_t> encoded,
+                          const std::span<std::uint32_t> out) noexcept {
+    std::size_t size {0};
+    std::size_t i {0};
+    for (; i + codec_block_size <= out.size(); i += codec_block_size) {
+        assert(GetWord(encoded[size], 16) == codec_block_size);
+        size += detail::DecodeBlock(encoded.subspan(size),
+                                    out.subspan(i).first<codec_block_size>());
+    }
+
+    if (i != out.size()) {
+        assert(GetWord(encoded[size], 16) == out.size() - i);
+        std::array<std::uint32_t, codec_block_size> last;
+        size += detail::DecodeBlock(encoded.subspan(size), last);
+        std::copy_n(last.begin(), out.size() - i, out.begin() + i);
+    }
+
+    return size;
+}
+
+}  // namespace bit
@@ -0,0 +1,460 @@
+/**
+ * @file block_pack.h
+ * @brief Bit packing of 32-bit unsigned integer blocks at a fixed width.
+ *
+ * @details
+ * A block of 128 or 256 values is packed in the vertical layout of *SIMD-BP128*:
+ * value `i` belongs to lane `i % lanes`, where `lanes` is the block size divided by 32,
+ * and each lane packs its 32 values least significant bit first into `width` double words.
+ * Double word `k` of lane `l` is stored at `k * lanes + l`,
+ * so a vector register of `lanes` double words packs or unpacks a whole row at once.
+ *
+ * There is one kernel per width from 0 to 32, unrolled at compile time with constant shifts.
+ * Blocks of 128 values run on SSE2 or NEON.
+ * Blocks of 256 values run on AVX2, or on pairs of SSE2 registers when AVX2 is not enabled.
+ * Other targets use a portable version of the same kernels.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bulk.h"
+#include "dispatch.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace bit {
+
+//! The number of double words that `count` values take when packed at `width` bits.
+constexpr std::size_t PackedSize(const std::size_t count, const std::size_t width) noexcept {
+    constexpr std::size_t word_width {sizeof(std::uint32_t) * CHAR_BIT};
+    return (count * width + word_width - 1) / word_width;
+}
+
+//! Get the smallest width that holds every value in a span.
+constexpr std::size_t MaxBitWidth(const std::span<const std::uint32_t> vals) noexcept {
+    std::uint32_t bits {0};
+    for (const auto val : vals) {
+        bits |= val;
+    }
+
+    return static_cast<std::size_t>(std::bit_width(bits));
+}
+
+namespace detail {
+
+//! Rows of double word lanes in plain arrays, for targets without a matching vector unit.
+template <std::size_t Lanes>
+struct PackRows {
+    using Reg = std::array<std::uint32_t, Lanes>;
+
+    static constexpr std::size_t lanes {Lanes};
+
+    static Reg Load(const std::uint32_t* const src) noexcept {
+        Reg val;
+        std::copy_n(src, Lanes, val.begin());
+        return val;
+    }
+
+    static void Store(std::uint32_t* const dest, const Reg& val) noexcept {
+        std::ranges::copy(val, dest);
+    }
+
+    static Reg Broadcast(const std::uint32_t val) noexcept {
+        Reg result;
+        result.fill(val);
+        return result;
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftLeft(Reg val) noexcept {
+        for (auto& lane : val) {
+            lane <<= Count;
+        }
+
+        return val;
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftRight(Reg val) noexcept {
+        for (auto& lane : val) {
+            lane >>= Count;
+        }
+
+        return val;
+    }
+
+    static Reg And(Reg lhs, const Reg& rhs) noexcept {
+        for (std::size_t i {0}; i != Lanes; ++i) {
+            lhs[i] &= rhs[i];
+        }
+
+        return lhs;
+    }
+
+    static Reg Or(Reg lhs, const Reg& rhs) noexcept {
+        for (std::size_t i {0}; i != Lanes; ++i) {
+            lhs[i] |= rhs[i];
+        }
+
+        return lhs;
+    }
+};
+
+#if defined(__SSE2__)
+
+//! Rows of four double words in SSE2 registers.
+struct Sse2Rows {
+    using Reg = __m128i;
+
+    static constexpr std::size_t lanes {4};
+
+    static Reg Load(const std::uint32_t* const src) noexcept {
+        return _mm_loadu_si128(reinterpret_cast<const Reg*>(src));
+    }
+
+    static void Store(std::uint32_t* const dest, const Reg val) noexcept {
+        _mm_storeu_si128(reinterpret_cast<Reg*>(dest), val);
+    }
+
+    static Reg Broadcast(const std::uint32_t val) noexcept {
+        return _mm_set1_epi32(static_cast<int>(val));
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftLeft(const Reg val) noexcept {
+        return _mm_slli_epi32(val, Count);
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftRight(const Reg val) noexcept {
+        return _mm_srli_epi32(val, Count);
+    }
+
+    static Reg And(const Reg lhs, const Reg rhs) noexcept {
+        return _mm_and_si128(lhs, rhs);
+    }
+
+    static Reg Or(const Reg lhs, const Reg rhs) noexcept {
+        return _mm_or_si128(lhs, rhs);
+    }
+};
+
+using Rows128 = Sse2Rows;
+
+#elif defined(__ARM_NEON)
+
+//! Rows of four double words in NEON registers.
+struct NeonRows {
+    using Reg = uint32x4_t;
+
+    static constexpr std::size_t lanes {4};
+
+    static Reg Load(const std::uint32_t* const src) noexcept {
+        return vld1q_u32(src);
+    }
+
+    static void Store(std::uint32_t* const dest, const Reg val) noexcept {
+        vst1q_u32(dest, val);
+    }
+
+    static Reg Broadcast(const std::uint32_t val) noexcept {
+        return vdupq_n_u32(val);
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftLeft(const Reg val) noexcept {
+        return vshlq_n_u32(val, Count);
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftRight(const Reg val) noexcept {
+        return vshrq_n_u32(val, Count);
+    }
+
+    static Reg And(const Reg lhs, const Reg rhs) noexcept {
+        return vandq_u32(lhs, rhs);
+    }
+
+    static Reg Or(const Reg lhs, const Reg rhs) noexcept {
+        return vorrq_u32(lhs, rhs);
+    }
+};
+
+using Rows128 = NeonRows;
+
+#else
+
+using Rows128 = PackRows<4>;
+
+#endif
+
+#if defined(__AVX2__)
+
+//! Rows of eight double words in AVX2 registers.
+struct Avx2Rows {
+    using Reg = __m256i;
+
+    static constexpr std::size_t lanes {8};
+
+    static Reg Load(const std::uint32_t* const src) noexcept {
+        return _mm256_loadu_si256(reinterpret_cast<const Reg*>(src));
+    }
+
+    static void Store(std::uint32_t* const dest, const Reg val) noexcept {
+        _mm256_storeu_si256(reinterpret_cast<Reg*>(dest), val);
+    }
+
+    static Reg Broadcast(const std::uint32_t val) noexcept {
+        return _mm256_set1_epi32(static_cast<int>(val));
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftLeft(const Reg val) noexcept {
+        return _mm256_slli_epi32(val, Count);
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftRight(const Reg val) noexcept {
+        return _mm256_srli_epi32(val, Count);
+    }
+
+    static Reg And(const Reg lhs, const Reg rhs) noexcept {
+        return _mm256_and_si256(lhs, rhs);
+    }
+
+    static Reg Or(const Reg lhs, const Reg rhs) noexcept {
+        return _mm256_or_si256(lhs, rhs);
+    }
+};
+
+using Rows256 = Avx2Rows;
+
+#elif defined(__SSE2__)
+
+//! Rows of eight double words in pairs of SSE2 registers.
+struct Sse2PairRows {
+    struct Reg {
+        __m128i low;
+        __m128i high;
+    };
+
+    static constexpr std::size_t lanes {8};
+
+    static Reg Load(const std::uint32_t* const src) noexcept {
+        return {Sse2Rows::Load(src), Sse2Rows::Load(src + Sse2Rows::lanes)};
+    }
+
+    static void Store(std::uint32_t* const dest, const Reg val) noexcept {
+        Sse2Rows::Store(dest, val.low);
+        Sse2Rows::Store(dest + Sse2Rows::lanes, val.high);
+    }
+
+    static Reg Broadcast(const std::uint32_t val) noexcept {
+        const auto half {Sse2Rows::Broadcast(val)};
+        return {half, half};
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftLeft(const Reg val) noexcept {
+        return {Sse2Rows::ShiftLeft<Count>(val.low), Sse2Rows::ShiftLeft<Count>(val.high)};
+    }
+
+    template <std::size_t Count>
+    static Reg ShiftRight(const Reg val) noexcept {
+        return {Sse2Rows::ShiftRight<Count>(val.low), Sse2Rows::ShiftRight<Count>(val.high)};
+    }
+
+    static Reg And(const Reg lhs, const Reg rhs) noexcept {
+        return {Sse2Rows::And(lhs.low, rhs.low), Sse2Rows::And(lhs.high, rhs.high)};
+    }
+
+    static Reg Or(const Reg lhs, const Reg rhs) noexcept {
+        return {Sse2Rows::Or(lhs.low, rhs.low), Sse2Rows::Or(lhs.high, rhs.high)};
+    }
+};
+
+using Rows256 = Sse2PairRows;
+
+#else
+
+using Rows256 = PackRows<8>;
+
+#endif
+
+//! Pack or unpack a block of `32 * Rows::lanes` values.
+using BlockKernel = void (*)(const std::uint32_t* in, std::uint32_t* out) noexcept;
+
+//! Pack the `Idx`-th row of a block into the accumulator and store it once full.
+template <std::size_t Width, std::size_t Idx, typename Rows>
+void PackRow(const std::uint32_t* const in, std::uint32_t* const out,
+             const typename Rows::Reg& mask, typename Rows::Reg& acc) noexcept {
+    constexpr std::size_t word_width {sizeof(std::uint32_t) * CHAR_BIT};
+    constexpr std::size_t offset {Idx * Width % word_width};
+    constexpr std::size_t word {Idx * Width / word_width};
+    const auto val {Rows::And(Rows::Load(in + Idx * Rows::lanes), mask)};
+    if constexpr (offset == 0) {
+        acc = val;
+    } else {
+        acc = Rows::Or(acc, Rows::template ShiftLeft<offset>(val));
+    }
+
+    if constexpr (offset + Width >= word_width) {
+        Rows::Store(out + word * Rows::lanes, acc);
+        if constexpr (offset + Width > word_width) {
+            acc = Rows::template ShiftRight<word_width - offset>(val);
+        }
+    }
+}
+
+//! Unpack the `Idx`-th row of a block, loading packed rows as they are reached.
+template <std::size_t Width, std::size_t Idx, typename Rows>
+void UnpackRow(const std::uint32_t* const in, std::uint32_t* const out,
+               const typename Rows::Reg& mask, typename Rows::Reg& packed) noexcept {
+    constexpr std::size_t word_width {sizeof(std::uint32_t) * CHAR_BIT};
+    constexpr std::size_t offset {Idx * Width % word_width};
+    constexpr std::size_t word {Idx * Width / word_width};
+    if constexpr (offset == 0) {
+        packed = Rows::Load(in + word * Rows::lanes);
+    }
+
+    auto val {packed};
+    if constexpr (offset != 0) {
+        val = Rows::template ShiftRight<offset>(packed);
+    }
+
+    if constexpr (offset + Width > word_width) {
+        packed = Rows::Load(in + (word + 1) * Rows::lanes);
+        val = Rows::Or(val, Rows::template ShiftLeft<word_width - offset>(packed));
+    }
+
+    // The last value of a packed row needs no mask.
+    if constexpr (offset + Width != word_width) {
+        val = Rows::And(val, mask);
+    }
+
+    Rows::Store(out + Idx * Rows::lanes, val);
+}
+
+template <std::size_t Width, typename Rows>
+void PackBlock(const std::uint32_t* const in, std::uint32_t* const out) noexcept {
+    constexpr std::size_t word_width {sizeof(std::uint32_t) * CHAR_BIT};
+    if constexpr (Width == word_width) {
+        std::copy_n(in, word_width * Rows::lanes, out);
+    } else if constexpr (Width != 0) {
+        const auto mask {Rows::Broadcast(LowMask<std::uint32_t>(Width))};
+        typename Rows::Reg acc {};
+        [&]<std::size_t... Idx>(std::index_sequence<Idx...>) {
+            (PackRow<Width, Idx, Rows>(in, out, mask, acc), ...);
+        }(std::make_index_sequence<word_width> {});
+    }
+}
+
+template <std::size_t Width, typename Rows>
+void UnpackBlock(const std::uint32_t* const in, std::uint32_t* const out) noexcept {
+    constexpr std::size_t word_width {sizeof(std::uint32_t) * CHAR_BIT};
+    if constexpr (Width == 0) {
+        std::fill_n(out, word_width * Rows::lanes, 0);
+    } else if constexpr (Width == word_width) {
+        std::copy_n(in, word_width * Rows::lanes, out);
+    } else {
+        const auto mask {Rows::Broadcast(LowMask<std::uint32_t>(Width))};
+        typename Rows::Reg packed {};
+        [&]<std::size_t... Idx>(std::index_sequence<Idx...>) {
+            (UnpackRow<Width, Idx, Rows>(in, out, mask, packed), ...);
+        }(std::make_index_sequence<word_width> {});
+    }
+}
+
+//! Pack and unpack kernels indexed by width.
+struct BlockKernels {
+    std::array<BlockKernel, sizeof(std::uint32_t) * CHAR_BIT + 1> pack;
+    std::array<BlockKernel, sizeof(std::uint32_t) * CHAR_BIT + 1> unpack;
+};
+
+template <typename Rows, std::size_t... Width>
+constexpr BlockKernels MakeBlockKernels(std::index_sequence<Width...>) noexcept {
+    return {{&PackBlock<Width, Rows>...}, {&UnpackBlock<Width, Rows>...}};
+}
+
+//! The kernels for blocks of `BlockSize` values.
+template <std::size_t BlockSize>
+inline constexpr BlockKernels block_kernels {
+    MakeBlockKernels<std::conditional_t<BlockSize == 128, Rows128, Rows256>>(
+        std::make_index_sequence<sizeof(std::uint32_t) * CHAR_BIT + 1> {})};
+
+}  // namespace detail
+
+//! Get the instruction set used to pack blocks of `BlockSize` values, for logging.
+template <std::size_t BlockSize = 128>
+constexpr Isa GetBlockPackIsa() noexcept {
+    static_assert(BlockSize == 128 || BlockSize == 256);
+#if defined(__AVX2__)
+    return BlockSize == 128 ? Isa::sse2 : Isa::avx2;
+#elif defined(__SSE2__)
+    return Isa::sse2;
+#elif defined(__ARM_NEON)
+    return BlockSize == 128 ? Isa::neon : Isa::scalar;
+#else
+    return Isa::scalar;
+#endif
+}
+
+/**
+ * @brief Pack blocks of values at a fixed width.
+ *
+ * @param vals Values whose count is a multiple of `BlockSize`. Bits beyond the width are dropped.
+ * @param width The number of bits per value, from 0 to 32.
+ * @param out A span of at least `PackedSize(vals.size(), width)` double words.
+ */
+template <std::size_t BlockSize = 128>
+void Pack(const std::span<const std::uint32_t> vals, const std::size_t width,
+          const std::span<std::uint32_t> out) noexcept {
+    static_assert(BlockSize == 128 || BlockSize == 256);
+    assert(vals.size() % BlockSize == 0 && width <= sizeof(std::uint32_t) * CHAR_BIT);
+    assert(out.size() >= PackedSize(vals.size(), width));
+    const auto kernel {detail::block_kernels<BlockSize>.pack[width]};
+    const auto block_words {PackedSize(BlockSize, width)};
+    for (std::size_t i {0}; i != vals.size() / BlockSize; ++i) {
+        kernel(vals.data() + i * BlockSize, out.data() + i * block_words);
+    }
+}
+
+/**
+ * @brief Unpack blocks of values packed at a fixed width.
+ *
+ * @param packed A span of at least `PackedSize(out.size(), width)` double words.
+ * @param width The number of bits per value, from 0 to 32.
+ * @param out A span whose size is a multiple of `BlockSize`.
+ */
+template <std::size_t BlockSize = 128>
+void Unpack(const std::span<const std::uint32_t> packed, const std::size_t width,
+            const std::span<std::uint32_t> out) noexcept {
+    static_assert(BlockSize == 128 || BlockSize == 256);
+    assert(out.size() % BlockSize == 0 && width <= sizeof(std::uint32_t) * CHAR_BIT);
+    assert(packed.size() >= PackedSize(out.size(), width));
+    const auto kernel {detail::block_kernels<BlockSize>.unpack[width]};
+    const auto block_words {PackedSize(BlockSize, width)};
+    for (std::size_t i {0}; i != out.size() / BlockSize; ++i) {
+        kernel(packed.data() + i * block_words, out.data() + i * BlockSize);
+    }
+}
+
+}  // namespace bit
@@ -0,0 +1,504 @@
+/**
+ * @file bulk.h
+ * @brief Bulk bit manipulation over contiguous arrays.
+ *
+ * @details
+ * Each operation applies the same scalar operation from `bit_manip.h` to every element of a span.
+ * The main loop runs on the widest vector unit enabled at compile time:
+ * AVX-512, AVX2, SSE2 or NEON. Remaining elements and other targets use a scalar fallback.
+ * When the compile-time unit is narrower than AVX-512,
+ * wider kernels chosen at runtime run first (`dispatch.h`).
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "dispatch.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+namespace bit {
+
+namespace detail {
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    #define BIT_MANIP_SIMD_AVX512
+
+BIT_MANIP_AVX512_WARNINGS_BEGIN
+//! AVX-512 registers.
+struct Simd {
+    using Reg = __m512i;
+
+    static constexpr std::size_t size {sizeof(Reg)};
+
+    static Reg Load(const void* const src) noexcept {
+        return _mm512_loadu_si512(src);
+    }
+
+    static void Store(void* const dest, const Reg val) noexcept {
+        _mm512_storeu_si512(dest, val);
+    }
+
+    template <std::unsigned_integral T>
+    static Reg Broadcast(const T val) noexcept {
+        if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+            return _mm512_set1_epi8(static_cast<char>(val));
+        } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+            return _mm512_set1_epi16(static_cast<short>(val));
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm512_set1_epi32(static_cast<int>(val));
+        } else {
+            return _mm512_set1_epi64(static_cast<long long>(val));
+        }
+    }
+
+    //! Shift each lane right. Byte lanes use 16-bit shifts and rely on the caller's mask.
+    template <std::unsigned_integral T>
+    static Reg ShiftRight(const Reg val, const std::size_t count) noexcept {
+        const auto n {_mm_cvtsi32_si128(static_cast<int>(count))};
+        if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+            return _mm512_srl_epi16(val, n);
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm512_srl_epi32(val, n);
+        } else {
+            return _mm512_srl_epi64(val, n);
+        }
+    }
+
+    //! Shift each lane left. Byte lanes use 16-bit shifts and rely on the caller's mask.
+    template <std::unsigned_integral T>
+    static Reg ShiftLeft(const Reg val, const std::size_t count) noexcept {
+        const auto n {_mm_cvtsi32_si128(static_cast<int>(count))};
+        if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+            return _mm512_sll_epi16(val, n);
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm512_sll_epi32(val, n);
+        } else {
+            return _mm512_sll_epi64(val, n);
+        }
+    }
+
+    static Reg And(const Reg lhs, const Reg rhs) noexcept {
+        return _mm512_and_si512(lhs, rhs);
+    }
+
+    //! Compute `~lhs & rhs`.
+    static Reg AndNot(const Reg lhs, const Reg rhs) noexcept {
+        return _mm512_andnot_si512(lhs, rhs);
+    }
+
+    static Reg Or(const Reg lhs, const Reg rhs) noexcept {
+        return _mm512_or_si512(lhs, rhs);
+    }
+
+    static Reg Xor(const Reg lhs, const Reg rhs) noexcept {
+        return _mm512_xor_si512(lhs, rhs);
+    }
+};
+BIT_MANIP_AVX512_WARNINGS_END
+
+#elif defined(__AVX2__) || defined(__SSE2__)
+    #if defined(__AVX2__)
+        #define BIT_MANIP_SIMD_AVX2
+    #else
+        #define BIT_MANIP_SIMD_SSE2
+    #endif
+
+//! AVX2 or SSE2 registers.
+struct Simd {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+    using Reg = __m256i;
+    #else
+    using Reg = __m128i;
+    #endif
+
+    static constexpr std::size_t size {sizeof(Reg)};
+
+    static Reg Load(const void* const src) noexcept {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        return _mm256_loadu_si256(static_cast<const Reg*>(src));
+    #else
+        return _mm_loadu_si128(static_cast<const Reg*>(src));
+    #endif
+    }
+
+    static void Store(void* const dest, const Reg val) noexcept {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        _mm256_storeu_si256(static_cast<Reg*>(dest), val);
+    #else
+        _mm_storeu_si128(static_cast<Reg*>(dest), val);
+    #endif
+    }
+
+    template <std::unsigned_integral T>
+    static Reg Broadcast(const T val) noexcept {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+            return _mm256_set1_epi8(static_cast<char>(val));
+        } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+            return _mm256_set1_epi16(static_cast<short>(val));
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm256_set1_epi32(static_cast<int>(val));
+        } else {
+            return _mm256_set1_epi64x(static_cast<long long>(val));
+        }
+    #else
+        if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+            return _mm_set1_epi8(static_cast<char>(val));
+        } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+            return _mm_set1_epi16(static_cast<short>(val));
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm_set1_epi32(static_cast<int>(val));
+        } else {
+            return _mm_set1_epi64x(static_cast<long long>(val));
+        }
+    #endif
+    }
+
+    //! Shift each lane right. Byte lanes use 16-bit shifts and rely on the caller's mask.
+    template <std::unsigned_integral T>
+    static Reg ShiftRight(const Reg val, const std::size_t count) noexcept {
+        const auto n {_mm_cvtsi32_si128(static_cast<int>(count))};
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+            return _mm256_srl_epi16(val, n);
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm256_srl_epi32(val, n);
+        } else {
+            return _mm256_srl_epi64(val, n);
+        }
+    #else
+        if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+            return _mm_srl_epi16(val, n);
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm_srl_epi32(val, n);
+        } else {
+            return _mm_srl_epi64(val, n);
+        }
+    #endif
+    }
+
+    //! Shift each lane left. Byte lanes use 16-bit shifts and rely on the caller's mask.
+    template <std::unsigned_integral T>
+    static Reg ShiftLeft(const Reg val, const std::size_t count) noexcept {
+        const auto n {_mm_cvtsi32_si128(static_cast<int>(count))};
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+            return _mm256_sll_epi16(val, n);
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm256_sll_epi32(val, n);
+        } else {
+            return _mm256_sll_epi64(val, n);
+        }
+    #else
+        if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+            return _mm_sll_epi16(val, n);
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return _mm_sll_epi32(val, n);
+        } else {
+            return _mm_sll_epi64(val, n);
+        }
+    #endif
+    }
+
+    static Reg And(const Reg lhs, const Reg rhs) noexcept {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        return _mm256_and_si256(lhs, rhs);
+    #else
+        return _mm_and_si128(lhs, rhs);
+    #endif
+    }
+
+    //! Compute `~lhs & rhs`.
+    static Reg AndNot(const Reg lhs, const Reg rhs) noexcept {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        return _mm256_andnot_si256(lhs, rhs);
+    #else
+        return _mm_andnot_si128(lhs, rhs);
+    #endif
+    }
+
+    static Reg Or(const Reg lhs, const Reg rhs) noexcept {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        return _mm256_or_si256(lhs, rhs);
+    #else
+        return _mm_or_si128(lhs, rhs);
+    #endif
+    }
+
+    static Reg Xor(const Reg lhs, const Reg rhs) noexcept {
+    #if defined(BIT_MANIP_SIMD_AVX2)
+        return _mm256_xor_si256(lhs, rhs);
+    #else
+        return _mm_xor_si128(lhs, rhs);
+    #endif
+    }
+};
+
+#elif defined(__ARM_NEON)
+    #define BIT_MANIP_SIMD_NEON
+
+//! NEON registers, viewed as bytes between operations.
+struct Simd {
+    using Reg = uint8x16_t;
+
+    static constexpr std::size_t size {sizeof(Reg)};
+
+    static Reg Load(const void* const src) noexcept {
+        return vld1q_u8(static_cast<const std::uint8_t*>(src));
+    }
+
+    static void Store(void* const dest, const Reg val) noexcept {
+        vst1q_u8(static_cast<std::uint8_t*>(dest), val);
+    }
+
+    template <std::unsigned_integral T>
+    static Reg Broadcast(const T val) noexcept {
+        if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+            return vdupq_n_u8(val);
+        } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+            return vreinterpretq_u8_u16(vdupq_n_u16(val));
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return vreinterpretq_u8_u32(vdupq_n_u32(val));
+        } else {
+            return vreinterpretq_u8_u64(vdupq_n_u64(val));
+        }
+    }
+
+    //! Shift each lane left by a signed count. A negative count shifts right.
+    template <std::unsigned_integral T>
+    static Reg Shift(const Reg val, const int count) noexcept {
+        if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+            return vshlq_u8(val, vdupq_n_s8(static_cast<std::int8_t>(count)));
+        } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+            return vreinterpretq_u8_u16(vshlq_u16(vreinterpretq_u16_u8(val),
+                                                  vdupq_n_s16(static_cast<std::int16_t>(count))));
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            return vreinterpretq_u8_u32(vshlq_u32(vreinterpretq_u32_u8(val),
+                                                  vdupq_n_s32(static_cast<std::int32_t>(count))));
+        } else {
+            return vreinterpretq_u8_u64(vshlq_u64(vreinterpretq_u64_u8(val),
+                                                  vdupq_n_s64(static_cast<std::int64_t>(count))));
+        }
+    }
+
+    template <std::unsigned_integral T>
+    static Reg ShiftRight(const Reg val, const std::size_t count) noexcept {
+        return Shift<T>(val, -static_cast<int>(count));
+    }
+
+    template <std::unsigned_integral T>
+    static Reg ShiftLeft(const Reg val, const std::size_t count) noexcept {
+        return Shift<T>(val, static_cast<int>(count));
+    }
+
+    static Reg And(const Reg lhs, const Reg rhs) noexcept {
+        return vandq_u8(lhs, rhs);
+    }
+
+    //! Compute `~lhs & rhs`.
+    static Reg AndNot(const Reg lhs, const Reg rhs) noexcept {
+        return vbicq_u8(rhs, lhs);
+    }
+
+    static Reg Or(const Reg lhs, const Reg rhs) noexcept {
+        return vorrq_u8(lhs, rhs);
+    }
+
+    static Reg Xor(const Reg lhs, const Reg rhs) noexcept {
+        return veorq_u8(lhs, rhs);
+    }
+};
+
+#endif
+
+#if defined(BIT_MANIP_SIMD_AVX512) || defined(BIT_MANIP_SIMD_AVX2) \
+    || defined(BIT_MANIP_SIMD_SSE2) || defined(BIT_MANIP_SIMD_NEON)
+    #define BIT_MANIP_SIMD
+
+/**
+ * @brief Get the specified bits in whole registers.
+ *
+ * @return The number of processed elements.
+ */
+template <std::unsigned_integral T>
+std::size_t GetBitsSimd(const T* const vals, T* const out, const std::size_t size,
+                        const std::size_t begin, const std::size_t count) noexcept {
+    constexpr std::size_t lanes {Simd::size / sizeof(T)};
+    const auto mask {Simd::Broadcast(LowMask<T>(count))};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {Simd::Load(vals + i)};
+        Simd::Store(out + i, Simd::And(Simd::ShiftRight<T>(val, begin), mask));
+    }
+
+    return i;
+}
+
+/**
+ * @brief Set the value of the specified bits in whole registers.
+ *
+ * @return The number of processed elements.
+ */
+template <std::unsigned_integral T>
+std::size_t SetBitsSimd(T* const vals, const T* const bits, const std::size_t size,
+                        const std::size_t begin, const std::size_t count) noexcept {
+    constexpr std::size_t lanes {Simd::size / sizeof(T)};
+    const auto mask {Simd::Broadcast(static_cast<T>(LowMask<T>(count) << begin))};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {Simd::Load(vals + i)};
+        const auto field {Simd::And(Simd::ShiftLeft<T>(Simd::Load(bits + i), begin), mask)};
+        Simd::Store(vals + i, Simd::Or(Simd::AndNot(mask, val), field));
+    }
+
+    return i;
+}
+
+#endif
+
+/**
+ * @brief Check if a span has enough values to fill a vector register.
+ *
+ * @details
+ * Skipping vector kernels for shorter spans also lets the optimizer see that their loads are dead.
+ */
+template <std::unsigned_integral T>
+constexpr bool FillsRegister([[maybe_unused]] const std::size_t size) noexcept {
+#if defined(BIT_MANIP_SIMD)
+    return size >= Simd::size / sizeof(T);
+#else
+    return true;
+#endif
+}
+
+//! Count the set bits in quad words.
+inline std::size_t PopcountWords(const std::uint64_t* const words,
+                                 const std::size_t size) noexcept {
+#if defined(BIT_MANIP_DISPATCH) && !(defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__))
+    if (const auto kernel {GetKernels().popcount}; kernel != nullptr) {
+        return kernel(words, size);
+    }
+#endif
+    std::size_t i {0};
+    std::uint64_t total {0};
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    BIT_MANIP_AVX512_WARNINGS_BEGIN
+    auto sum {_mm512_setzero_si512()};
+    for (; i + 8 <= size; i += 8) {
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+    }
+
+    total += static_cast<std::uint64_t>(_mm512_reduce_add_epi64(sum));
+    BIT_MANIP_AVX512_WARNINGS_END
+#elif defined(__AVX2__)
+    total += PopcountVectorsAvx2(words, size / 4);
+    i = size / 4 * 4;
+#endif
+    for (; i < size; ++i) {
+        total += static_cast<std::uint64_t>(std::popcount(words[i]));
+    }
+
+    return static_cast<std::size_t>(total);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Count the set bits in a span of quad words.
+ *
+ * @details
+ * It runs VPOPCNTQ on AVX-512 and the Harley-Seal method on AVX2.
+ */
+inline std::size_t PopcountSpan(const std::span<const std::uint64_t> words) noexcept {
+    return detail::PopcountWords(words.data(), words.size());
+}
+
+/**
+ * @brief Get the specified bits in each integral value of a span.
+ *
+ * @details
+ * `out[i]` receives `GetBits(vals[i], begin, count)`.
+ * `out` must be at least as large as `vals` and may alias it exactly.
+ */
+template <std::unsigned_integral T>
+void GetBits(const std::span<const std::type_identity_t<T>> vals, const std::span<T> out,
+             const std::size_t begin, const std::size_t count) noexcept {
+    assert(out.size() >= vals.size());
+    if (count >= sizeof(T) * CHAR_BIT) {
+        std::ranges::copy(vals, out.begin());
+        return;
+    }
+
+    assert(begin < sizeof(T) * CHAR_BIT);
+    // Bits beyond the value are zero, so clamping keeps the vector shifts of narrow lanes exact.
+    [[maybe_unused]] const auto valid {std::min(count, sizeof(T) * CHAR_BIT - begin)};
+    std::size_t i {0};
+    if (detail::FillsRegister<T>(vals.size())) {
+#if defined(BIT_MANIP_DISPATCH) && !defined(BIT_MANIP_SIMD_AVX512)
+        if (const auto kernel {detail::GetBulkKernels<T>().get_bits}; kernel != nullptr) {
+            i = kernel(vals.data(), out.data(), vals.size(), begin, LowMask<T>(valid));
+        }
+#endif
+#if defined(BIT_MANIP_SIMD)
+        i += detail::GetBitsSimd(vals.data() + i, out.data() + i, vals.size() - i, begin, valid);
+#endif
+    }
+
+    std::ranges::transform(vals.subspan(i), out.begin() + i,
+                           [=](const T val) noexcept { return GetBits(val, begin, count); });
+}
+
+/**
+ * @brief Set the value of the specified bits in each integral value of a span.
+ *
+ * @details
+ * `vals[i]` is updated as `SetBits(vals[i], bits[i], begin, count)`.
+ * `bits` must be at least as large as `vals`.
+ */
+template <std::unsigned_integral T>
+void SetBits(const std::span<T> vals, const std::span<const std::type_identity_t<T>> bits,
+             const std::size_t begin, const std::size_t count = sizeof(T) * CHAR_BIT) noexcept {
+    assert(bits.size() >= vals.size());
+    if (count >= sizeof(T) * CHAR_BIT) {
+        std::ranges::copy(bits.first(vals.size()), vals.begin());
+        return;
+    }
+
+    assert(begin < sizeof(T) * CHAR_BIT);
+    std::size_t i {0};
+    if (detail::FillsRegister<T>(vals.size())) {
+#if defined(BIT_MANIP_DISPATCH) && !defined(BIT_MANIP_SIMD_AVX512)
+        if (const auto kernel {detail::GetBulkKernels<T>().set_bits}; kernel != nullptr) {
+            const auto mask {static_cast<T>(LowMask<T>(count) << begin)};
+            i = kernel(vals.data(), bits.data(), vals.size(), begin, mask);
+        }
+#endif
+#if defined(BIT_MANIP_SIMD)
+        i += detail::SetBitsSimd(vals.data() + i, bits.data() + i, vals.size() - i, begin, count);
+#endif
+    }
+
+    for (; i < vals.size(); ++i) {
+        SetBits(vals[i], bits[i], begin, count);
+    }
+}
+
+}  // namespace bit
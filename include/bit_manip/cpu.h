@@ -0,0 +1,142 @@
+/**
+ * @file cpu.h
+ * @brief Detection of CPU features used by bit kernels.
+ *
+ * @details
+ * Features are detected once with `cpuid` and cached.
+ * Vector features also require the operating system to save their registers.
+ * All features are reported as missing on other architectures.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    #define BIT_MANIP_X86
+
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace bit {
+
+//! CPU features used by bit kernels.
+struct CpuFeatures {
+    bool ssse3 {false};
+    bool popcnt {false};
+    bool lzcnt {false};
+    bool bmi1 {false};
+    bool bmi2 {false};
+    bool avx2 {false};
+    bool gfni {false};
+    bool avx512f {false};
+    bool avx512bw {false};
+    bool avx512vpopcntdq {false};
+
+    //! Whether `pdep` and `pext` run in a few cycles rather than in microcode.
+    bool fast_pdep {false};
+};
+
+namespace detail {
+
+#if defined(BIT_MANIP_X86)
+
+struct CpuidRegs {
+    std::uint32_t eax {0};
+    std::uint32_t ebx {0};
+    std::uint32_t ecx {0};
+    std::uint32_t edx {0};
+};
+
+inline CpuidRegs Cpuid(const std::uint32_t leaf, const std::uint32_t sub_leaf = 0) noexcept {
+    CpuidRegs regs;
+    #if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] {};
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(sub_leaf));
+    regs = {static_cast<std::uint32_t>(info[0]), static_cast<std::uint32_t>(info[1]),
+            static_cast<std::uint32_t>(info[2]), static_cast<std::uint32_t>(info[3])};
+    #else
+    __cpuid_count(leaf, sub_leaf, regs.eax, regs.ebx, regs.ecx, regs.edx);
+    #endif
+    return regs;
+}
+
+//! Read the extended control register that lists the register states saved by the OS.
+inline std::uint64_t ReadXcr0() noexcept {
+    #if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+    #else
+    std::uint32_t eax {0};
+    std::uint32_t edx {0};
+    __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<std::uint64_t>(edx) << 32) | eax;
+    #endif
+}
+
+inline CpuFeatures DetectCpuFeatures() noexcept {
+    CpuFeatures features;
+    const auto max_leaf {Cpuid(0).eax};
+    if (max_leaf < 1) {
+        return features;
+    }
+
+    const auto vendor {Cpuid(0)};
+    // "AuthenticAMD" is split across EBX, EDX and ECX.
+    const bool amd {vendor.ebx == 0x68747541 && vendor.edx == 0x69746E65
+                    && vendor.ecx == 0x444D4163};
+
+    const auto basic {Cpuid(1)};
+    features.ssse3 = basic.ecx & (1U << 9);
+    features.popcnt = basic.ecx & (1U << 23);
+    const bool os_saves_ymm {(basic.ecx & (1U << 27)) && (ReadXcr0() & 0x06) == 0x06};
+    const bool os_saves_zmm {os_saves_ymm && (ReadXcr0() & 0xE0) == 0xE0};
+
+    if (max_leaf >= 7) {
+        const auto extended {Cpuid(7)};
+        features.bmi1 = extended.ebx & (1U << 3);
+        features.avx2 = os_saves_ymm && (extended.ebx & (1U << 5));
+        features.bmi2 = extended.ebx & (1U << 8);
+        features.gfni = extended.ecx & (1U << 8);
+        features.avx512f = os_saves_zmm && (extended.ebx & (1U << 16));
+        features.avx512bw = os_saves_zmm && (extended.ebx & (1U << 30));
+        features.avx512vpopcntdq = os_saves_zmm && (extended.ecx & (1U << 14));
+    }
+
+    if (Cpuid(0x80000000).eax >= 0x80000001) {
+        features.lzcnt = Cpuid(0x80000001).ecx & (1U << 5);
+    }
+
+    // AMD processors before Zen 3 (family 19h) implement `pdep` and `pext` in microcode.
+    auto family {(basic.eax >> 8) & 0x0F};
+    if (family == 0x0F) {
+        family += (basic.eax >> 20) & 0xFF;
+    }
+
+    features.fast_pdep = features.bmi2 && !(amd && family < 0x19);
+    return features;
+}
+
+#else
+
+inline CpuFeatures DetectCpuFeatures() noexcept {
+    return {};
+}
+
+#endif
+
+}  // namespace detail
+
+//! Get the features of the current CPU.
+inline const CpuFeatures& GetCpuFeatures() noexcept {
+    static const CpuFeatures features {detail::DetectCpuFeatures()};
+    return features;
+}
+
+}  // namespace bit
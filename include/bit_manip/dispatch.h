@@ -0,0 +1,605 @@
+/**
+ * @file dispatch.h
+ * @brief Runtime selection of vector kernels for bulk operations.
+ *
+ * @details
+ * A binary built for a baseline target can still run wider kernels on CPUs that support them.
+ * On x86-64 with GCC or Clang, kernels for AVX2 and AVX-512 are compiled with target attributes
+ * and chosen once from `GetCpuFeatures`.
+ * Bulk operations run the chosen kernel first and finish with the compile-time vector unit
+ * and scalar code, so a missing kernel only means a narrower path.
+ * Defining `BIT_MANIP_NO_DISPATCH` disables the selection.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "cpu.h"
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__)) \
+    && !defined(BIT_MANIP_NO_DISPATCH)
+    #define BIT_MANIP_DISPATCH
+    #include <immintrin.h>
+
+    #define BIT_MANIP_TARGET_SSSE3 __attribute__((target("ssse3")))
+    #define BIT_MANIP_TARGET_POPCNT __attribute__((target("popcnt")))
+    #define BIT_MANIP_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+    #define BIT_MANIP_TARGET_GFNI __attribute__((target("avx2,gfni")))
+    #define BIT_MANIP_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,popcnt")))
+    #define BIT_MANIP_TARGET_AVX512_POPCNT \
+        __attribute__((target("avx512f,avx512vpopcntdq,popcnt")))
+#endif
+
+// Byte shuffles are either built in or compiled with a target attribute and chosen at runtime.
+#if defined(__SSSE3__) || defined(BIT_MANIP_DISPATCH)
+    #define BIT_MANIP_SSSE3
+    #include <immintrin.h>
+
+    #if !defined(BIT_MANIP_TARGET_SSSE3)
+        #define BIT_MANIP_TARGET_SSSE3
+    #endif
+#endif
+
+// AVX2 population counts are shared by the runtime kernel and the compile-time path.
+#if defined(__AVX2__) || defined(BIT_MANIP_DISPATCH)
+    #define BIT_MANIP_AVX2
+    #include <immintrin.h>
+
+    #if !defined(BIT_MANIP_TARGET_AVX2)
+        #define BIT_MANIP_TARGET_AVX2
+    #endif
+#endif
+
+/*
+ * GCC 12 reports the operands of AVX-512 intrinsics as uninitialized where they are inlined
+ * (GCC bug 105593). AVX-512 code is enclosed in these macros to silence only that false positive.
+ */
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ == 12
+    #define BIT_MANIP_AVX512_WARNINGS_BEGIN                            \
+        _Pragma("GCC diagnostic push")                                 \
+        _Pragma("GCC diagnostic ignored \"-Wuninitialized\"")          \
+        _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+    #define BIT_MANIP_AVX512_WARNINGS_END _Pragma("GCC diagnostic pop")
+#else
+    #define BIT_MANIP_AVX512_WARNINGS_BEGIN
+    #define BIT_MANIP_AVX512_WARNINGS_END
+#endif
+
+namespace bit {
+
+//! Instruction sets that kernels use.
+enum class Isa { scalar, popcnt, sse2, avx2, avx512, neon };
+
+constexpr std::string_view ToString(const Isa isa) noexcept {
+    switch (isa) {
+        case Isa::popcnt:
+            return "popcnt";
+        case Isa::sse2:
+            return "sse2";
+        case Isa::avx2:
+            return "avx2";
+        case Isa::avx512:
+            return "avx512";
+        case Isa::neon:
+            return "neon";
+        default:
+            return "scalar";
+    }
+}
+
+//! The instruction sets used by each family of bulk operations on the current CPU.
+struct KernelPaths {
+    //! Counting set bits in quad words, used by `Bitset::Count` and `RankSelect`.
+    Isa popcount {Isa::scalar};
+
+    //! Set algebra of bitsets.
+    Isa bitwise {Isa::scalar};
+
+    //! `GetBits` and `SetBits` over spans.
+    Isa bulk {Isa::scalar};
+};
+
+namespace detail {
+
+//! Word operations of set algebra.
+enum class WordOp { and_words, or_words, xor_words, and_not_words };
+
+//! Count the set bits in quad words.
+using PopcountKernel = std::size_t (*)(const std::uint64_t* words, std::size_t size) noexcept;
+
+/**
+ * @brief Apply a word operation to `lhs` and `rhs` and store it in `lhs`.
+ *
+ * @return The number of processed words.
+ */
+using WordsKernel = std::size_t (*)(std::uint64_t* lhs, const std::uint64_t* rhs,
+                                    std::size_t size) noexcept;
+
+/**
+ * @brief Get `(vals[i] >> begin) & mask` for leading elements.
+ *
+ * @return The number of processed elements.
+ */
+template <std::unsigned_integral T>
+using GetBitsKernel = std::size_t (*)(const T* vals, T* out, std::size_t size, std::size_t begin,
+                                      T mask) noexcept;
+
+/**
+ * @brief Replace the bits of `vals[i]` selected by `mask` with `bits[i] << begin`
+ * for leading elements.
+ *
+ * @return The number of processed elements.
+ */
+template <std::unsigned_integral T>
+using SetBitsKernel = std::size_t (*)(T* vals, const T* bits, std::size_t size, std::size_t begin,
+                                      T mask) noexcept;
+
+//! Kernels chosen for the current CPU. A null kernel leaves all elements to the caller.
+struct Kernels {
+    PopcountKernel popcount {nullptr};
+    Isa popcount_isa {Isa::scalar};
+    WordsKernel bitwise[4] {};
+    Isa bitwise_isa {Isa::scalar};
+};
+
+//! Bulk kernels chosen for the current CPU and a value type.
+template <std::unsigned_integral T>
+struct BulkKernels {
+    GetBitsKernel<T> get_bits {nullptr};
+    SetBitsKernel<T> set_bits {nullptr};
+    Isa isa {Isa::scalar};
+};
+
+#if defined(BIT_MANIP_SSSE3)
+
+//! Whether SSSE3 kernels can run on the current CPU.
+inline bool CanUseSsse3() noexcept {
+    #if defined(__SSSE3__)
+    return true;
+    #else
+    return GetCpuFeatures().ssse3;
+    #endif
+}
+
+#endif
+
+#if defined(BIT_MANIP_AVX2)
+
+//! Count the set bits in each 64-bit lane by looking up the population of each nibble.
+BIT_MANIP_TARGET_AVX2 inline __m256i PopcountLanesAvx2(const __m256i val) noexcept {
+    const auto table {_mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2,
+                                       1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4)};
+    const auto low_mask {_mm256_set1_epi8(0x0F)};
+    const auto low {_mm256_and_si256(val, low_mask)};
+    const auto high {_mm256_and_si256(_mm256_srli_epi16(val, 4), low_mask)};
+    const auto bytes {
+        _mm256_add_epi8(_mm256_shuffle_epi8(table, low), _mm256_shuffle_epi8(table, high))};
+    return _mm256_sad_epu8(bytes, _mm256_setzero_si256());
+}
+
+//! Add three bit vectors, returning the carries and leaving the sums in `sum`.
+BIT_MANIP_TARGET_AVX2 inline __m256i CarrySaveAddAvx2(__m256i& sum, const __m256i lhs,
+                                                      const __m256i rhs) noexcept {
+    const auto half {_mm256_xor_si256(sum, lhs)};
+    const auto carry {_mm256_or_si256(_mm256_and_si256(sum, lhs), _mm256_and_si256(half, rhs))};
+    sum = _mm256_xor_si256(half, rhs);
+    return carry;
+}
+
+/**
+ * @brief Add `Count` vectors to the counters of weight one up to `Count / 2`.
+ *
+ * @return The carries of weight `Count`.
+ */
+template <std::size_t Count>
+BIT_MANIP_TARGET_AVX2 __m256i AddVectorsAvx2(__m256i* const counters,
+                                             const std::uint64_t* const words) noexcept {
+    if constexpr (Count == 2) {
+        return CarrySaveAddAvx2(
+            counters[0], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + 4)));
+    } else {
+        constexpr std::size_t level {std::countr_zero(Count) - 1};
+        const auto first {AddVectorsAvx2<Count / 2>(counters, words)};
+        const auto second {AddVectorsAvx2<Count / 2>(counters, words + Count / 2 * 4)};
+        return CarrySaveAddAvx2(counters[level], first, second);
+    }
+}
+
+/**
+ * @brief Count the set bits in whole 256-bit vectors of quad words.
+ *
+ * @details
+ * The Harley-Seal method adds 16 vectors at a time with a tree of carry-save adders
+ * into counters of weight 1, 2, 4 and 8,
+ * so only the carries of weight 16 and the final counters need a population count.
+ */
+BIT_MANIP_TARGET_AVX2 inline std::uint64_t PopcountVectorsAvx2(const std::uint64_t* const words,
+                                                               const std::size_t vectors) noexcept {
+    constexpr std::size_t block {16};
+    __m256i counters[4] {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(),
+                         _mm256_setzero_si256()};
+    auto sum {_mm256_setzero_si256()};
+    std::size_t i {0};
+    for (; i + block <= vectors; i += block) {
+        const auto carries {AddVectorsAvx2<block>(counters, words + i * 4)};
+        sum = _mm256_add_epi64(sum, PopcountLanesAvx2(carries));
+    }
+
+    sum = _mm256_slli_epi64(sum, 4);
+    for (std::size_t j {0}; j != 4; ++j) {
+        sum = _mm256_add_epi64(sum, _mm256_sll_epi64(PopcountLanesAvx2(counters[j]),
+                                                     _mm_cvtsi64_si128(static_cast<long long>(j))));
+    }
+
+    for (; i != vectors; ++i) {
+        sum = _mm256_add_epi64(sum, PopcountLanesAvx2(_mm256_loadu_si256(
+                                        reinterpret_cast<const __m256i*>(words + i * 4))));
+    }
+
+    return static_cast<std::uint64_t>(_mm256_extract_epi64(sum, 0))
+           + static_cast<std::uint64_t>(_mm256_extract_epi64(sum, 1))
+           + static_cast<std::uint64_t>(_mm256_extract_epi64(sum, 2))
+           + static_cast<std::uint64_t>(_mm256_extract_epi64(sum, 3));
+}
+
+#endif
+
+#if defined(BIT_MANIP_DISPATCH)
+
+BIT_MANIP_TARGET_POPCNT inline std::size_t PopcountWordsPopcnt(const std::uint64_t* const words,
+                                                               const std::size_t size) noexcept {
+    std::uint64_t total {0};
+    for (std::size_t i {0}; i != size; ++i) {
+        total += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i]));
+    }
+
+    return static_cast<std::size_t>(total);
+}
+
+BIT_MANIP_TARGET_AVX2 inline std::size_t PopcountWordsAvx2(const std::uint64_t* const words,
+                                                           const std::size_t size) noexcept {
+    auto total {PopcountVectorsAvx2(words, size / 4)};
+    for (auto i {size / 4 * 4}; i != size; ++i) {
+        total += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i]));
+    }
+
+    return static_cast<std::size_t>(total);
+}
+
+BIT_MANIP_AVX512_WARNINGS_BEGIN
+BIT_MANIP_TARGET_AVX512_POPCNT inline std::size_t PopcountWordsAvx512(
+    const std::uint64_t* const words, const std::size_t size) noexcept {
+    auto sum {_mm512_setzero_si512()};
+    std::size_t i {0};
+    for (; i + 8 <= size; i += 8) {
+        sum = _mm512_add_epi64(sum, _mm512_popcnt_epi64(_mm512_loadu_si512(words + i)));
+    }
+
+    auto total {static_cast<std::uint64_t>(_mm512_reduce_add_epi64(sum))};
+    for (; i != size; ++i) {
+        total += static_cast<std::uint64_t>(_mm_popcnt_u64(words[i]));
+    }
+
+    return static_cast<std::size_t>(total);
+}
+BIT_MANIP_AVX512_WARNINGS_END
+
+template <WordOp Op>
+BIT_MANIP_TARGET_AVX2 std::size_t ApplyWordsAvx2(std::uint64_t* const lhs,
+                                                 const std::uint64_t* const rhs,
+                                                 const std::size_t size) noexcept {
+    std::size_t i {0};
+    for (; i + 4 <= size; i += 4) {
+        const auto left {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i))};
+        const auto right {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i))};
+        __m256i result;
+        if constexpr (Op == WordOp::and_words) {
+            result = _mm256_and_si256(left, right);
+        } else if constexpr (Op == WordOp::or_words) {
+            result = _mm256_or_si256(left, right);
+        } else if constexpr (Op == WordOp::xor_words) {
+            result = _mm256_xor_si256(left, right);
+        } else {
+            result = _mm256_andnot_si256(right, left);
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lhs + i), result);
+    }
+
+    return i;
+}
+
+BIT_MANIP_AVX512_WARNINGS_BEGIN
+template <WordOp Op>
+BIT_MANIP_TARGET_AVX512 std::size_t ApplyWordsAvx512(std::uint64_t* const lhs,
+                                                     const std::uint64_t* const rhs,
+                                                     const std::size_t size) noexcept {
+    std::size_t i {0};
+    for (; i + 8 <= size; i += 8) {
+        const auto left {_mm512_loadu_si512(lhs + i)};
+        const auto right {_mm512_loadu_si512(rhs + i)};
+        __m512i result;
+        if constexpr (Op == WordOp::and_words) {
+            result = _mm512_and_si512(left, right);
+        } else if constexpr (Op == WordOp::or_words) {
+            result = _mm512_or_si512(left, right);
+        } else if constexpr (Op == WordOp::xor_words) {
+            result = _mm512_xor_si512(left, right);
+        } else {
+            result = _mm512_andnot_si512(right, left);
+        }
+
+        _mm512_storeu_si512(lhs + i, result);
+    }
+
+    return i;
+}
+BIT_MANIP_AVX512_WARNINGS_END
+
+/**
+ * @brief Shift each AVX2 lane right or left.
+ *
+ * @details
+ * Byte lanes use 16-bit shifts and rely on the caller's mask.
+ */
+template <std::unsigned_integral T, bool Right>
+BIT_MANIP_TARGET_AVX2 __m256i ShiftAvx2(const __m256i val, const std::size_t count) noexcept {
+    const auto n {_mm_cvtsi32_si128(static_cast<int>(count))};
+    if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+        return Right ? _mm256_srl_epi16(val, n) : _mm256_sll_epi16(val, n);
+    } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+        return Right ? _mm256_srl_epi32(val, n) : _mm256_sll_epi32(val, n);
+    } else {
+        return Right ? _mm256_srl_epi64(val, n) : _mm256_sll_epi64(val, n);
+    }
+}
+
+BIT_MANIP_AVX512_WARNINGS_BEGIN
+//! Shift each AVX-512 lane right or left. Byte lanes rely on the caller's mask.
+template <std::unsigned_integral T, bool Right>
+BIT_MANIP_TARGET_AVX512 __m512i ShiftAvx512(const __m512i val, const std::size_t count) noexcept {
+    const auto n {_mm_cvtsi32_si128(static_cast<int>(count))};
+    if constexpr (sizeof(T) <= sizeof(std::uint16_t)) {
+        return Right ? _mm512_srl_epi16(val, n) : _mm512_sll_epi16(val, n);
+    } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+        return Right ? _mm512_srl_epi32(val, n) : _mm512_sll_epi32(val, n);
+    } else {
+        return Right ? _mm512_srl_epi64(val, n) : _mm512_sll_epi64(val, n);
+    }
+}
+BIT_MANIP_AVX512_WARNINGS_END
+
+template <std::unsigned_integral T>
+BIT_MANIP_TARGET_AVX2 __m256i BroadcastAvx2(const T val) noexcept {
+    if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+        return _mm256_set1_epi8(static_cast<char>(val));
+    } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+        return _mm256_set1_epi16(static_cast<short>(val));
+    } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+        return _mm256_set1_epi32(static_cast<int>(val));
+    } else {
+        return _mm256_set1_epi64x(static_cast<long long>(val));
+    }
+}
+
+BIT_MANIP_AVX512_WARNINGS_BEGIN
+template <std::unsigned_integral T>
+BIT_MANIP_TARGET_AVX512 __m512i BroadcastAvx512(const T val) noexcept {
+    if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+        return _mm512_set1_epi8(static_cast<char>(val));
+    } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+        return _mm512_set1_epi16(static_cast<short>(val));
+    } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+        return _mm512_set1_epi32(static_cast<int>(val));
+    } else {
+        return _mm512_set1_epi64(static_cast<long long>(val));
+    }
+}
+BIT_MANIP_AVX512_WARNINGS_END
+
+template <std::unsigned_integral T>
+BIT_MANIP_TARGET_AVX2 std::size_t GetBitsAvx2(const T* const vals, T* const out,
+                                              const std::size_t size, const std::size_t begin,
+                                              const T mask) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i) / sizeof(T)};
+    const auto masks {BroadcastAvx2(mask)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + i))};
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_and_si256(ShiftAvx2<T, true>(val, begin), masks));
+    }
+
+    return i;
+}
+
+BIT_MANIP_AVX512_WARNINGS_BEGIN
+template <std::unsigned_integral T>
+BIT_MANIP_TARGET_AVX512 std::size_t GetBitsAvx512(const T* const vals, T* const out,
+                                                  const std::size_t size, const std::size_t begin,
+                                                  const T mask) noexcept {
+    constexpr std::size_t lanes {sizeof(__m512i) / sizeof(T)};
+    const auto masks {BroadcastAvx512(mask)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm512_loadu_si512(vals + i)};
+        _mm512_storeu_si512(out + i, _mm512_and_si512(ShiftAvx512<T, true>(val, begin), masks));
+    }
+
+    return i;
+}
+BIT_MANIP_AVX512_WARNINGS_END
+
+template <std::unsigned_integral T>
+BIT_MANIP_TARGET_AVX2 std::size_t SetBitsAvx2(T* const vals, const T* const bits,
+                                              const std::size_t size, const std::size_t begin,
+                                              const T mask) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i) / sizeof(T)};
+    const auto masks {BroadcastAvx2(mask)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + i))};
+        const auto field {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i))};
+        const auto shifted {_mm256_and_si256(ShiftAvx2<T, false>(field, begin), masks)};
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(vals + i),
+                            _mm256_or_si256(_mm256_andnot_si256(masks, val), shifted));
+    }
+
+    return i;
+}
+
+BIT_MANIP_AVX512_WARNINGS_BEGIN
+template <std::unsigned_integral T>
+BIT_MANIP_TARGET_AVX512 std::size_t SetBitsAvx512(T* const vals, const T* const bits,
+                                                  const std::size_t size, const std::size_t begin,
+                                                  const T mask) noexcept {
+    constexpr std::size_t lanes {sizeof(__m512i) / sizeof(T)};
+    const auto masks {BroadcastAvx512(mask)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm512_loadu_si512(vals + i)};
+        const auto shifted {
+            _mm512_and_si512(ShiftAvx512<T, false>(_mm512_loadu_si512(bits + i), begin), masks)};
+        _mm512_storeu_si512(vals + i, _mm512_or_si512(_mm512_andnot_si512(masks, val), shifted));
+    }
+
+    return i;
+}
+BIT_MANIP_AVX512_WARNINGS_END
+
+//! Choose the widest kernels that a CPU supports.
+inline Kernels SelectKernels(const CpuFeatures& cpu) noexcept {
+    Kernels kernels;
+    if (cpu.avx512f && cpu.avx512vpopcntdq && cpu.popcnt) {
+        kernels.popcount = &PopcountWordsAvx512;
+        kernels.popcount_isa = Isa::avx512;
+    } else if (cpu.avx2 && cpu.popcnt) {
+        kernels.popcount = &PopcountWordsAvx2;
+        kernels.popcount_isa = Isa::avx2;
+    } else if (cpu.popcnt) {
+        kernels.popcount = &PopcountWordsPopcnt;
+        kernels.popcount_isa = Isa::popcnt;
+    }
+
+    if (cpu.avx512f && cpu.avx512bw && cpu.popcnt) {
+        kernels.bitwise[0] = &ApplyWordsAvx512<WordOp::and_words>;
+        kernels.bitwise[1] = &ApplyWordsAvx512<WordOp::or_words>;
+        kernels.bitwise[2] = &ApplyWordsAvx512<WordOp::xor_words>;
+        kernels.bitwise[3] = &ApplyWordsAvx512<WordOp::and_not_words>;
+        kernels.bitwise_isa = Isa::avx512;
+    } else if (cpu.avx2 && cpu.popcnt) {
+        kernels.bitwise[0] = &ApplyWordsAvx2<WordOp::and_words>;
+        kernels.bitwise[1] = &ApplyWordsAvx2<WordOp::or_words>;
+        kernels.bitwise[2] = &ApplyWordsAvx2<WordOp::xor_words>;
+        kernels.bitwise[3] = &ApplyWordsAvx2<WordOp::and_not_words>;
+        kernels.bitwise_isa = Isa::avx2;
+    }
+
+    return kernels;
+}
+
+//! Choose the widest bulk kernels for a value type that a CPU supports.
+template <std::unsigned_integral T>
+BulkKernels<T> SelectBulkKernels(const CpuFeatures& cpu) noexcept {
+    if (cpu.avx512f && cpu.avx512bw && cpu.popcnt) {
+        return {&GetBitsAvx512<T>, &SetBitsAvx512<T>, Isa::avx512};
+    } else if (cpu.avx2 && cpu.popcnt) {
+        return {&GetBitsAvx2<T>, &SetBitsAvx2<T>, Isa::avx2};
+    } else {
+        return {};
+    }
+}
+
+#else
+
+inline Kernels SelectKernels(const CpuFeatures&) noexcept {
+    return {};
+}
+
+template <std::unsigned_integral T>
+BulkKernels<T> SelectBulkKernels(const CpuFeatures&) noexcept {
+    return {};
+}
+
+#endif
+
+//! Get the kernels chosen for the current CPU.
+inline const Kernels& GetKernels() noexcept {
+    static const Kernels kernels {SelectKernels(GetCpuFeatures())};
+    return kernels;
+}
+
+//! Get the bulk kernels chosen for the current CPU and a value type.
+template <std::unsigned_integral T>
+const BulkKernels<T>& GetBulkKernels() noexcept {
+    static const BulkKernels<T> kernels {SelectBulkKernels<T>(GetCpuFeatures())};
+    return kernels;
+}
+
+//! Get the kernel of a word operation, or a null pointer.
+inline WordsKernel GetWordsKernel(const WordOp op) noexcept {
+    return GetKernels().bitwise[static_cast<std::size_t>(op)];
+}
+
+//! The instruction set of the vector unit enabled at compile time.
+constexpr Isa StaticVectorIsa() noexcept {
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+    return Isa::avx512;
+#elif defined(__AVX2__)
+    return Isa::avx2;
+#elif defined(__SSE2__)
+    return Isa::sse2;
+#elif defined(__ARM_NEON)
+    return Isa::neon;
+#else
+    return Isa::scalar;
+#endif
+}
+
+//! The instruction set used to count set bits at compile time.
+constexpr Isa StaticPopcountIsa() noexcept {
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    return Isa::avx512;
+#elif defined(__AVX2__)
+    return Isa::avx2;
+#elif defined(__POPCNT__)
+    return Isa::popcnt;
+#else
+    return Isa::scalar;
+#endif
+}
+
+}  // namespace detail
+
+//! Get the instruction sets used by bulk operations on the current CPU, for logging.
+inline KernelPaths GetKernelPaths() noexcept {
+    using namespace detail;
+    KernelPaths paths {StaticPopcountIsa(), StaticVectorIsa(), StaticVectorIsa()};
+    if (paths.popcount != Isa::avx512 && GetKernels().popcount != nullptr) {
+        paths.popcount = GetKernels().popcount_isa;
+    }
+
+    if (paths.bitwise != Isa::avx512) {
+        if (GetKernels().bitwise_isa != Isa::scalar) {
+            paths.bitwise = GetKernels().bitwise_isa;
+        }
+
+        // All value types share the same choice.
+        if (GetBulkKernels<std::uint64_t>().isa != Isa::scalar) {
+            paths.bulk = GetBulkKernels<std::uint64_t>().isa;
+        }
+    }
+
+    return paths;
+}
+
+}  // namespace bit
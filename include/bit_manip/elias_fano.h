@@ -0,0 +1,241 @@
+/**
+ * @file elias_fano.h
+ * @brief Elias-Fano coding of non-decreasing sequences of 32-bit unsigned integers.
+ *
+ * @details
+ * For `n` values below `u`, each value is split at `l = floor(log2(u / n))` bits.
+ * The low `l` bits are packed in a `PackedVector`.
+ * The high bits are stored in unary in a bitset, where value `i` sets bit `(val >> l) + i`,
+ * so each run of set bits between two cleared bits holds the values of one high part.
+ * A sequence takes at most `2 + l` bits per value plus the rank and select index.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "bitset.h"
+#include "packed_vector.h"
+#include "rank_select.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+namespace bit {
+
+/**
+ * @brief A compressed non-decreasing sequence of 32-bit unsigned integers.
+ *
+ * @details
+ * Accessing a value selects its set high bit.
+ * Finding the first value not less than `x` selects the cleared bit
+ * before the values with the high part of `x`, then scans forward.
+ * Iteration scans the high bits word by word without any select.
+ */
+class EliasFano {
+public:
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    //! A forward iterator over values.
+    class ConstIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = EliasFano::value_type;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr ConstIterator() noexcept = default;
+
+        constexpr value_type operator*() const noexcept {
+            return val_;
+        }
+
+        //! The index of the value in the sequence.
+        constexpr size_type index() const noexcept {
+            return idx_;
+        }
+
+        ConstIterator& operator++() noexcept {
+            ++idx_;
+            Load();
+            return *this;
+        }
+
+        ConstIterator operator++(int) noexcept {
+            auto old {*this};
+            ++*this;
+            return old;
+        }
+
+        friend constexpr bool operator==(const ConstIterator& lhs,
+                                         const ConstIterator& rhs) noexcept {
+            return lhs.idx_ == rhs.idx_;
+        }
+
+    private:
+        friend class EliasFano;
+
+        /**
+         * @brief Create an iterator at the first set high bit at or after `pos`.
+         *
+         * @param idx The number of set high bits before `pos`.
+         */
+        ConstIterator(const EliasFano& seq, const size_type idx, const size_type pos) noexcept :
+            seq_ {&seq},
+            words_ {seq.high_.words().data()},
+            idx_ {idx},
+            word_idx_ {pos / Bitset::word_width} {
+            if (idx_ < seq_->size()) {
+                word_ = words_[word_idx_];
+                ClearBits(word_, 0, pos % Bitset::word_width);
+                Load();
+            }
+        }
+
+        //! Move to the next set high bit and decode the value at the current index.
+        void Load() noexcept {
+            if (idx_ == seq_->size()) {
+                return;
+            }
+
+            while (word_ == 0) {
+                word_ = words_[++word_idx_];
+            }
+
+            const auto pos {word_idx_ * Bitset::word_width
+                            + static_cast<size_type>(std::countr_zero(word_))};
+            word_ &= word_ - 1;
+            val_ = seq_->Combine(pos - idx_, idx_);
+        }
+
+        const EliasFano* seq_ {nullptr};
+        const Bitset::Word* words_ {nullptr};
+        size_type idx_ {0};
+        size_type word_idx_ {0};
+
+        //! The high bits of the current word after the current value.
+        Bitset::Word word_ {0};
+
+        value_type val_ {0};
+    };
+
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    EliasFano() noexcept = default;
+
+    //! Encode a non-decreasing sequence.
+    explicit EliasFano(const std::span<const value_type> vals) : size_ {vals.size()} {
+        assert(std::ranges::is_sorted(vals));
+        if (vals.empty()) {
+            return;
+        }
+
+        const auto universe {static_cast<std::uint64_t>(vals.back()) + 1};
+        if (universe > size_) {
+            low_width_ = static_cast<std::size_t>(std::bit_width(universe / size_)) - 1;
+        }
+
+        if (low_width_ != 0) {
+            lows_ = PackedVector<> {low_width_};
+            lows_.reserve(size_);
+        }
+
+        const auto max_high {static_cast<std::uint64_t>(vals.back()) >> low_width_};
+        high_ = Bitset {size_ + static_cast<size_type>(max_high) + 1};
+        for (size_type i {0}; i != size_; ++i) {
+            const std::uint64_t val {vals[i]};
+            if (low_width_ != 0) {
+                lows_.push_back(static_cast<value_type>(GetBits(val, 0, low_width_)));
+            }
+
+            high_.Set(static_cast<size_type>(val >> low_width_) + i);
+        }
+
+        index_ = RankSelect {high_};
+    }
+
+    // The index refers to the words of the high bits, which are kept by moves but not by copies.
+    EliasFano(const EliasFano&) = delete;
+    EliasFano& operator=(const EliasFano&) = delete;
+    EliasFano(EliasFano&&) noexcept = default;
+    EliasFano& operator=(EliasFano&&) noexcept = default;
+
+    constexpr size_type size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    //! The number of low bits per value.
+    constexpr std::size_t low_width() const noexcept {
+        return low_width_;
+    }
+
+    //! The number of bytes used by the low bits, the high bits and the index.
+    size_type memory_size() const noexcept {
+        return (low_width_ != 0 ? lows_.memory_size() : 0)
+               + high_.words().size() * sizeof(Bitset::Word) + index_.memory_size();
+    }
+
+    value_type operator[](const size_type idx) const noexcept {
+        return Get(idx);
+    }
+
+    //! Get a value.
+    value_type Get(const size_type idx) const noexcept {
+        assert(idx < size_);
+        return Combine(index_.Select1(idx) - idx, idx);
+    }
+
+    ConstIterator begin() const noexcept {
+        return {*this, 0, 0};
+    }
+
+    ConstIterator end() const noexcept {
+        ConstIterator it;
+        it.seq_ = this;
+        it.idx_ = size_;
+        return it;
+    }
+
+    //! Find the first value not less than `val`, or `end()` if there is none.
+    ConstIterator NextGeq(const value_type val) const noexcept {
+        const auto high {static_cast<size_type>(static_cast<std::uint64_t>(val) >> low_width_)};
+        // The high bits end with one cleared bit per high part up to the last value.
+        if (empty() || high >= high_.size() - size_) {
+            return end();
+        }
+
+        const auto pos {high != 0 ? index_.Select0(high - 1) + 1 : 0};
+        ConstIterator it {*this, pos - high, pos};
+        while (it.idx_ != size_ && *it < val) {
+            ++it;
+        }
+
+        return it;
+    }
+
+private:
+    value_type Combine(const size_type high, const size_type idx) const noexcept {
+        const auto low {low_width_ != 0 ? lows_.Get(idx) : 0};
+        return static_cast<value_type>((static_cast<std::uint64_t>(high) << low_width_) | low);
+    }
+
+    size_type size_ {0};
+    std::size_t low_width_ {0};
+    PackedVector<> lows_ {1};
+    Bitset high_;
+    RankSelect index_;
+};
+
+}  // namespace bit
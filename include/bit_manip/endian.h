@@ -0,0 +1,227 @@
+/**
+ * @file endian.h
+ * @brief Byte order conversion for loading and storing integers in wire formats.
+ *
+ * @details
+ * Loads and stores accept unaligned byte pointers.
+ * At runtime they copy the bytes as a whole and swap them only when the native byte order differs,
+ * which compiles to a single `mov`, `movbe` or `bswap`.
+ * During constant evaluation they assemble the bytes one by one instead.
+ *
+ * Bulk byte swapping shuffles whole vectors with SSSE3 or AVX2 when the CPU supports them.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "dispatch.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace bit {
+
+namespace detail {
+
+//! A type that holds one byte of a buffer.
+template <typename T>
+concept Octet = std::same_as<T, std::byte> || std::same_as<T, std::uint8_t>
+                || std::same_as<T, char> || std::same_as<T, unsigned char>;
+
+}  // namespace detail
+
+//! Reverse the bytes of an integral value.
+template <std::integral T>
+constexpr T ByteSwap(const T val) noexcept {
+    using Bits = std::make_unsigned_t<T>;
+    const auto bits {static_cast<Bits>(val)};
+    if constexpr (sizeof(T) == sizeof(std::uint8_t)) {
+        return val;
+#if defined(__GNUC__) || defined(__clang__)
+    } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+        return static_cast<T>(__builtin_bswap16(bits));
+    } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+        return static_cast<T>(__builtin_bswap32(bits));
+    } else if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+        return static_cast<T>(__builtin_bswap64(bits));
+#endif
+    } else {
+        Bits swapped {0};
+        for (std::size_t i {0}; i != sizeof(T); ++i) {
+            SetByte(swapped, GetByte(bits, i * CHAR_BIT), (sizeof(T) - 1 - i) * CHAR_BIT);
+        }
+
+        return static_cast<T>(swapped);
+    }
+}
+
+namespace detail {
+
+template <std::endian Order, std::integral T, Octet Byte>
+constexpr T Load(const Byte* const src) noexcept {
+    if (std::is_constant_evaluated()) {
+        std::make_unsigned_t<T> val {0};
+        for (std::size_t i {0}; i != sizeof(T); ++i) {
+            const auto idx {Order == std::endian::little ? i : sizeof(T) - 1 - i};
+            SetByte(val, static_cast<std::uint8_t>(src[idx]), i * CHAR_BIT);
+        }
+
+        return static_cast<T>(val);
+    } else {
+        T val;
+        std::memcpy(&val, src, sizeof(T));
+        return Order == std::endian::native ? val : ByteSwap(val);
+    }
+}
+
+template <std::endian Order, std::integral T, Octet Byte>
+constexpr void Store(Byte* const dest, const T val) noexcept {
+    if (std::is_constant_evaluated()) {
+        for (std::size_t i {0}; i != sizeof(T); ++i) {
+            const auto idx {Order == std::endian::little ? i : sizeof(T) - 1 - i};
+            dest[idx] = static_cast<Byte>(GetByte(val, i * CHAR_BIT));
+        }
+    } else {
+        const auto ordered {Order == std::endian::native ? val : ByteSwap(val)};
+        std::memcpy(dest, &ordered, sizeof(T));
+    }
+}
+
+//! The source byte of each byte when reversing `Size`-byte lanes of a 16-byte vector.
+template <std::size_t Size>
+inline constexpr auto byte_swap_lanes {[] {
+    alignas(16) std::array<std::uint8_t, 16> lanes {};
+    for (std::size_t i {0}; i != lanes.size(); ++i) {
+        lanes[i] = static_cast<std::uint8_t>(i / Size * Size + Size - 1 - i % Size);
+    }
+
+    return lanes;
+}()};
+
+#if defined(BIT_MANIP_SSSE3)
+
+/**
+ * @brief Reverse the bytes of `Size`-byte values in whole 16-byte vectors with SSSE3.
+ *
+ * @return The number of processed values.
+ */
+template <std::size_t Size>
+BIT_MANIP_TARGET_SSSE3 std::size_t ByteSwapSsse3(const void* const vals, void* const out,
+                                                 const std::size_t size) noexcept {
+    constexpr std::size_t lanes {sizeof(__m128i) / Size};
+    const auto shuffle {
+        _mm_load_si128(reinterpret_cast<const __m128i*>(byte_swap_lanes<Size>.data()))};
+    const auto* const src {static_cast<const __m128i*>(vals)};
+    auto* const dest {static_cast<__m128i*>(out)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm_loadu_si128(src + i / lanes)};
+        _mm_storeu_si128(dest + i / lanes, _mm_shuffle_epi8(val, shuffle));
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(BIT_MANIP_DISPATCH)
+
+/**
+ * @brief Reverse the bytes of `Size`-byte values in whole 32-byte vectors with AVX2.
+ *
+ * @return The number of processed values.
+ */
+template <std::size_t Size>
+BIT_MANIP_TARGET_AVX2 std::size_t ByteSwapAvx2(const void* const vals, void* const out,
+                                               const std::size_t size) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i) / Size};
+    const auto shuffle {_mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(byte_swap_lanes<Size>.data())))};
+    const auto* const src {static_cast<const __m256i*>(vals)};
+    auto* const dest {static_cast<__m256i*>(out)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm256_loadu_si256(src + i / lanes)};
+        _mm256_storeu_si256(dest + i / lanes, _mm256_shuffle_epi8(val, shuffle));
+    }
+
+    return i;
+}
+
+#endif
+
+}  // namespace detail
+
+//! Load a big-endian integral value from unaligned bytes.
+template <std::integral T, detail::Octet Byte>
+constexpr T LoadBE(const Byte* const src) noexcept {
+    return detail::Load<std::endian::big, T>(src);
+}
+
+//! Load a little-endian integral value from unaligned bytes.
+template <std::integral T, detail::Octet Byte>
+constexpr T LoadLE(const Byte* const src) noexcept {
+    return detail::Load<std::endian::little, T>(src);
+}
+
+//! Store an integral value as big-endian unaligned bytes.
+template <std::integral T, detail::Octet Byte>
+constexpr void StoreBE(Byte* const dest, const T val) noexcept {
+    detail::Store<std::endian::big>(dest, val);
+}
+
+//! Store an integral value as little-endian unaligned bytes.
+template <std::integral T, detail::Octet Byte>
+constexpr void StoreLE(Byte* const dest, const T val) noexcept {
+    detail::Store<std::endian::little>(dest, val);
+}
+
+/**
+ * @brief Reverse the bytes of each integral value of a span.
+ *
+ * @details
+ * `out[i]` receives `ByteSwap(vals[i])`.
+ * `out` must be at least as large as `vals` and may alias it exactly.
+ */
+template <std::integral T>
+void ByteSwap(const std::span<const std::type_identity_t<T>> vals,
+              const std::span<T> out) noexcept {
+    assert(out.size() >= vals.size());
+    std::size_t i {0};
+    if constexpr (sizeof(T) != sizeof(std::uint8_t)) {
+#if defined(BIT_MANIP_DISPATCH)
+        if (GetCpuFeatures().avx2) {
+            i = detail::ByteSwapAvx2<sizeof(T)>(vals.data(), out.data(), vals.size());
+        }
+#endif
+#if defined(BIT_MANIP_SSSE3)
+        if (detail::CanUseSsse3()) {
+            i += detail::ByteSwapSsse3<sizeof(T)>(vals.data() + i, out.data() + i,
+                                                  vals.size() - i);
+        }
+#endif
+    }
+
+    for (; i != vals.size(); ++i) {
+        out[i] = ByteSwap(vals[i]);
+    }
+}
+
+//! Reverse the bytes of each integral value of a span in place.
+template <std::integral T>
+void ByteSwap(const std::span<T> vals) noexcept {
+    ByteSwap<T>(vals, vals);
+}
+
+}  // namespace bit
@@ -0,0 +1,388 @@
+/**
+ * @file hilbert.h
+ * @brief Hilbert curve keys of 2D and 3D coordinates.
+ *
+ * @details
+ * Consecutive Hilbert keys always belong to neighboring points,
+ * so key ranges cover more compact regions than Morton keys.
+ * 2D keys hold two 32-bit coordinates, and 3D keys hold three 21-bit coordinates.
+ *
+ * Both curves follow Skilling's construction.
+ * At each level, the bits of the coordinates select a sub-cube,
+ * whose order on the curve depends on a state made of
+ * how the lower bits are permuted and inverted, and the parity of the Gray code above.
+ * There are 8 states in 2D and 48 in 3D.
+ * Tables built at compile time map a state and several levels of a Morton key at once
+ * to the same levels of the Hilbert key and the next state,
+ * so a key is converted from its Morton key in 8 lookups in 2D and 11 in 3D.
+ * Points in `[0, 2^k)` in every dimension take the first keys,
+ * and a key is unchanged when coordinates get more bits.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "morton.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace bit {
+
+namespace detail {
+
+//! How the lower bits of coordinates are transformed before they select a sub-cube.
+template <std::size_t Dims>
+struct HilbertState {
+    //! Axis `i` reads the bits of coordinate `axes[i]`.
+    std::array<std::uint8_t, Dims> axes;
+
+    //! Axis `i` inverts its bits if bit `i` is set.
+    std::uint8_t flips {0};
+
+    //! The parity of the last Gray code bits of the levels above.
+    bool parity {false};
+
+    constexpr bool operator==(const HilbertState&) const noexcept = default;
+};
+
+template <std::size_t Dims>
+constexpr HilbertState<Dims> MakeHilbertRoot() noexcept {
+    HilbertState<Dims> state {};
+    for (std::size_t i {0}; i != Dims; ++i) {
+        state.axes[i] = static_cast<std::uint8_t>(i);
+    }
+
+    return state;
+}
+
+/**
+ * @brief Move to the next level after transformed bits select a sub-cube.
+ *
+ * @details
+ * For each axis whose bit is set, the lower bits of axis 0 are inverted.
+ * Otherwise, the lower bits of axis 0 and the axis are exchanged.
+ *
+ * @return The Hilbert bits of the level, with axis 0 in the highest bit.
+ */
+template <std::size_t Dims>
+constexpr std::size_t AdvanceHilbert(HilbertState<Dims>& state, const std::size_t bits) noexcept {
+    std::size_t digit {0};
+    bool gray {false};
+    for (std::size_t i {0}; i != Dims; ++i) {
+        gray ^= IsBitSet(bits, i);
+        if (gray != state.parity) {
+            SetBit(digit, Dims - 1 - i);
+        }
+    }
+
+    for (std::size_t i {0}; i != Dims; ++i) {
+        if (IsBitSet(bits, i)) {
+            state.flips ^= 1;
+        } else if (i != 0) {
+            std::swap(state.axes[0], state.axes[i]);
+            if (IsBitSet(state.flips, 0) != IsBitSet(state.flips, i)) {
+                state.flips ^= static_cast<std::uint8_t>(1 | 1 << i);
+            }
+        }
+    }
+
+    state.parity ^= gray;
+    return digit;
+}
+
+/**
+ * @brief Map one level of coordinate bits to Hilbert bits.
+ *
+ * @param coords The bits of the level, with coordinate `i` in bit `i`.
+ */
+template <std::size_t Dims>
+constexpr std::size_t EncodeHilbertLevel(HilbertState<Dims>& state,
+                                         const std::size_t coords) noexcept {
+    std::size_t bits {0};
+    for (std::size_t i {0}; i != Dims; ++i) {
+        if (IsBitSet(coords, state.axes[i]) != IsBitSet(state.flips, i)) {
+            SetBit(bits, i);
+        }
+    }
+
+    return AdvanceHilbert(state, bits);
+}
+
+//! Map one level of Hilbert bits back to coordinate bits.
+template <std::size_t Dims>
+constexpr std::size_t DecodeHilbertLevel(HilbertState<Dims>& state,
+                                         const std::size_t digit) noexcept {
+    std::size_t bits {0};
+    std::size_t coords {0};
+    bool prev_gray {state.parity};
+    for (std::size_t i {0}; i != Dims; ++i) {
+        const bool gray {IsBitSet(digit, Dims - 1 - i)};
+        if (gray != prev_gray) {
+            SetBit(bits, i);
+        }
+
+        if (IsBitSet(bits, i) != IsBitSet(state.flips, i)) {
+            SetBit(coords, state.axes[i]);
+        }
+
+        prev_gray = gray;
+    }
+
+    AdvanceHilbert(state, bits);
+    return coords;
+}
+
+//! The largest number of states, reached by permuting and inverting all axes with either parity.
+template <std::size_t Dims>
+inline constexpr std::size_t max_hilbert_states {Dims == 2 ? 16 : 96};
+
+//! Find the states reachable from the root, which gets index `0`.
+template <std::size_t Dims>
+constexpr auto FindHilbertStates() noexcept {
+    std::array<HilbertState<Dims>, max_hilbert_states<Dims>> states {};
+    std::size_t count {1};
+    states[0] = MakeHilbertRoot<Dims>();
+    for (std::size_t i {0}; i != count; ++i) {
+        for (std::size_t coords {0}; coords != 1U << Dims; ++coords) {
+            auto next {states[i]};
+            EncodeHilbertLevel(next, coords);
+            if (std::find(states.begin(), states.begin() + count, next)
+                == states.begin() + count) {
+                states[count++] = next;
+            }
+        }
+    }
+
+    return std::pair {states, count};
+}
+
+template <std::size_t Dims>
+inline constexpr std::size_t hilbert_state_count {FindHilbertStates<Dims>().second};
+
+/**
+ * @brief Tables that convert `Levels` levels of a key at once.
+ *
+ * @details
+ * Entries are indexed by `(state << chunk_width) | chunk`
+ * and hold `(next_state << chunk_width) | converted_chunk`.
+ */
+template <std::size_t Dims, std::size_t Levels>
+struct HilbertTables {
+    static constexpr std::size_t chunk_width {Dims * Levels};
+
+    std::array<std::uint16_t, (hilbert_state_count<Dims> << chunk_width)> encode;
+    std::array<std::uint16_t, (hilbert_state_count<Dims> << chunk_width)> decode;
+};
+
+/**
+ * @brief Tables that convert one level of a key.
+ *
+ * @details
+ * Entries are indexed by `(state << Dims) | bits`.
+ */
+template <std::size_t Dims>
+struct HilbertLevelTables {
+    static constexpr std::size_t size {hilbert_state_count<Dims> << Dims};
+
+    std::array<std::uint8_t, size> encode_bits;
+    std::array<std::uint8_t, size> encode_states;
+    std::array<std::uint8_t, size> decode_bits;
+    std::array<std::uint8_t, size> decode_states;
+};
+
+template <std::size_t Dims>
+constexpr HilbertLevelTables<Dims> MakeHilbertLevelTables() noexcept {
+    const auto [states, count] {FindHilbertStates<Dims>()};
+    const auto index {[&states, count](const HilbertState<Dims>& state) noexcept {
+        return static_cast<std::uint8_t>(std::find(states.begin(), states.begin() + count, state)
+                                         - states.begin());
+    }};
+
+    HilbertLevelTables<Dims> tables {};
+    for (std::size_t i {0}; i != count; ++i) {
+        for (std::size_t bits {0}; bits != 1U << Dims; ++bits) {
+            const auto entry {(i << Dims) | bits};
+            auto encode_state {states[i]};
+            tables.encode_bits[entry] =
+                static_cast<std::uint8_t>(EncodeHilbertLevel(encode_state, bits));
+            tables.encode_states[entry] = index(encode_state);
+
+            auto decode_state {states[i]};
+            tables.decode_bits[entry] =
+                static_cast<std::uint8_t>(DecodeHilbertLevel(decode_state, bits));
+            tables.decode_states[entry] = index(decode_state);
+        }
+    }
+
+    return tables;
+}
+
+//! Combine the tables of single levels into tables of `Levels` levels.
+template <std::size_t Dims, std::size_t Levels>
+constexpr HilbertTables<Dims, Levels> MakeHilbertTables() noexcept {
+    using Tables = HilbertTables<Dims, Levels>;
+    constexpr auto chunk_width {Tables::chunk_width};
+    constexpr auto levels {MakeHilbertLevelTables<Dims>()};
+    Tables tables {};
+    for (std::size_t i {0}; i != hilbert_state_count<Dims>; ++i) {
+        for (std::size_t chunk {0}; chunk != 1U << chunk_width; ++chunk) {
+            auto encode_state {i};
+            auto decode_state {i};
+            std::size_t encoded {0};
+            std::size_t decoded {0};
+            for (auto begin {chunk_width}; begin != 0;) {
+                begin -= Dims;
+                const auto bits {GetBits(chunk, begin, Dims)};
+                const auto encode_entry {(encode_state << Dims) | bits};
+                encoded |= static_cast<std::size_t>(levels.encode_bits[encode_entry]) << begin;
+                encode_state = levels.encode_states[encode_entry];
+
+                const auto decode_entry {(decode_state << Dims) | bits};
+                decoded |= static_cast<std::size_t>(levels.decode_bits[decode_entry]) << begin;
+                decode_state = levels.decode_states[decode_entry];
+            }
+
+            const auto entry {(i << chunk_width) | chunk};
+            tables.encode[entry] =
+                static_cast<std::uint16_t>((encode_state << chunk_width) | encoded);
+            tables.decode[entry] =
+                static_cast<std::uint16_t>((decode_state << chunk_width) | decoded);
+        }
+    }
+
+    return tables;
+}
+
+//! Convert 4 levels of 2D keys at once, in 8 steps.
+inline constexpr auto hilbert_2d_tables {MakeHilbertTables<2, 4>()};
+
+//! Convert 2 levels of 3D keys at once, in 11 steps of a 22-level curve whose top level is zero.
+inline constexpr auto hilbert_3d_tables {MakeHilbertTables<3, 2>()};
+
+/**
+ * @brief Convert a key chunk by chunk from the highest bits.
+ *
+ * @tparam Encode Whether to convert a Morton key to a Hilbert key, or the reverse.
+ */
+template <bool Encode, const auto& Tables, std::size_t Steps>
+constexpr std::uint64_t ConvertHilbert(const std::uint64_t key) noexcept {
+    constexpr auto chunk_width {std::remove_cvref_t<decltype(Tables)>::chunk_width};
+    const auto& table {Encode ? Tables.encode : Tables.decode};
+    std::uint64_t converted {0};
+    std::size_t state {0};
+    for (auto begin {Steps * chunk_width}; begin != 0;) {
+        begin -= chunk_width;
+        const auto entry {table[(state << chunk_width) | GetBits(key >> begin, 0, chunk_width)]};
+        converted |= static_cast<std::uint64_t>(GetBits(entry, 0, chunk_width)) << begin;
+        state = entry >> chunk_width;
+    }
+
+    return converted;
+}
+
+//! The number of keys converted through a buffer by bulk decoding.
+inline constexpr std::size_t hilbert_buffer_size {256};
+
+}  // namespace detail
+
+//! Get the Hilbert key of 2D coordinates.
+constexpr std::uint64_t HilbertEncode2D(const std::uint32_t x, const std::uint32_t y) noexcept {
+    return detail::ConvertHilbert<true, detail::hilbert_2d_tables, 8>(MortonEncode2D(x, y));
+}
+
+//! Get the 2D coordinates `{x, y}` of a Hilbert key.
+constexpr std::array<std::uint32_t, 2> HilbertDecode2D(const std::uint64_t key) noexcept {
+    return MortonDecode2D(detail::ConvertHilbert<false, detail::hilbert_2d_tables, 8>(key));
+}
+
+/**
+ * @brief Get the Hilbert key of 3D coordinates.
+ *
+ * @details
+ * Each coordinate must be below `2^21`.
+ */
+constexpr std::uint64_t HilbertEncode3D(const std::uint32_t x, const std::uint32_t y,
+                                        const std::uint32_t z) noexcept {
+    return detail::ConvertHilbert<true, detail::hilbert_3d_tables, 11>(MortonEncode3D(x, y, z));
+}
+
+//! Get the 3D coordinates `{x, y, z}` of a Hilbert key.
+constexpr std::array<std::uint32_t, 3> HilbertDecode3D(const std::uint64_t key) noexcept {
+    return MortonDecode3D(detail::ConvertHilbert<false, detail::hilbert_3d_tables, 11>(key));
+}
+
+/**
+ * @brief Encode the 2D Hilbert keys of points whose coordinates are in separate spans.
+ *
+ * @details
+ * All spans must have the same size.
+ */
+inline void HilbertEncode2D(const std::span<const std::uint32_t> xs,
+                            const std::span<const std::uint32_t> ys,
+                            const std::span<std::uint64_t> keys) noexcept {
+    MortonEncode2D(xs, ys, keys);
+    for (auto& key : keys) {
+        key = detail::ConvertHilbert<true, detail::hilbert_2d_tables, 8>(key);
+    }
+}
+
+//! Decode 2D Hilbert keys into separate spans of coordinates of the same size.
+inline void HilbertDecode2D(const std::span<const std::uint64_t> keys,
+                            const std::span<std::uint32_t> xs,
+                            const std::span<std::uint32_t> ys) noexcept {
+    assert(xs.size() == keys.size() && ys.size() == keys.size());
+    std::array<std::uint64_t, detail::hilbert_buffer_size> buffer;
+    for (std::size_t i {0}; i < keys.size(); i += buffer.size()) {
+        const auto size {std::min(buffer.size(), keys.size() - i)};
+        for (std::size_t j {0}; j != size; ++j) {
+            buffer[j] = detail::ConvertHilbert<false, detail::hilbert_2d_tables, 8>(keys[i + j]);
+        }
+
+        MortonDecode2D(std::span {buffer}.first(size), xs.subspan(i, size), ys.subspan(i, size));
+    }
+}
+
+/**
+ * @brief Encode the 3D Hilbert keys of points whose coordinates are in separate spans.
+ *
+ * @details
+ * All spans must have the same size, and each coordinate must be below `2^21`.
+ */
+inline void HilbertEncode3D(const std::span<const std::uint32_t> xs,
+                            const std::span<const std::uint32_t> ys,
+                            const std::span<const std::uint32_t> zs,
+                            const std::span<std::uint64_t> keys) noexcept {
+    MortonEncode3D(xs, ys, zs, keys);
+    for (auto& key : keys) {
+        key = detail::ConvertHilbert<true, detail::hilbert_3d_tables, 11>(key);
+    }
+}
+
+//! Decode 3D Hilbert keys into separate spans of coordinates of the same size.
+inline void HilbertDecode3D(const std::span<const std::uint64_t> keys,
+                            const std::span<std::uint32_t> xs, const std::span<std::uint32_t> ys,
+                            const std::span<std::uint32_t> zs) noexcept {
+    assert(xs.size() == keys.size() && ys.size() == keys.size() && zs.size() == keys.size());
+    std::array<std::uint64_t, detail::hilbert_buffer_size> buffer;
+    for (std::size_t i {0}; i < keys.size(); i += buffer.size()) {
+        const auto size {std::min(buffer.size(), keys.size() - i)};
+        for (std::size_t j {0}; j != size; ++j) {
+            buffer[j] = detail::ConvertHilbert<false, detail::hilbert_3d_tables, 11>(keys[i + j]);
+        }
+
+        MortonDecode3D(std::span {buffer}.first(size), xs.subspan(i, size), ys.subspan(i, size),
+                       zs.subspan(i, size));
+    }
+}
+
+}  // namespace bit
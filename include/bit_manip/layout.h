@@ -0,0 +1,208 @@
+/**
+ * @file layout.h
+ * @brief Compile-time bit-field layouts of integral values.
+ *
+ * @details
+ * A layout names the bit fields of a storage word and validates them at compile time.
+ * Each field access compiles to at most one shift and one mask with constant operands.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace bit {
+
+//! A string literal that can be used as a template argument.
+template <std::size_t Size>
+struct FixedString {
+    constexpr FixedString(const char (&str)[Size]) noexcept {
+        std::copy_n(str, Size, chars);
+    }
+
+    constexpr operator std::string_view() const noexcept {
+        return {chars, Size - 1};
+    }
+
+    char chars[Size] {};
+};
+
+//! A named bit field with `Count` bits starting at bit `Begin`.
+template <FixedString Name, std::size_t Begin, std::size_t Count>
+struct Field {
+    static_assert(Count > 0, "A field must have at least one bit");
+
+    static constexpr std::string_view name {Name};
+    static constexpr std::size_t begin {Begin};
+    static constexpr std::size_t count {Count};
+    static constexpr std::size_t end {Begin + Count};
+};
+
+namespace detail {
+
+template <typename>
+struct IsField : std::false_type {};
+
+template <FixedString Name, std::size_t Begin, std::size_t Count>
+struct IsField<Field<Name, Begin, Count>> : std::true_type {};
+
+}  // namespace detail
+
+template <typename T>
+concept BitField = detail::IsField<T>::value;
+
+/**
+ * @brief A layout of bit fields in a storage word.
+ *
+ * @details
+ * Fields must not overlap and must fit in `Storage`.
+ * They are unpacked in declaration order.
+ *
+ * @code
+ * using Header = BitLayout<std::uint32_t, Field<"ver", 0, 4>, Field<"len", 4, 12>>;
+ * static_assert(Header::Get<"len">(0x0001'2345) == 0x234);
+ * @endcode
+ */
+template <std::unsigned_integral Storage, BitField... Fields>
+class BitLayout {
+public:
+    static constexpr std::size_t size {sizeof...(Fields)};
+
+    //! Get the index of a field by name.
+    template <FixedString Name>
+    static consteval std::size_t IndexOf() noexcept {
+        constexpr std::array<std::string_view, size> names {Fields::name...};
+        return static_cast<std::size_t>(std::ranges::find(names, std::string_view {Name})
+                                        - names.begin());
+    }
+
+    //! Get the value of a field.
+    template <FixedString Name>
+    static constexpr Storage Get(const Storage word) noexcept {
+        return Extract<FieldOf<Name>>(word);
+    }
+
+    //! Set the value of a field.
+    template <FixedString Name>
+    static constexpr void Set(Storage& word, const Storage val) noexcept {
+        using F = FieldOf<Name>;
+        word = static_cast<Storage>((word & ~ShiftedMask<F>()) | Place<F>(val));
+    }
+
+    //! Clear a field.
+    template <FixedString Name>
+    static constexpr void Clear(Storage& word) noexcept {
+        word = static_cast<Storage>(word & ~ShiftedMask<FieldOf<Name>>());
+    }
+
+    /**
+     * @brief Unpack all fields at once.
+     *
+     * @tparam T A type that is brace-initialized from the field values in declaration order,
+     * such as an aggregate with one member per field.
+     */
+    template <typename T = std::array<Storage, size>>
+    static constexpr T Unpack(const Storage word) noexcept {
+        return T {static_cast<Storage>(Extract<Fields>(word))...};
+    }
+
+    //! Pack field values in declaration order into a new storage word.
+    template <std::integral... Vals>
+        requires(sizeof...(Vals) == size)
+    static constexpr Storage Pack(const Vals... vals) noexcept {
+        return static_cast<Storage>((Place<Fields>(static_cast<Storage>(vals)) | ...
+                                     | static_cast<Storage>(0)));
+    }
+
+private:
+    static constexpr std::size_t width {sizeof(Storage) * CHAR_BIT};
+
+    static_assert(((Fields::end <= width) && ...), "A field exceeds the storage type");
+
+    static consteval bool HasUniqueNames() noexcept {
+        constexpr std::array<std::string_view, size> names {Fields::name...};
+        for (std::size_t i {0}; i != size; ++i) {
+            for (std::size_t j {i + 1}; j != size; ++j) {
+                if (names[i] == names[j]) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    static consteval bool HasNoOverlap() noexcept {
+        constexpr std::array<std::size_t, size> begins {Fields::begin...};
+        constexpr std::array<std::size_t, size> ends {Fields::end...};
+        for (std::size_t i {0}; i != size; ++i) {
+            for (std::size_t j {i + 1}; j != size; ++j) {
+                if (begins[i] < ends[j] && begins[j] < ends[i]) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    static_assert(HasUniqueNames(), "Field names must be unique");
+    static_assert(HasNoOverlap(), "Fields must not overlap");
+
+    template <FixedString Name>
+    static consteval std::size_t CheckedIndexOf() noexcept {
+        constexpr auto idx {IndexOf<Name>()};
+        static_assert(idx != size, "No field has this name");
+        return idx;
+    }
+
+    template <FixedString Name>
+    using FieldOf = std::tuple_element_t<CheckedIndexOf<Name>(), std::tuple<Fields...>>;
+
+    //! The mask of a field before shifting.
+    template <BitField F>
+    static consteval Storage Mask() noexcept {
+        return F::count < width ? static_cast<Storage>((static_cast<Storage>(1) << F::count) - 1)
+                                : static_cast<Storage>(-1);
+    }
+
+    //! The mask of a field at its position.
+    template <BitField F>
+    static consteval Storage ShiftedMask() noexcept {
+        return static_cast<Storage>(Mask<F>() << F::begin);
+    }
+
+    //! Extract a field, skipping the shift for a field at bit 0 and the mask for a top field.
+    template <BitField F>
+    static constexpr Storage Extract(const Storage word) noexcept {
+        if constexpr (F::end == width) {
+            return static_cast<Storage>(word >> F::begin);
+        } else if constexpr (F::begin == 0) {
+            return static_cast<Storage>(word & Mask<F>());
+        } else {
+            return static_cast<Storage>((word >> F::begin) & Mask<F>());
+        }
+    }
+
+    //! Move a value to the position of a field, dropping bits that do not fit.
+    template <BitField F>
+    static constexpr Storage Place(const Storage val) noexcept {
+        if constexpr (F::end == width) {
+            return static_cast<Storage>(val << F::begin);
+        } else {
+            return static_cast<Storage>((val & Mask<F>()) << F::begin);
+        }
+    }
+};
+
+}  // namespace bit
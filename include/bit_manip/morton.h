@@ -0,0 +1,376 @@
+/**
+ * @file morton.h
+ * @brief Morton (Z-order) keys of 2D and 3D coordinates.
+ *
+ * @details
+ * A Morton key interleaves the bits of coordinates, from `x` in the lowest bit,
+ * so keys of nearby points tend to be close.
+ * 2D keys hold two 8-bit, 16-bit or 32-bit coordinates, and 3D keys hold three 21-bit coordinates.
+ *
+ * Bits are spread with `pdep` and gathered with `pext` when the CPU runs them natively.
+ * Otherwise, each coordinate is spread in five steps that double the gaps between bit groups,
+ * which are the "magic bits" masks.
+ * Bulk versions run the same steps on four keys at once with AVX2 when the CPU supports it.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "dispatch.h"
+#include "scatter_gather.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace bit {
+
+//! The number of bits of each coordinate in a 3D key.
+inline constexpr std::size_t morton_3d_width {21};
+
+namespace detail {
+
+//! The key type of 2D coordinates of type `T`.
+template <std::unsigned_integral T>
+    requires(sizeof(T) <= sizeof(std::uint32_t))
+using Morton2DKey = std::conditional_t<
+    sizeof(T) == sizeof(std::uint8_t), std::uint16_t,
+    std::conditional_t<sizeof(T) == sizeof(std::uint16_t), std::uint32_t, std::uint64_t>>;
+
+//! The coordinate type of 2D keys of type `Key`.
+template <std::unsigned_integral Key>
+    requires(sizeof(Key) >= sizeof(std::uint16_t))
+using Morton2DCoord = std::conditional_t<
+    sizeof(Key) == sizeof(std::uint16_t), std::uint8_t,
+    std::conditional_t<sizeof(Key) == sizeof(std::uint32_t), std::uint16_t, std::uint32_t>>;
+
+/**
+ * @brief The steps that spread the bits of a coordinate.
+ *
+ * @details
+ * Spreading keeps the bits in `masks[0]`,
+ * then each step `i` sets `val = (val | val << shifts[i]) & masks[i + 1]`.
+ * Gathering runs the steps backwards with right shifts.
+ */
+struct MortonSteps {
+    std::array<std::uint64_t, 6> masks;
+    std::array<std::size_t, 5> shifts;
+};
+
+//! Put each bit of a 32-bit coordinate in an even bit.
+inline constexpr MortonSteps morton_2d_steps {
+    {0x0000'0000'FFFF'FFFF, 0x0000'FFFF'0000'FFFF, 0x00FF'00FF'00FF'00FF, 0x0F0F'0F0F'0F0F'0F0F,
+     0x3333'3333'3333'3333, 0x5555'5555'5555'5555},
+    {16, 8, 4, 2, 1}};
+
+//! Put each bit of a 21-bit coordinate in every third bit.
+inline constexpr MortonSteps morton_3d_steps {
+    {0x0000'0000'001F'FFFF, 0x001F'0000'0000'FFFF, 0x001F'0000'FF00'00FF, 0x100F'00F0'0F00'F00F,
+     0x10C3'0C30'C30C'30C3, 0x1249'2492'4924'9249},
+    {32, 16, 8, 4, 2}};
+
+template <const MortonSteps& Steps>
+constexpr std::uint64_t SpreadBits(std::uint64_t val) noexcept {
+    val &= Steps.masks[0];
+    for (std::size_t i {0}; i != Steps.shifts.size(); ++i) {
+        val = (val | val << Steps.shifts[i]) & Steps.masks[i + 1];
+    }
+
+    return val;
+}
+
+template <const MortonSteps& Steps>
+constexpr std::uint64_t GatherBits(std::uint64_t val) noexcept {
+    val &= Steps.masks.back();
+    for (auto i {Steps.shifts.size()}; i != 0; --i) {
+        val = (val | val >> Steps.shifts[i - 1]) & Steps.masks[i - 1];
+    }
+
+    return val;
+}
+
+//! Whether `pdep` and `pext` run natively at runtime.
+constexpr bool UseFastPdep() noexcept {
+#if defined(BIT_MANIP_BMI2)
+    return !std::is_constant_evaluated() && GetCpuFeatures().fast_pdep;
+#else
+    return false;
+#endif
+}
+
+//! Spread the low bits of a coordinate to the bits selected by `mask`.
+template <const MortonSteps& Steps>
+constexpr std::uint64_t Spread(const std::uint64_t val, const std::uint64_t mask) noexcept {
+#if defined(BIT_MANIP_BMI2)
+    if (UseFastPdep()) {
+        return Pdep(val, mask);
+    }
+#endif
+    return SpreadBits<Steps>(val) << std::countr_zero(mask);
+}
+
+//! Gather the bits selected by `mask` of a key to the low bits.
+template <const MortonSteps& Steps>
+constexpr std::uint64_t Gather(const std::uint64_t key, const std::uint64_t mask) noexcept {
+#if defined(BIT_MANIP_BMI2)
+    if (UseFastPdep()) {
+        return Pext(key, mask);
+    }
+#endif
+    return GatherBits<Steps>(key >> std::countr_zero(mask));
+}
+
+template <std::size_t Dims>
+inline constexpr const MortonSteps& morton_steps {Dims == 2 ? morton_2d_steps : morton_3d_steps};
+
+#if defined(BIT_MANIP_DISPATCH)
+
+template <const MortonSteps& Steps>
+BIT_MANIP_TARGET_AVX2 inline __m256i SpreadBitsAvx2(__m256i val) noexcept {
+    val = _mm256_and_si256(val, _mm256_set1_epi64x(static_cast<long long>(Steps.masks[0])));
+    for (std::size_t i {0}; i != Steps.shifts.size(); ++i) {
+        const auto shift {_mm_cvtsi32_si128(static_cast<int>(Steps.shifts[i]))};
+        val = _mm256_and_si256(_mm256_or_si256(val, _mm256_sll_epi64(val, shift)),
+                               _mm256_set1_epi64x(static_cast<long long>(Steps.masks[i + 1])));
+    }
+
+    return val;
+}
+
+template <const MortonSteps& Steps>
+BIT_MANIP_TARGET_AVX2 inline __m256i GatherBitsAvx2(__m256i val) noexcept {
+    val = _mm256_and_si256(val, _mm256_set1_epi64x(static_cast<long long>(Steps.masks.back())));
+    for (auto i {Steps.shifts.size()}; i != 0; --i) {
+        const auto shift {_mm_cvtsi32_si128(static_cast<int>(Steps.shifts[i - 1]))};
+        val = _mm256_and_si256(_mm256_or_si256(val, _mm256_srl_epi64(val, shift)),
+                               _mm256_set1_epi64x(static_cast<long long>(Steps.masks[i - 1])));
+    }
+
+    return val;
+}
+
+/**
+ * @brief Encode keys of four points at once.
+ *
+ * @return The number of encoded keys.
+ */
+template <std::size_t Dims>
+BIT_MANIP_TARGET_AVX2 std::size_t MortonEncodeAvx2(
+    const std::array<const std::uint32_t*, Dims> coords, std::uint64_t* const keys,
+    const std::size_t size) noexcept {
+    std::size_t i {0};
+    for (; i + 4 <= size; i += 4) {
+        auto key {_mm256_setzero_si256()};
+        for (std::size_t dim {0}; dim != Dims; ++dim) {
+            const auto coord {_mm_loadu_si128(reinterpret_cast<const __m128i*>(coords[dim] + i))};
+            const auto spread {SpreadBitsAvx2<morton_steps<Dims>>(_mm256_cvtepu32_epi64(coord))};
+            const auto shift {_mm_cvtsi32_si128(static_cast<int>(dim))};
+            key = _mm256_or_si256(key, _mm256_sll_epi64(spread, shift));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(keys + i), key);
+    }
+
+    return i;
+}
+
+/**
+ * @brief Decode keys of four points at once.
+ *
+ * @return The number of decoded keys.
+ */
+template <std::size_t Dims>
+BIT_MANIP_TARGET_AVX2 std::size_t MortonDecodeAvx2(const std::uint64_t* const keys,
+                                                   const std::array<std::uint32_t*, Dims> coords,
+                                                   const std::size_t size) noexcept {
+    // Move the low dwords of the 64-bit lanes to the low half.
+    const auto low_dwords {_mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6)};
+    std::size_t i {0};
+    for (; i + 4 <= size; i += 4) {
+        const auto key {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i))};
+        for (std::size_t dim {0}; dim != Dims; ++dim) {
+            const auto shifted {_mm256_srl_epi64(key, _mm_cvtsi32_si128(static_cast<int>(dim)))};
+            const auto coord {_mm256_permutevar8x32_epi32(
+                GatherBitsAvx2<morton_steps<Dims>>(shifted), low_dwords)};
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(coords[dim] + i),
+                             _mm256_castsi256_si128(coord));
+        }
+    }
+
+    return i;
+}
+
+#endif
+
+template <std::size_t Dims>
+void MortonEncode(const std::array<std::span<const std::uint32_t>, Dims> coords,
+                  const std::span<std::uint64_t> keys) noexcept {
+    constexpr auto& steps {morton_steps<Dims>};
+    for (const auto coord : coords) {
+        assert(coord.size() == keys.size());
+    }
+
+    std::size_t i {0};
+#if defined(BIT_MANIP_DISPATCH)
+    if (GetCpuFeatures().avx2) {
+        std::array<const std::uint32_t*, Dims> data;
+        for (std::size_t dim {0}; dim != Dims; ++dim) {
+            data[dim] = coords[dim].data();
+        }
+
+        i = MortonEncodeAvx2<Dims>(data, keys.data(), keys.size());
+    }
+#endif
+    const bool fast_pdep {UseFastPdep()};
+    for (; i != keys.size(); ++i) {
+        std::uint64_t key {0};
+        for (std::size_t dim {0}; dim != Dims; ++dim) {
+            const auto mask {steps.masks.back() << dim};
+#if defined(BIT_MANIP_BMI2)
+            if (fast_pdep) {
+                key |= Pdep(static_cast<std::uint64_t>(coords[dim][i]), mask);
+                continue;
+            }
+#endif
+            key |= SpreadBits<steps>(coords[dim][i]) << dim;
+        }
+
+        keys[i] = key;
+    }
+}
+
+template <std::size_t Dims>
+void MortonDecode(const std::span<const std::uint64_t> keys,
+                  const std::array<std::span<std::uint32_t>, Dims> coords) noexcept {
+    constexpr auto& steps {morton_steps<Dims>};
+    for (const auto coord : coords) {
+        assert(coord.size() == keys.size());
+    }
+
+    std::size_t i {0};
+#if defined(BIT_MANIP_DISPATCH)
+    if (GetCpuFeatures().avx2) {
+        std::array<std::uint32_t*, Dims> data;
+        for (std::size_t dim {0}; dim != Dims; ++dim) {
+            data[dim] = coords[dim].data();
+        }
+
+        i = MortonDecodeAvx2<Dims>(keys.data(), data, keys.size());
+    }
+#endif
+    const bool fast_pdep {UseFastPdep()};
+    for (; i != keys.size(); ++i) {
+        for (std::size_t dim {0}; dim != Dims; ++dim) {
+            const auto mask {steps.masks.back() << dim};
+#if defined(BIT_MANIP_BMI2)
+            if (fast_pdep) {
+                coords[dim][i] = static_cast<std::uint32_t>(Pext(keys[i], mask));
+                continue;
+            }
+#endif
+            coords[dim][i] = static_cast<std::uint32_t>(GatherBits<steps>(keys[i] >> dim));
+        }
+    }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Interleave the bits of 2D coordinates into a key of twice their width.
+ *
+ * @details
+ * The bits of `x` go to the even bits and the bits of `y` go to the odd bits.
+ * For example, `MortonEncode2D<std::uint8_t>(0b11, 0b01)` is `0b0111`.
+ */
+template <std::unsigned_integral T>
+    requires(sizeof(T) <= sizeof(std::uint32_t))
+constexpr detail::Morton2DKey<T> MortonEncode2D(const T x,
+                                                const std::type_identity_t<T> y) noexcept {
+    constexpr auto& steps {detail::morton_2d_steps};
+    return static_cast<detail::Morton2DKey<T>>(
+        detail::Spread<steps>(x, steps.masks.back())
+        | detail::Spread<steps>(y, steps.masks.back() << 1));
+}
+
+//! Split a 2D key into its coordinates `{x, y}`.
+template <std::unsigned_integral Key>
+    requires(sizeof(Key) >= sizeof(std::uint16_t))
+constexpr std::array<detail::Morton2DCoord<Key>, 2> MortonDecode2D(const Key key) noexcept {
+    using Coord = detail::Morton2DCoord<Key>;
+    constexpr auto& steps {detail::morton_2d_steps};
+    return {static_cast<Coord>(detail::Gather<steps>(key, steps.masks.back())),
+            static_cast<Coord>(detail::Gather<steps>(key, steps.masks.back() << 1))};
+}
+
+/**
+ * @brief Interleave the bits of 3D coordinates into a key.
+ *
+ * @details
+ * Each coordinate must be below `2^21`.
+ * Bit `i` of `x`, `y` and `z` goes to bits `3i`, `3i + 1` and `3i + 2`.
+ */
+constexpr std::uint64_t MortonEncode3D(const std::uint32_t x, const std::uint32_t y,
+                                       const std::uint32_t z) noexcept {
+    assert(x < (1U << morton_3d_width) && y < (1U << morton_3d_width)
+           && z < (1U << morton_3d_width));
+    constexpr auto& steps {detail::morton_3d_steps};
+    return detail::Spread<steps>(x, steps.masks.back())
+           | detail::Spread<steps>(y, steps.masks.back() << 1)
+           | detail::Spread<steps>(z, steps.masks.back() << 2);
+}
+
+//! Split a 3D key into its coordinates `{x, y, z}`.
+constexpr std::array<std::uint32_t, 3> MortonDecode3D(const std::uint64_t key) noexcept {
+    constexpr auto& steps {detail::morton_3d_steps};
+    return {static_cast<std::uint32_t>(detail::Gather<steps>(key, steps.masks.back())),
+            static_cast<std::uint32_t>(detail::Gather<steps>(key, steps.masks.back() << 1)),
+            static_cast<std::uint32_t>(detail::Gather<steps>(key, steps.masks.back() << 2))};
+}
+
+/**
+ * @brief Encode the 2D keys of points whose coordinates are in separate spans.
+ *
+ * @details
+ * All spans must have the same size.
+ */
+inline void MortonEncode2D(const std::span<const std::uint32_t> xs,
+                           const std::span<const std::uint32_t> ys,
+                           const std::span<std::uint64_t> keys) noexcept {
+    detail::MortonEncode<2>({xs, ys}, keys);
+}
+
+//! Decode 2D keys into separate spans of coordinates of the same size.
+inline void MortonDecode2D(const std::span<const std::uint64_t> keys,
+                           const std::span<std::uint32_t> xs,
+                           const std::span<std::uint32_t> ys) noexcept {
+    detail::MortonDecode<2>(keys, {xs, ys});
+}
+
+/**
+ * @brief Encode the 3D keys of points whose coordinates are in separate spans.
+ *
+ * @details
+ * All spans must have the same size, and each coordinate must be below `2^21`.
+ */
+inline void MortonEncode3D(const std::span<const std::uint32_t> xs,
+                           const std::span<const std::uint32_t> ys,
+                           const std::span<const std::uint32_t> zs,
+                           const std::span<std::uint64_t> keys) noexcept {
+    detail::MortonEncode<3>({xs, ys, zs}, keys);
+}
+
+//! Decode 3D keys into separate spans of coordinates of the same size.
+inline void MortonDecode3D(const std::span<const std::uint64_t> keys,
+                           const std::span<std::uint32_t> xs, const std::span<std::uint32_t> ys,
+                           const std::span<std::uint32_t> zs) noexcept {
+    detail::MortonDecode<3>(keys, {xs, ys, zs});
+}
+
+}  // namespace bit
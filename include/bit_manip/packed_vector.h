@@ -0,0 +1,373 @@
+/**
+ * @file packed_vector.h
+ * @brief A vector of fixed-width unsigned integers packed without padding.
+ *
+ * @details
+ * Values are stored back to back in double words and may straddle a double word boundary.
+ * Every access loads the two double words around a value, combines them into a quad word
+ * and uses `GetBits` or `SetBits` on it, so no access needs a branch or more than two loads.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+
+#include <cassert>
+#include <climits>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace bit {
+
+//! A width that is chosen at runtime.
+inline constexpr std::size_t dynamic_width {0};
+
+/**
+ * @brief A vector of unsigned integers that each occupy `Width` bits.
+ *
+ * @tparam Width
+ * The number of bits per value, from 1 to 32, or `dynamic_width` to choose it at runtime.
+ */
+template <std::size_t Width = dynamic_width>
+class PackedVector {
+    static_assert(Width <= sizeof(std::uint32_t) * CHAR_BIT);
+
+public:
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    //! A proxy to a value that can be assigned.
+    class Reference {
+    public:
+        constexpr Reference(PackedVector& vec, const size_type idx) noexcept :
+            vec_ {&vec}, idx_ {idx} {}
+
+        constexpr Reference& operator=(const value_type val) noexcept {
+            vec_->Set(idx_, val);
+            return *this;
+        }
+
+        constexpr Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<value_type>(other);
+        }
+
+        constexpr operator value_type() const noexcept {
+            return std::as_const(*vec_).Get(idx_);
+        }
+
+    private:
+        PackedVector* vec_;
+        size_type idx_;
+    };
+
+    //! A random-access iterator over values.
+    class ConstIterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = PackedVector::value_type;
+        using difference_type = PackedVector::difference_type;
+
+        constexpr ConstIterator() noexcept = default;
+
+        constexpr ConstIterator(const PackedVector& vec, const size_type idx) noexcept :
+            vec_ {&vec}, idx_ {idx} {}
+
+        constexpr value_type operator*() const noexcept {
+            return vec_->Get(idx_);
+        }
+
+        constexpr value_type operator[](const difference_type offset) const noexcept {
+            return vec_->Get(idx_ + offset);
+        }
+
+        constexpr ConstIterator& operator++() noexcept {
+            ++idx_;
+            return *this;
+        }
+
+        constexpr ConstIterator operator++(int) noexcept {
+            auto old {*this};
+            ++idx_;
+            return old;
+        }
+
+        constexpr ConstIterator& operator--() noexcept {
+            --idx_;
+            return *this;
+        }
+
+        constexpr ConstIterator operator--(int) noexcept {
+            auto old {*this};
+            --idx_;
+            return old;
+        }
+
+        constexpr ConstIterator& operator+=(const difference_type offset) noexcept {
+            idx_ += offset;
+            return *this;
+        }
+
+        constexpr ConstIterator& operator-=(const difference_type offset) noexcept {
+            idx_ -= offset;
+            return *this;
+        }
+
+        friend constexpr ConstIterator operator+(ConstIterator it,
+                                                 const difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend constexpr ConstIterator operator+(const difference_type offset,
+                                                 ConstIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend constexpr ConstIterator operator-(ConstIterator it,
+                                                 const difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend constexpr difference_type operator-(const ConstIterator& lhs,
+                                                   const ConstIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.idx_) - static_cast<difference_type>(rhs.idx_);
+        }
+
+        friend constexpr bool operator==(const ConstIterator& lhs,
+                                         const ConstIterator& rhs) noexcept {
+            return lhs.idx_ == rhs.idx_;
+        }
+
+        friend constexpr auto operator<=>(const ConstIterator& lhs,
+                                          const ConstIterator& rhs) noexcept {
+            return lhs.idx_ <=> rhs.idx_;
+        }
+
+    private:
+        const PackedVector* vec_ {nullptr};
+        size_type idx_ {0};
+    };
+
+    using reference = Reference;
+    using const_reference = value_type;
+    using const_iterator = ConstIterator;
+    using iterator = ConstIterator;
+
+    constexpr PackedVector()
+        requires(Width != dynamic_width)
+    = default;
+
+    //! Create a vector of `size` values equal to `val`.
+    constexpr explicit PackedVector(const size_type size, const value_type val = 0)
+        requires(Width != dynamic_width)
+    {
+        assign(size, val);
+    }
+
+    //! Create an empty vector whose values occupy `width` bits.
+    constexpr explicit PackedVector(const std::size_t width) noexcept
+        requires(Width == dynamic_width)
+        : width_ {width} {
+        assert(width > 0 && width <= sizeof(value_type) * CHAR_BIT);
+    }
+
+    //! Create a vector of `size` values equal to `val` that each occupy `width` bits.
+    constexpr PackedVector(const std::size_t width, const size_type size, const value_type val = 0)
+        requires(Width == dynamic_width)
+        : PackedVector(width) {
+        assign(size, val);
+    }
+
+    //! The number of bits per value.
+    constexpr std::size_t width() const noexcept {
+        if constexpr (Width == dynamic_width) {
+            return width_;
+        } else {
+            return Width;
+        }
+    }
+
+    constexpr size_type size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    constexpr size_type capacity() const noexcept {
+        return words_.capacity() > 0 ? (words_.capacity() - 1) * word_width / width() : 0;
+    }
+
+    //! The number of bytes used by the packed storage.
+    constexpr size_type memory_size() const noexcept {
+        return words_.size() * sizeof(std::uint32_t);
+    }
+
+    constexpr void reserve(const size_type size) {
+        words_.reserve(WordCount(size));
+    }
+
+    constexpr void clear() {
+        words_.assign(1, 0);
+        size_ = 0;
+    }
+
+    //! Resize the vector. New values are set to `val`.
+    constexpr void resize(const size_type size, const value_type val = 0) {
+        const auto old_size {size_};
+        words_.resize(WordCount(size));
+        size_ = size;
+        if (size < old_size) {
+            // Keep the storage after the last value cleared for later growth.
+            ClearTail();
+        } else if (val != 0) {
+            for (auto i {old_size}; i != size; ++i) {
+                Set(i, val);
+            }
+        }
+    }
+
+    constexpr void assign(const size_type size, const value_type val) {
+        clear();
+        resize(size, val);
+    }
+
+    constexpr void push_back(const value_type val) {
+        if (WordCount(size_ + 1) > words_.size()) {
+            words_.resize(WordCount(size_ + 1));
+        }
+
+        Set(size_++, val);
+    }
+
+    constexpr void pop_back() noexcept {
+        assert(!empty());
+        Set(size_ - 1, 0);
+        --size_;
+    }
+
+    constexpr value_type operator[](const size_type idx) const noexcept {
+        return Get(idx);
+    }
+
+    constexpr Reference operator[](const size_type idx) noexcept {
+        return {*this, idx};
+    }
+
+    constexpr value_type front() const noexcept {
+        return Get(0);
+    }
+
+    constexpr value_type back() const noexcept {
+        return Get(size_ - 1);
+    }
+
+    constexpr ConstIterator begin() const noexcept {
+        return {*this, 0};
+    }
+
+    constexpr ConstIterator end() const noexcept {
+        return {*this, size_};
+    }
+
+    //! Get a value.
+    constexpr value_type Get(const size_type idx) const noexcept {
+        assert(idx < size_);
+        const auto pos {idx * width()};
+        const auto word {pos / word_width};
+        const auto combined {CombineDwords(words_[word + 1], words_[word])};
+        return static_cast<value_type>(GetBits(combined, pos % word_width, width()));
+    }
+
+    //! Set a value. Bits that do not fit in the width are dropped.
+    constexpr void Set(const size_type idx, const value_type val) noexcept {
+        assert(idx < size_);
+        const auto pos {idx * width()};
+        const auto word {pos / word_width};
+        auto combined {CombineDwords(words_[word + 1], words_[word])};
+        SetBits(combined, val, pos % word_width, width());
+        words_[word] = GetLowDword(combined);
+        words_[word + 1] = GetHighDword(combined);
+    }
+
+    /**
+     * @brief Unpack consecutive values starting at `first` into a span.
+     *
+     * @details
+     * It decodes `out.size()` values without per-value division.
+     * A compile-time width also unrolls groups of 32 values with constant shifts.
+     */
+    constexpr void Unpack(const std::span<value_type> out,
+                          const size_type first = 0) const noexcept {
+        assert(first + out.size() <= size_);
+        size_type i {0};
+        if constexpr (Width != dynamic_width) {
+            // A group of 32 values starts at a double word boundary.
+            constexpr size_type group {word_width};
+            for (; i != out.size() && (first + i) % group != 0; ++i) {
+                out[i] = Get(first + i);
+            }
+
+            for (; i + group <= out.size(); i += group) {
+                const auto* const words {words_.data() + (first + i) / group * Width};
+                UnpackGroup(words, out.data() + i, std::make_index_sequence<group> {});
+            }
+        }
+
+        auto pos {(first + i) * width()};
+        for (; i < out.size(); ++i, pos += width()) {
+            const auto word {pos / word_width};
+            const auto combined {CombineDwords(words_[word + 1], words_[word])};
+            out[i] = static_cast<value_type>(GetBits(combined, pos % word_width, width()));
+        }
+    }
+
+    friend constexpr bool operator==(const PackedVector& lhs, const PackedVector& rhs) noexcept {
+        return lhs.width() == rhs.width() && lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
+    }
+
+private:
+    static constexpr std::size_t word_width {sizeof(std::uint32_t) * CHAR_BIT};
+
+    //! The number of double words for `size` values, including one padding double word.
+    constexpr size_type WordCount(const size_type size) const noexcept {
+        return (size * width() + word_width - 1) / word_width + 1;
+    }
+
+    constexpr void ClearTail() noexcept {
+        const auto end {size_ * width()};
+        const auto word {end / word_width};
+        ClearBits(words_[word], end % word_width, word_width - end % word_width);
+        for (auto i {word + 1}; i < words_.size(); ++i) {
+            words_[i] = 0;
+        }
+    }
+
+    template <size_type... Idx>
+    static constexpr void UnpackGroup(const std::uint32_t* const words, value_type* const out,
+                                      std::index_sequence<Idx...>) noexcept {
+        ((out[Idx] = static_cast<value_type>(
+              GetBits(CombineDwords(words[Idx * Width / word_width + 1],
+                                    words[Idx * Width / word_width]),
+                      Idx * Width % word_width, Width))),
+         ...);
+    }
+
+    std::vector<std::uint32_t> words_ {0};
+    size_type size_ {0};
+    [[no_unique_address]] std::conditional_t<Width == dynamic_width, std::size_t, std::monostate>
+        width_ {};
+};
+
+}  // namespace bit
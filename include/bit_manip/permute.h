@@ -0,0 +1,474 @@
+/**
+ * @file permute.h
+ * @brief Bit reversal, nibble swapping and arbitrary bit permutations.
+ *
+ * @details
+ * Reversing bits swaps the bytes first, then swaps nibbles, bit pairs and bits in each byte.
+ * An arbitrary permutation is routed through a Beneš network once at construction,
+ * so applying it takes `2 * log2(width) - 1` delta swaps without branches or tables.
+ *
+ * Bulk versions reverse bits with a GFNI affine transform or with nibble lookups in byte shuffles,
+ * and apply permutations with AVX2 delta swaps when the CPU supports them.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "dispatch.h"
+#include "endian.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace bit {
+
+namespace detail {
+
+//! Repeat a byte across an integral value.
+template <std::integral T>
+constexpr std::make_unsigned_t<T> RepeatByte(const std::uint8_t byte) noexcept {
+    using Bits = std::make_unsigned_t<T>;
+    return static_cast<Bits>(static_cast<Bits>(~Bits {0}) / 0xFF * byte);
+}
+
+//! Swap each group of `Shift` bits selected by `mask` with the group above it.
+template <std::size_t Shift, std::unsigned_integral T>
+constexpr T SwapGroups(const T val, const T mask) noexcept {
+    return static_cast<T>(((val >> Shift) & mask) | ((val & mask) << Shift));
+}
+
+//! Swap each bit selected by `mask` with the bit `shift` positions above it.
+template <std::unsigned_integral T>
+constexpr T DeltaSwap(const T val, const T mask, const std::size_t shift) noexcept {
+    const auto diff {static_cast<T>(((val >> shift) ^ val) & mask)};
+    return static_cast<T>(val ^ diff ^ (diff << shift));
+}
+
+}  // namespace detail
+
+//! Reverse the bits of an integral value.
+template <std::integral T>
+constexpr T ReverseBits(const T val) noexcept {
+    using Bits = std::make_unsigned_t<T>;
+    auto bits {static_cast<Bits>(ByteSwap(val))};
+    bits = detail::SwapGroups<4>(bits, detail::RepeatByte<T>(0x0F));
+    bits = detail::SwapGroups<2>(bits, detail::RepeatByte<T>(0x33));
+    bits = detail::SwapGroups<1>(bits, detail::RepeatByte<T>(0x55));
+    return static_cast<T>(bits);
+}
+
+//! Swap the low and high nibbles of each byte in an integral value.
+template <std::integral T>
+constexpr T SwapNibbles(const T val) noexcept {
+    using Bits = std::make_unsigned_t<T>;
+    return static_cast<T>(
+        detail::SwapGroups<4>(static_cast<Bits>(val), detail::RepeatByte<T>(0x0F)));
+}
+
+namespace detail {
+
+//! The reversed bits of each nibble value, shifted to the low or high nibble of a byte.
+template <std::size_t Shift>
+inline constexpr auto reversed_nibbles {[] {
+    alignas(16) std::array<std::uint8_t, 16> nibbles {};
+    for (std::size_t i {0}; i != nibbles.size(); ++i) {
+        nibbles[i] = static_cast<std::uint8_t>(ReverseBits(static_cast<std::uint8_t>(i)) >> 4
+                                               << Shift);
+    }
+
+    return nibbles;
+}()};
+
+#if defined(BIT_MANIP_SSSE3)
+
+/**
+ * @brief Reverse the bits of `Size`-byte values in whole 16-byte vectors with SSSE3.
+ *
+ * @return The number of processed values.
+ */
+template <std::size_t Size>
+BIT_MANIP_TARGET_SSSE3 std::size_t ReverseBitsSsse3(const void* const vals, void* const out,
+                                                    const std::size_t size) noexcept {
+    constexpr std::size_t lanes {sizeof(__m128i) / Size};
+    const auto bytes {
+        _mm_load_si128(reinterpret_cast<const __m128i*>(byte_swap_lanes<Size>.data()))};
+    const auto to_low {
+        _mm_load_si128(reinterpret_cast<const __m128i*>(reversed_nibbles<0>.data()))};
+    const auto to_high {
+        _mm_load_si128(reinterpret_cast<const __m128i*>(reversed_nibbles<4>.data()))};
+    const auto nibble_mask {_mm_set1_epi8(0x0F)};
+    const auto* const src {static_cast<const __m128i*>(vals)};
+    auto* const dest {static_cast<__m128i*>(out)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm_shuffle_epi8(_mm_loadu_si128(src + i / lanes), bytes)};
+        const auto low {_mm_and_si128(val, nibble_mask)};
+        const auto high {_mm_and_si128(_mm_srli_epi16(val, 4), nibble_mask)};
+        _mm_storeu_si128(dest + i / lanes, _mm_or_si128(_mm_shuffle_epi8(to_high, low),
+                                                        _mm_shuffle_epi8(to_low, high)));
+    }
+
+    return i;
+}
+
+#endif
+
+#if defined(BIT_MANIP_DISPATCH)
+
+/**
+ * @brief Reverse the bits of `Size`-byte values in whole 32-byte vectors with AVX2.
+ *
+ * @return The number of processed values.
+ */
+template <std::size_t Size>
+BIT_MANIP_TARGET_AVX2 std::size_t ReverseBitsAvx2(const void* const vals, void* const out,
+                                                  const std::size_t size) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i) / Size};
+    const auto bytes {_mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(byte_swap_lanes<Size>.data())))};
+    const auto to_low {_mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(reversed_nibbles<0>.data())))};
+    const auto to_high {_mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(reversed_nibbles<4>.data())))};
+    const auto nibble_mask {_mm256_set1_epi8(0x0F)};
+    const auto* const src {static_cast<const __m256i*>(vals)};
+    auto* const dest {static_cast<__m256i*>(out)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm256_shuffle_epi8(_mm256_loadu_si256(src + i / lanes), bytes)};
+        const auto low {_mm256_and_si256(val, nibble_mask)};
+        const auto high {_mm256_and_si256(_mm256_srli_epi16(val, 4), nibble_mask)};
+        _mm256_storeu_si256(dest + i / lanes,
+                            _mm256_or_si256(_mm256_shuffle_epi8(to_high, low),
+                                            _mm256_shuffle_epi8(to_low, high)));
+    }
+
+    return i;
+}
+
+/**
+ * @brief Reverse the bits of `Size`-byte values in whole 32-byte vectors with GFNI.
+ *
+ * @details
+ * An affine transform with an anti-diagonal bit matrix reverses the bits of each byte.
+ *
+ * @return The number of processed values.
+ */
+template <std::size_t Size>
+BIT_MANIP_TARGET_GFNI std::size_t ReverseBitsGfni(const void* const vals, void* const out,
+                                                  const std::size_t size) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i) / Size};
+    const auto bytes {_mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(byte_swap_lanes<Size>.data())))};
+    const auto matrix {_mm256_set1_epi64x(0x8040201008040201)};
+    const auto* const src {static_cast<const __m256i*>(vals)};
+    auto* const dest {static_cast<__m256i*>(out)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm256_shuffle_epi8(_mm256_loadu_si256(src + i / lanes), bytes)};
+        _mm256_storeu_si256(dest + i / lanes, _mm256_gf2p8affine_epi64_epi8(val, matrix, 0));
+    }
+
+    return i;
+}
+
+/**
+ * @brief Swap the nibbles of each byte in whole 32-byte vectors with AVX2.
+ *
+ * @return The number of processed bytes.
+ */
+BIT_MANIP_TARGET_AVX2 inline std::size_t SwapNibblesAvx2(const void* const vals, void* const out,
+                                                         const std::size_t size) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i)};
+    const auto nibble_mask {_mm256_set1_epi8(0x0F)};
+    const auto* const src {static_cast<const __m256i*>(vals)};
+    auto* const dest {static_cast<__m256i*>(out)};
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        const auto val {_mm256_loadu_si256(src + i / lanes)};
+        const auto low {_mm256_slli_epi16(_mm256_and_si256(val, nibble_mask), 4)};
+        const auto high {_mm256_and_si256(_mm256_srli_epi16(val, 4), nibble_mask)};
+        _mm256_storeu_si256(dest + i / lanes, _mm256_or_si256(low, high));
+    }
+
+    return i;
+}
+
+/**
+ * @brief Apply delta swaps to values in whole 32-byte vectors with AVX2.
+ *
+ * @details
+ * Byte lanes are shifted as 16-bit lanes.
+ * The masks only select bits whose partners are in the same byte, so no bits cross lanes.
+ *
+ * @return The number of processed values.
+ */
+template <std::unsigned_integral T, std::size_t Stages>
+BIT_MANIP_TARGET_AVX2 std::size_t DeltaSwapAvx2(const std::array<T, Stages>& masks,
+                                                const std::array<std::uint8_t, Stages>& shifts,
+                                                const T* const vals, T* const out,
+                                                const std::size_t size) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i) / sizeof(T)};
+    __m256i vec_masks[Stages];
+    __m128i counts[Stages];
+    for (std::size_t stage {0}; stage != Stages; ++stage) {
+        if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+            vec_masks[stage] = _mm256_set1_epi64x(static_cast<long long>(masks[stage]));
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            vec_masks[stage] = _mm256_set1_epi32(static_cast<int>(masks[stage]));
+        } else if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+            vec_masks[stage] = _mm256_set1_epi16(static_cast<short>(masks[stage]));
+        } else {
+            vec_masks[stage] = _mm256_set1_epi8(static_cast<char>(masks[stage]));
+        }
+
+        counts[stage] = _mm_cvtsi32_si128(shifts[stage]);
+    }
+
+    std::size_t i {0};
+    for (; i + lanes <= size; i += lanes) {
+        auto val {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals + i))};
+        for (std::size_t stage {0}; stage != Stages; ++stage) {
+            __m256i shifted;
+            if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+                shifted = _mm256_srl_epi64(val, counts[stage]);
+            } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+                shifted = _mm256_srl_epi32(val, counts[stage]);
+            } else {
+                shifted = _mm256_srl_epi16(val, counts[stage]);
+            }
+
+            const auto diff {_mm256_and_si256(_mm256_xor_si256(shifted, val), vec_masks[stage])};
+            if constexpr (sizeof(T) == sizeof(std::uint64_t)) {
+                shifted = _mm256_sll_epi64(diff, counts[stage]);
+            } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+                shifted = _mm256_sll_epi32(diff, counts[stage]);
+            } else {
+                shifted = _mm256_sll_epi16(diff, counts[stage]);
+            }
+
+            val = _mm256_xor_si256(val, _mm256_xor_si256(diff, shifted));
+        }
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), val);
+    }
+
+    return i;
+}
+
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Reverse the bits of each integral value of a span.
+ *
+ * @details
+ * `out[i]` receives `ReverseBits(vals[i])`.
+ * `out` must be at least as large as `vals` and may alias it exactly.
+ */
+template <std::integral T>
+void ReverseBits(const std::span<const std::type_identity_t<T>> vals,
+                 const std::span<T> out) noexcept {
+    assert(out.size() >= vals.size());
+    std::size_t i {0};
+#if defined(BIT_MANIP_DISPATCH)
+    if (const auto& cpu {GetCpuFeatures()}; cpu.avx2 && cpu.gfni) {
+        i = detail::ReverseBitsGfni<sizeof(T)>(vals.data(), out.data(), vals.size());
+    } else if (cpu.avx2) {
+        i = detail::ReverseBitsAvx2<sizeof(T)>(vals.data(), out.data(), vals.size());
+    }
+#endif
+#if defined(BIT_MANIP_SSSE3)
+    if (detail::CanUseSsse3()) {
+        i += detail::ReverseBitsSsse3<sizeof(T)>(vals.data() + i, out.data() + i,
+                                                 vals.size() - i);
+    }
+#endif
+    for (; i != vals.size(); ++i) {
+        out[i] = ReverseBits(vals[i]);
+    }
+}
+
+//! Reverse the bits of each integral value of a span in place.
+template <std::integral T>
+void ReverseBits(const std::span<T> vals) noexcept {
+    ReverseBits<T>(vals, vals);
+}
+
+/**
+ * @brief Swap the nibbles of each byte in each integral value of a span.
+ *
+ * @details
+ * `out[i]` receives `SwapNibbles(vals[i])`.
+ * `out` must be at least as large as `vals` and may alias it exactly.
+ */
+template <std::integral T>
+void SwapNibbles(const std::span<const std::type_identity_t<T>> vals,
+                 const std::span<T> out) noexcept {
+    assert(out.size() >= vals.size());
+    std::size_t i {0};
+#if defined(BIT_MANIP_DISPATCH)
+    if (GetCpuFeatures().avx2) {
+        i = detail::SwapNibblesAvx2(vals.data(), out.data(), vals.size_bytes()) / sizeof(T);
+    }
+#endif
+    for (; i != vals.size(); ++i) {
+        out[i] = SwapNibbles(vals[i]);
+    }
+}
+
+//! Swap the nibbles of each byte in each integral value of a span in place.
+template <std::integral T>
+void SwapNibbles(const std::span<T> vals) noexcept {
+    SwapNibbles<T>(vals, vals);
+}
+
+/**
+ * @brief An arbitrary permutation of the bits in unsigned integral values.
+ *
+ * @details
+ * The permutation is routed through a Beneš network with the looping algorithm.
+ * The network is a sequence of delta swaps with distances `width / 2`, ..., `2`, `1`, `2`, ...,
+ * `width / 2`, and each swap exchanges the bits selected by its mask with the bits above them.
+ */
+template <std::unsigned_integral T>
+class BitPermutation {
+public:
+    static constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+
+    //! The number of delta swaps.
+    static constexpr std::size_t stage_count {2 * std::bit_width(width) - 3};
+
+    //! The source index of each bit.
+    using Sources = std::array<std::uint8_t, width>;
+
+    //! The distance of each delta swap.
+    static constexpr auto shifts {[] {
+        constexpr auto middle {stage_count / 2};
+        std::array<std::uint8_t, stage_count> dists {};
+        for (std::size_t stage {0}; stage != stage_count; ++stage) {
+            dists[stage] = static_cast<std::uint8_t>(
+                1U << (stage < middle ? middle - stage : stage - middle));
+        }
+
+        return dists;
+    }()};
+
+    /**
+     * @brief Route a permutation.
+     *
+     * @param sources Bit `i` of a permuted value is bit `sources[i]` of the original value.
+     * Indices must be distinct and less than `width`.
+     */
+    constexpr explicit BitPermutation(const Sources& sources) noexcept {
+        Route(sources, 0, width);
+    }
+
+    //! Permute the bits of a value.
+    constexpr T operator()(T val) const noexcept {
+        for (std::size_t stage {0}; stage != stage_count; ++stage) {
+            val = detail::DeltaSwap(val, masks_[stage], shifts[stage]);
+        }
+
+        return val;
+    }
+
+    /**
+     * @brief Permute the bits of each value of a span.
+     *
+     * @details
+     * `out` must be at least as large as `vals` and may alias it exactly.
+     */
+    void operator()(const std::span<const T> vals, const std::span<T> out) const noexcept {
+        assert(out.size() >= vals.size());
+        std::size_t i {0};
+#if defined(BIT_MANIP_DISPATCH)
+        if (GetCpuFeatures().avx2) {
+            i = detail::DeltaSwapAvx2(masks_, shifts, vals.data(), out.data(), vals.size());
+        }
+#endif
+        std::ranges::transform(vals.subspan(i), out.begin() + i,
+                               [this](const T val) noexcept { return (*this)(val); });
+    }
+
+private:
+    /**
+     * @brief Route the sub-network of `size` bits from `offset`.
+     *
+     * @details
+     * The outer swaps exchange bit `i` with bit `i + size / 2`.
+     * They split the bits between a low and a high sub-network of half the size,
+     * and each pair of inputs and each pair of outputs must use both sub-networks.
+     * Following these constraints around each cycle decides all swaps of the level.
+     *
+     * @param sources Bit `offset + i` takes bit `offset + sources[i]` of the sub-network input.
+     */
+    constexpr void Route(const Sources& sources, const std::size_t offset,
+                         const std::size_t size) noexcept {
+        const auto middle {stage_count / 2};
+        if (size == 2) {
+            if (sources[0] != 0) {
+                SetBit(masks_[middle], offset);
+            }
+
+            return;
+        }
+
+        const auto half {size / 2};
+        const auto level {static_cast<std::size_t>(std::countr_zero(half))};
+        auto& in_mask {masks_[middle - level]};
+        auto& out_mask {masks_[middle + level]};
+
+        Sources dests {};
+        for (std::size_t i {0}; i != size; ++i) {
+            dests[sources[i]] = static_cast<std::uint8_t>(i);
+        }
+
+        Sources low {};
+        Sources high {};
+        std::array<bool, width / 2> routed {};
+        for (std::size_t start {0}; start != half; ++start) {
+            // Take the output at `pos` from the low sub-network.
+            auto pos {start};
+            while (!routed[pos % half]) {
+                const auto pair {pos % half};
+                routed[pair] = true;
+                if (pos >= half) {
+                    SetBit(out_mask, offset + pair);
+                }
+
+                const auto src {sources[pos]};
+                const auto in_pair {static_cast<std::uint8_t>(src % half)};
+                if (src >= half) {
+                    SetBit(in_mask, offset + in_pair);
+                }
+
+                low[pair] = in_pair;
+                // The other input of the pair goes through the high sub-network,
+                // so the other output of its destination pair comes from the low one.
+                const auto partner_dest {dests[src ^ half]};
+                high[partner_dest % half] = in_pair;
+                pos = partner_dest ^ half;
+            }
+        }
+
+        Route(low, offset, half);
+        Route(high, offset + half, half);
+    }
+
+    std::array<T, stage_count> masks_ {};
+};
+
+}  // namespace bit
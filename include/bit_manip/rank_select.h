@@ -0,0 +1,303 @@
+/**
+ * @file rank_select.h
+ * @brief A succinct rank and select index over bit arrays.
+ *
+ * @details
+ * The index follows the cache-line interleaved layout of *poppy*.
+ * Each 2048-bit block has one quad word holding the number of set bits before the block
+ * within its 2^32-bit superblock and the counts of its first three 512-bit sub-blocks.
+ * Select samples the block of every 8192nd set bit and every 8192nd cleared bit.
+ * The index takes about 3.2% of the bit array plus at most 0.8% for the samples.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "bitset.h"
+#include "bulk.h"
+#include "scatter_gather.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace bit {
+
+/**
+ * @brief Find the index of the set bit with a given rank in a quad word.
+ *
+ * @param word A quad word with more than `rank` set bits.
+ * @param rank The number of set bits before the one to find.
+ */
+constexpr std::size_t SelectInWord(std::uint64_t word, std::size_t rank) noexcept {
+    assert(rank < static_cast<std::size_t>(std::popcount(word)));
+#if defined(BIT_MANIP_BMI2)
+    // `pdep` moves a single bit to the position of the set bit with the rank.
+    if (!std::is_constant_evaluated() && GetCpuFeatures().fast_pdep) {
+        const auto bit {detail::Pdep(std::uint64_t {1} << rank, word)};
+        return static_cast<std::size_t>(std::countr_zero(bit));
+    }
+#endif
+    // Sum the set bits of bytes to skip whole bytes before scanning one.
+    std::size_t begin {0};
+    for (;; begin += CHAR_BIT) {
+        const auto count {
+            static_cast<std::size_t>(std::popcount(GetBits(word, begin, CHAR_BIT)))};
+        if (rank < count) {
+            break;
+        }
+
+        rank -= count;
+    }
+
+    word = GetBits(word, begin, CHAR_BIT);
+    for (; rank != 0; --rank) {
+        word &= word - 1;
+    }
+
+    return begin + static_cast<std::size_t>(std::countr_zero(word));
+}
+
+/**
+ * @brief A rank and select index over a bit array stored in quad words.
+ *
+ * @details
+ * Bit `i` is `IsBitSet(words[i / 64], i % 64)`.
+ * The index refers to the words without copying them,
+ * so they must outlive it and stay unchanged.
+ * Bits beyond the size must be cleared.
+ */
+class RankSelect {
+public:
+    using size_type = std::size_t;
+
+    //! The index returned when no bit is found.
+    static constexpr size_type npos {static_cast<size_type>(-1)};
+
+    RankSelect() noexcept = default;
+
+    //! Build an index over the first `size` bits of `words`.
+    RankSelect(const std::span<const std::uint64_t> words, const size_type size) :
+        words_ {words.first((size + word_width - 1) / word_width)}, size_ {size} {
+        Build();
+    }
+
+    //! Build an index over a bitset.
+    explicit RankSelect(const Bitset& bits) : RankSelect(bits.words(), bits.size()) {}
+
+    constexpr size_type size() const noexcept {
+        return size_;
+    }
+
+    //! The number of set bits.
+    constexpr size_type ones() const noexcept {
+        return ones_;
+    }
+
+    //! The number of bytes used by the index, excluding the bit array.
+    size_type memory_size() const noexcept {
+        return (superblocks_.size() + blocks_.size() + samples_.size() + zero_samples_.size())
+               * sizeof(std::uint64_t);
+    }
+
+    //! Count the set bits before `idx`.
+    size_type Rank1(const size_type idx) const noexcept {
+        assert(idx <= size_);
+        if (idx == size_) {
+            return ones_;
+        }
+
+        const auto block {idx / block_width};
+        const auto sub {idx % block_width / sub_width};
+        auto rank {BlockRank(block)};
+        for (std::size_t i {0}; i != sub; ++i) {
+            rank += SubCount(block, i);
+        }
+
+        const auto word {idx / word_width};
+        for (auto i {block * block_words + sub * sub_words}; i != word; ++i) {
+            rank += static_cast<size_type>(std::popcount(words_[i]));
+        }
+
+        const auto last {GetBits(words_[word], 0, idx % word_width)};
+        return rank + static_cast<size_type>(std::popcount(last));
+    }
+
+    //! Count the cleared bits before `idx`.
+    size_type Rank0(const size_type idx) const noexcept {
+        return idx - Rank1(idx);
+    }
+
+    //! Find the set bit with `rank` set bits before it, or `npos` if there are too few.
+    size_type Select1(const size_type rank) const noexcept {
+        return Select<true>(rank);
+    }
+
+    //! Find the cleared bit with `rank` cleared bits before it, or `npos` if there are too few.
+    size_type Select0(const size_type rank) const noexcept {
+        return Select<false>(rank);
+    }
+
+private:
+    static constexpr std::size_t word_width {sizeof(std::uint64_t) * CHAR_BIT};
+    static constexpr std::size_t block_width {2048};
+    static constexpr std::size_t sub_width {512};
+    static constexpr std::size_t block_words {block_width / word_width};
+    static constexpr std::size_t sub_words {sub_width / word_width};
+    static constexpr std::size_t subs_per_block {block_width / sub_width};
+    static constexpr std::size_t blocks_per_superblock {(std::size_t {1} << 32) / block_width};
+    static constexpr std::size_t sample_rate {8192};
+
+    //! The bits of a block entry holding the relative rank of the block.
+    static constexpr std::size_t rank_bits {32};
+
+    //! The bits of a block entry holding the count of a sub-block.
+    static constexpr std::size_t count_bits {10};
+
+    //! The number of set bits before a block.
+    size_type BlockRank(const size_type block) const noexcept {
+        return static_cast<size_type>(superblocks_[block / blocks_per_superblock]
+                                      + GetBits(blocks_[block], 0, rank_bits));
+    }
+
+    //! The number of set bits in one of the first three sub-blocks of a block.
+    size_type SubCount(const size_type block, const size_type sub) const noexcept {
+        return static_cast<size_type>(
+            GetBits(blocks_[block], rank_bits + sub * count_bits, count_bits));
+    }
+
+    //! The number of set bits in a sub-block. Words beyond the array count as zero.
+    size_type CountSub(const size_type block, const size_type sub) const noexcept {
+        const auto begin {std::min(block * block_words + sub * sub_words, words_.size())};
+        const auto end {std::min(begin + sub_words, words_.size())};
+        return detail::PopcountWords(words_.data() + begin, end - begin);
+    }
+
+    //! The number of bits equal to `One` before a block.
+    template <bool One>
+    size_type BlockRank(const size_type block) const noexcept {
+        const auto ones {BlockRank(block)};
+        return One ? ones : block * block_width - ones;
+    }
+
+    //! The number of bits equal to `One` in one of the first three sub-blocks of a block.
+    template <bool One>
+    size_type SubCount(const size_type block, const size_type sub) const noexcept {
+        const auto ones {SubCount(block, sub)};
+        return One ? ones : sub_width - ones;
+    }
+
+    /**
+     * @brief Find the bit equal to `One` with `rank` such bits before it.
+     *
+     * @details
+     * The sampled blocks bound a binary search for the block holding the bit.
+     * Then sub-block counts and word population counts narrow it down to a word.
+     * Only bits before the result are visited, so padding bits never count as cleared bits.
+     */
+    template <bool One>
+    size_type Select(const size_type rank) const noexcept {
+        const auto total {One ? ones_ : size_ - ones_};
+        if (rank >= total) {
+            return npos;
+        }
+
+        const auto& samples {One ? samples_ : zero_samples_};
+        auto low {static_cast<size_type>(samples[rank / sample_rate])};
+        auto high {rank / sample_rate + 1 < samples.size()
+                       ? static_cast<size_type>(samples[rank / sample_rate + 1])
+                       : blocks_.size() - 1};
+        while (low < high) {
+            const auto mid {low + (high - low + 1) / 2};
+            if (BlockRank<One>(mid) <= rank) {
+                low = mid;
+            } else {
+                high = mid - 1;
+            }
+        }
+
+        auto remain {rank - BlockRank<One>(low)};
+        std::size_t sub {0};
+        for (; sub != subs_per_block - 1; ++sub) {
+            const auto count {SubCount<One>(low, sub)};
+            if (remain < count) {
+                break;
+            }
+
+            remain -= count;
+        }
+
+        auto word {low * block_words + sub * sub_words};
+        for (;; ++word) {
+            const auto bits {One ? words_[word] : ~words_[word]};
+            const auto count {static_cast<size_type>(std::popcount(bits))};
+            if (remain < count) {
+                return word * word_width + SelectInWord(bits, remain);
+            }
+
+            remain -= count;
+        }
+    }
+
+    //! Add a sample for each multiple of the sample rate from `before` to `before + count`.
+    static void Sample(std::vector<std::uint64_t>& samples, const size_type before,
+                       const size_type count, const size_type block) {
+        for (auto next {(before + sample_rate - 1) / sample_rate * sample_rate};
+             next < before + count; next += sample_rate) {
+            samples.push_back(block);
+        }
+    }
+
+    void Build() {
+        const auto block_count {(size_ + block_width - 1) / block_width};
+        blocks_.resize(block_count);
+        superblocks_.resize((block_count + blocks_per_superblock - 1) / blocks_per_superblock);
+
+        size_type total {0};
+        for (size_type block {0}; block != block_count; ++block) {
+            if (block % blocks_per_superblock == 0) {
+                superblocks_[block / blocks_per_superblock] = total;
+            }
+
+            auto& entry {blocks_[block]};
+            SetBits(entry, total - superblocks_[block / blocks_per_superblock], 0, rank_bits);
+            size_type block_total {0};
+            for (size_type sub {0}; sub != subs_per_block; ++sub) {
+                const auto count {CountSub(block, sub)};
+                if (sub != subs_per_block - 1) {
+                    SetBits(entry, count, rank_bits + sub * count_bits, count_bits);
+                }
+
+                block_total += count;
+            }
+
+            // Sample the block of every bit whose rank is a multiple of the sample rate.
+            Sample(samples_, total, block_total, block);
+            const auto zeros {block * block_width - total};
+            const auto block_size {std::min(block_width, size_ - block * block_width)};
+            Sample(zero_samples_, zeros, block_size - block_total, block);
+            total += block_total;
+        }
+
+        ones_ = total;
+    }
+
+    std::span<const std::uint64_t> words_;
+    size_type size_ {0};
+    size_type ones_ {0};
+    std::vector<std::uint64_t> superblocks_;
+    std::vector<std::uint64_t> blocks_;
+    std::vector<std::uint64_t> samples_;
+    std::vector<std::uint64_t> zero_samples_;
+};
+
+}  // namespace bit
@@ -0,0 +1,913 @@
+/**
+ * @file roaring.h
+ * @brief Roaring bitmaps: compressed sets of 32-bit unsigned integers.
+ *
+ * @details
+ * Values are split into 64K chunks by their high words.
+ * Each chunk is stored in the smallest of three containers of its low words:
+ * - An array of up to 4096 sorted values, taking 2 bytes per value.
+ * - A bitmap of 65536 bits, taking 8 KB.
+ * - Runs of consecutive values, taking 4 bytes per run.
+ *
+ * Arrays and bitmaps are switched automatically as values are added and removed.
+ * Runs are only chosen by `RunOptimize`.
+ *
+ * Arrays are intersected eight values at a time with SSSE3 byte shuffles,
+ * and bitmaps are intersected and united with the vector kernels of `Bitset`.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "bitset.h"
+#include "dispatch.h"
+#include "endian.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace bit {
+
+namespace detail {
+
+//! The number of values in a chunk.
+inline constexpr std::size_t roaring_chunk_size {std::size_t {1} << 16};
+
+//! The largest array, which takes as many bytes as a bitmap.
+inline constexpr std::size_t roaring_array_limit {4096};
+
+//! Sorted values of a sparse chunk.
+using RoaringArray = std::vector<std::uint16_t>;
+
+//! A dense chunk with its number of values.
+struct RoaringBits {
+    Bitset bits {roaring_chunk_size};
+    std::size_t count {0};
+
+    friend bool operator==(const RoaringBits&, const RoaringBits&) = default;
+};
+
+//! The consecutive values from `start` to `start + length`.
+struct RoaringRun {
+    std::uint16_t start;
+    std::uint16_t length;
+
+    //! The last value.
+    constexpr std::uint32_t last() const noexcept {
+        return static_cast<std::uint32_t>(start) + length;
+    }
+
+    friend constexpr bool operator==(const RoaringRun&, const RoaringRun&) noexcept = default;
+};
+
+//! Sorted and separated runs of a chunk.
+using RoaringRuns = std::vector<RoaringRun>;
+
+using RoaringContainer = std::variant<RoaringArray, RoaringBits, RoaringRuns>;
+
+//! Call a function with each set bit of a bitset in ascending order.
+template <std::invocable<std::uint16_t> Fn>
+void ForEachBit(const Bitset& bits, Fn fn) {
+    const auto words {bits.words()};
+    for (std::size_t i {0}; i != words.size(); ++i) {
+        for (auto word {words[i]}; word != 0; word &= word - 1) {
+            fn(static_cast<std::uint16_t>(i * Bitset::word_width
+                                          + static_cast<std::size_t>(std::countr_zero(word))));
+        }
+    }
+}
+
+//! Call a function with each value of a container in ascending order.
+template <std::invocable<std::uint16_t> Fn>
+void ForEachValue(const RoaringContainer& container, Fn fn) {
+    if (const auto* const vals {std::get_if<RoaringArray>(&container)}) {
+        std::ranges::for_each(*vals, fn);
+    } else if (const auto* const bits {std::get_if<RoaringBits>(&container)}) {
+        ForEachBit(bits->bits, fn);
+    } else {
+        for (const auto run : *std::get_if<RoaringRuns>(&container)) {
+            for (auto val {static_cast<std::uint32_t>(run.start)}; val <= run.last(); ++val) {
+                fn(static_cast<std::uint16_t>(val));
+            }
+        }
+    }
+}
+
+inline std::size_t RoaringCount(const RoaringContainer& container) noexcept {
+    if (const auto* const vals {std::get_if<RoaringArray>(&container)}) {
+        return vals->size();
+    } else if (const auto* const bits {std::get_if<RoaringBits>(&container)}) {
+        return bits->count;
+    }
+
+    std::size_t count {0};
+    for (const auto run : *std::get_if<RoaringRuns>(&container)) {
+        count += static_cast<std::size_t>(run.length) + 1;
+    }
+
+    return count;
+}
+
+inline bool RoaringContains(const RoaringContainer& container, const std::uint16_t val) noexcept {
+    if (const auto* const vals {std::get_if<RoaringArray>(&container)}) {
+        return std::ranges::binary_search(*vals, val);
+    } else if (const auto* const bits {std::get_if<RoaringBits>(&container)}) {
+        return bits->bits.IsSet(val);
+    }
+
+    const auto& runs {*std::get_if<RoaringRuns>(&container)};
+    const auto next {std::ranges::upper_bound(runs, val, {}, &RoaringRun::start)};
+    return next != runs.begin() && val <= std::prev(next)->last();
+}
+
+inline RoaringBits ToBits(const RoaringContainer& container) {
+    if (const auto* const bits {std::get_if<RoaringBits>(&container)}) {
+        return *bits;
+    }
+
+    RoaringBits bits;
+    if (const auto* const runs {std::get_if<RoaringRuns>(&container)}) {
+        for (const auto run : *runs) {
+            bits.bits.Fill(run.start, static_cast<std::size_t>(run.length) + 1);
+        }
+    } else {
+        for (const auto val : *std::get_if<RoaringArray>(&container)) {
+            bits.bits.Set(val);
+        }
+    }
+
+    bits.count = RoaringCount(container);
+    return bits;
+}
+
+inline RoaringRuns ToRuns(const RoaringContainer& container) {
+    if (const auto* const runs {std::get_if<RoaringRuns>(&container)}) {
+        return *runs;
+    }
+
+    RoaringRuns runs;
+    ForEachValue(container, [&runs](const std::uint16_t val) {
+        if (!runs.empty() && runs.back().last() + 1 == val) {
+            ++runs.back().length;
+        } else {
+            runs.push_back({val, 0});
+        }
+    });
+
+    return runs;
+}
+
+//! Store a bitmap as an array if it is small enough.
+inline RoaringContainer Normalize(RoaringBits&& bits) {
+    if (bits.count > roaring_array_limit) {
+        return std::move(bits);
+    }
+
+    RoaringArray vals;
+    vals.reserve(bits.count);
+    ForEachBit(bits.bits, [&vals](const std::uint16_t val) { vals.push_back(val); });
+    return vals;
+}
+
+inline void RoaringAdd(RoaringContainer& container, const std::uint16_t val) {
+    if (auto* const vals {std::get_if<RoaringArray>(&container)}) {
+        const auto pos {std::ranges::lower_bound(*vals, val)};
+        if (pos != vals->end() && *pos == val) {
+            return;
+        } else if (vals->size() < roaring_array_limit) {
+            vals->insert(pos, val);
+            return;
+        }
+
+        container = ToBits(container);
+    }
+
+    if (auto* const bits {std::get_if<RoaringBits>(&container)}) {
+        if (!bits->bits.IsSet(val)) {
+            bits->bits.Set(val);
+            ++bits->count;
+        }
+
+        return;
+    }
+
+    auto& runs {*std::get_if<RoaringRuns>(&container)};
+    const auto next {std::ranges::upper_bound(runs, val, {}, &RoaringRun::start)};
+    const bool joins_next {next != runs.end() && next->start == val + 1};
+    if (next != runs.begin()) {
+        const auto prev {std::prev(next)};
+        if (val <= prev->last()) {
+            return;
+        } else if (prev->last() + 1 == val) {
+            ++prev->length;
+            if (joins_next) {
+                prev->length += next->length + 1;
+                runs.erase(next);
+            }
+
+            return;
+        }
+    }
+
+    if (joins_next) {
+        --next->start;
+        ++next->length;
+    } else {
+        runs.insert(next, {val, 0});
+    }
+}
+
+inline void RoaringRemove(RoaringContainer& container, const std::uint16_t val) {
+    if (auto* const vals {std::get_if<RoaringArray>(&container)}) {
+        if (const auto pos {std::ranges::lower_bound(*vals, val)};
+            pos != vals->end() && *pos == val) {
+            vals->erase(pos);
+        }
+    } else if (auto* const bits {std::get_if<RoaringBits>(&container)}) {
+        if (bits->bits.IsSet(val)) {
+            bits->bits.Clear(val);
+            if (--bits->count == roaring_array_limit) {
+                container = Normalize(std::move(*bits));
+            }
+        }
+    } else {
+        auto& runs {*std::get_if<RoaringRuns>(&container)};
+        const auto next {std::ranges::upper_bound(runs, val, {}, &RoaringRun::start)};
+        if (next == runs.begin() || std::prev(next)->last() < val) {
+            return;
+        }
+
+        const auto run {std::prev(next)};
+        if (run->length == 0) {
+            runs.erase(run);
+        } else if (val == run->start) {
+            ++run->start;
+            --run->length;
+        } else if (val == run->last()) {
+            --run->length;
+        } else {
+            const RoaringRun tail {static_cast<std::uint16_t>(val + 1),
+                                   static_cast<std::uint16_t>(run->last() - val - 1)};
+            run->length = static_cast<std::uint16_t>(val - run->start - 1);
+            runs.insert(next, tail);
+        }
+    }
+}
+
+#if defined(BIT_MANIP_SSSE3)
+
+//! A shuffle that packs the 16-bit lanes selected by an 8-bit mask to the front.
+struct RoaringPackShuffle {
+    //! The source bytes. `0x80` clears a byte.
+    alignas(16) std::array<std::uint8_t, 16> lanes;
+
+    //! The number of selected lanes.
+    std::uint8_t count;
+};
+
+//! Build a shuffle for each mask.
+constexpr std::array<RoaringPackShuffle, 256> MakeRoaringPackShuffles() noexcept {
+    std::array<RoaringPackShuffle, 256> shuffles {};
+    for (std::size_t mask {0}; mask != shuffles.size(); ++mask) {
+        auto& shuffle {shuffles[mask]};
+        shuffle.lanes.fill(0x80);
+        std::size_t count {0};
+        for (std::size_t lane {0}; lane != 8; ++lane) {
+            if (IsBitSet(mask, lane)) {
+                shuffle.lanes[count * 2] = static_cast<std::uint8_t>(lane * 2);
+                shuffle.lanes[count * 2 + 1] = static_cast<std::uint8_t>(lane * 2 + 1);
+                ++count;
+            }
+        }
+
+        shuffle.count = static_cast<std::uint8_t>(count);
+    }
+
+    return shuffles;
+}
+
+inline constexpr auto roaring_pack_shuffles {MakeRoaringPackShuffles()};
+
+//! Find the 16-bit lanes of `lhs` that equal any lane of `rhs` by comparing with all rotations.
+BIT_MANIP_TARGET_SSSE3 inline __m128i MatchRotationsSsse3(const __m128i lhs,
+                                                          const __m128i rhs) noexcept {
+    // The rotations are independent, so they are unrolled rather than chained.
+    const auto match_0_2 {_mm_or_si128(_mm_cmpeq_epi16(lhs, rhs),
+                                       _mm_cmpeq_epi16(lhs, _mm_alignr_epi8(rhs, rhs, 2)))};
+    const auto match_4_6 {_mm_or_si128(_mm_cmpeq_epi16(lhs, _mm_alignr_epi8(rhs, rhs, 4)),
+                                       _mm_cmpeq_epi16(lhs, _mm_alignr_epi8(rhs, rhs, 6)))};
+    const auto match_8_10 {_mm_or_si128(_mm_cmpeq_epi16(lhs, _mm_alignr_epi8(rhs, rhs, 8)),
+                                        _mm_cmpeq_epi16(lhs, _mm_alignr_epi8(rhs, rhs, 10)))};
+    const auto match_12_14 {_mm_or_si128(_mm_cmpeq_epi16(lhs, _mm_alignr_epi8(rhs, rhs, 12)),
+                                         _mm_cmpeq_epi16(lhs, _mm_alignr_epi8(rhs, rhs, 14)))};
+    return _mm_or_si128(_mm_or_si128(match_0_2, match_4_6), _mm_or_si128(match_8_10, match_12_14));
+}
+
+/**
+ * @brief Intersect sorted arrays eight values at a time with SSSE3.
+ *
+ * @details
+ * Each block of `lhs` is compared with all rotations of a block of `rhs`,
+ * and the block with the smaller last value is replaced.
+ * Up to eight values are written at each step, so `out` needs room for eight values more.
+ *
+ * @return The number of written values.
+ */
+BIT_MANIP_TARGET_SSSE3 inline std::size_t IntersectArraysSsse3(
+    const std::span<const std::uint16_t> lhs, const std::span<const std::uint16_t> rhs,
+    std::uint16_t* const out, std::size_t& i, std::size_t& j) noexcept {
+    constexpr std::size_t lanes {sizeof(__m128i) / sizeof(std::uint16_t)};
+    auto lhs_pos {i};
+    auto rhs_pos {j};
+    std::size_t count {0};
+    while (lhs.size() - lhs_pos >= lanes && rhs.size() - rhs_pos >= lanes) {
+        const auto lhs_vals {
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs.data() + lhs_pos))};
+        const auto rhs_vals {
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs.data() + rhs_pos))};
+        const auto matches {MatchRotationsSsse3(lhs_vals, rhs_vals)};
+        const auto mask {_mm_movemask_epi8(_mm_packs_epi16(matches, _mm_setzero_si128()))};
+        const auto& shuffle {roaring_pack_shuffles[static_cast<std::size_t>(mask)]};
+        const auto* const lanes_ptr {reinterpret_cast<const __m128i*>(shuffle.lanes.data())};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count),
+                         _mm_shuffle_epi8(lhs_vals, _mm_load_si128(lanes_ptr)));
+        count += shuffle.count;
+
+        // Advance without branches, which would be mispredicted half of the time.
+        const auto lhs_last {lhs[lhs_pos + lanes - 1]};
+        const auto rhs_last {rhs[rhs_pos + lanes - 1]};
+        lhs_pos += static_cast<std::size_t>(lhs_last <= rhs_last) * lanes;
+        rhs_pos += static_cast<std::size_t>(rhs_last <= lhs_last) * lanes;
+    }
+
+    i = lhs_pos;
+    j = rhs_pos;
+    return count;
+}
+
+#endif
+
+inline RoaringArray IntersectArrays(const RoaringArray& lhs, const RoaringArray& rhs) {
+    // Search a much smaller array in the larger one instead of merging.
+    constexpr std::size_t gallop_ratio {64};
+    if (lhs.size() * gallop_ratio < rhs.size() || rhs.size() * gallop_ratio < lhs.size()) {
+        const auto& small {lhs.size() < rhs.size() ? lhs : rhs};
+        const auto& large {lhs.size() < rhs.size() ? rhs : lhs};
+        RoaringArray out;
+        auto begin {large.begin()};
+        for (const auto val : small) {
+            begin = std::lower_bound(begin, large.end(), val);
+            if (begin == large.end()) {
+                break;
+            } else if (*begin == val) {
+                out.push_back(val);
+            }
+        }
+
+        return out;
+    }
+
+    RoaringArray out(std::min(lhs.size(), rhs.size()) + 8);
+    std::size_t i {0};
+    std::size_t j {0};
+    std::size_t count {0};
+#if defined(BIT_MANIP_SSSE3)
+    if (CanUseSsse3()) {
+        count = IntersectArraysSsse3(lhs, rhs, out.data(), i, j);
+    }
+#endif
+    while (i != lhs.size() && j != rhs.size()) {
+        if (lhs[i] < rhs[j]) {
+            ++i;
+        } else if (rhs[j] < lhs[i]) {
+            ++j;
+        } else {
+            out[count++] = lhs[i];
+            ++i;
+            ++j;
+        }
+    }
+
+    out.resize(count);
+    return out;
+}
+
+inline RoaringRuns IntersectRuns(const RoaringRuns& lhs, const RoaringRuns& rhs) {
+    RoaringRuns out;
+    std::size_t i {0};
+    std::size_t j {0};
+    while (i != lhs.size() && j != rhs.size()) {
+        const auto first {std::max(lhs[i].start, rhs[j].start)};
+        const auto last {std::min(lhs[i].last(), rhs[j].last())};
+        if (first <= last) {
+            out.push_back({first, static_cast<std::uint16_t>(last - first)});
+        }
+
+        if (lhs[i].last() < rhs[j].last()) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+
+    return out;
+}
+
+inline RoaringRuns UniteRuns(const RoaringRuns& lhs, const RoaringRuns& rhs) {
+    RoaringRuns out;
+    std::size_t i {0};
+    std::size_t j {0};
+    while (i != lhs.size() || j != rhs.size()) {
+        const auto run {j == rhs.size() || (i != lhs.size() && lhs[i].start < rhs[j].start)
+                            ? lhs[i++]
+                            : rhs[j++]};
+        if (!out.empty() && run.start <= out.back().last() + 1) {
+            const auto last {std::max(out.back().last(), run.last())};
+            out.back().length = static_cast<std::uint16_t>(last - out.back().start);
+        } else {
+            out.push_back(run);
+        }
+    }
+
+    return out;
+}
+
+inline RoaringContainer RoaringAnd(const RoaringContainer& lhs, const RoaringContainer& rhs) {
+    const auto* const lhs_vals {std::get_if<RoaringArray>(&lhs)};
+    const auto* const rhs_vals {std::get_if<RoaringArray>(&rhs)};
+    if (lhs_vals != nullptr && rhs_vals != nullptr) {
+        return IntersectArrays(*lhs_vals, *rhs_vals);
+    } else if (lhs_vals != nullptr || rhs_vals != nullptr) {
+        const auto& vals {lhs_vals != nullptr ? *lhs_vals : *rhs_vals};
+        const auto& other {lhs_vals != nullptr ? rhs : lhs};
+        RoaringArray out;
+        std::ranges::copy_if(vals, std::back_inserter(out),
+                             [&other](const auto val) { return RoaringContains(other, val); });
+        return out;
+    }
+
+    const auto* const lhs_runs {std::get_if<RoaringRuns>(&lhs)};
+    const auto* const rhs_runs {std::get_if<RoaringRuns>(&rhs)};
+    if (lhs_runs != nullptr && rhs_runs != nullptr) {
+        return IntersectRuns(*lhs_runs, *rhs_runs);
+    }
+
+    auto out {ToBits(lhs_runs != nullptr ? rhs : lhs)};
+    const auto& other {lhs_runs != nullptr ? lhs : rhs};
+    if (const auto* const bits {std::get_if<RoaringBits>(&other)}) {
+        out.bits &= bits->bits;
+    } else {
+        out.bits &= ToBits(other).bits;
+    }
+
+    out.count = out.bits.Count();
+    return Normalize(std::move(out));
+}
+
+inline RoaringContainer RoaringOr(const RoaringContainer& lhs, const RoaringContainer& rhs) {
+    const auto* const lhs_vals {std::get_if<RoaringArray>(&lhs)};
+    const auto* const rhs_vals {std::get_if<RoaringArray>(&rhs)};
+    if (lhs_vals != nullptr && rhs_vals != nullptr
+        && lhs_vals->size() + rhs_vals->size() <= roaring_array_limit) {
+        RoaringArray out;
+        out.reserve(lhs_vals->size() + rhs_vals->size());
+        std::ranges::set_union(*lhs_vals, *rhs_vals, std::back_inserter(out));
+        return out;
+    }
+
+    const auto* const lhs_runs {std::get_if<RoaringRuns>(&lhs)};
+    const auto* const rhs_runs {std::get_if<RoaringRuns>(&rhs)};
+    if (lhs_runs != nullptr && rhs_runs != nullptr) {
+        return UniteRuns(*lhs_runs, *rhs_runs);
+    }
+
+    // Start from a bitmap operand to save a conversion.
+    const bool lhs_bits {std::holds_alternative<RoaringBits>(lhs)};
+    auto out {ToBits(lhs_bits ? lhs : rhs)};
+    const auto& other {lhs_bits ? rhs : lhs};
+    if (const auto* const vals {std::get_if<RoaringArray>(&other)}) {
+        for (const auto val : *vals) {
+            out.bits.Set(val);
+        }
+    } else if (const auto* const bits {std::get_if<RoaringBits>(&other)}) {
+        out.bits |= bits->bits;
+    } else {
+        out.bits |= ToBits(other).bits;
+    }
+
+    out.count = out.bits.Count();
+    return Normalize(std::move(out));
+}
+
+inline bool RoaringEqual(const RoaringContainer& lhs, const RoaringContainer& rhs) {
+    if (lhs.index() == rhs.index()) {
+        return lhs == rhs;
+    } else if (RoaringCount(lhs) != RoaringCount(rhs)) {
+        return false;
+    }
+
+    bool equal {true};
+    ForEachValue(lhs, [&](const std::uint16_t val) { equal = equal && RoaringContains(rhs, val); });
+    return equal;
+}
+
+//! The number of serialized bytes of a container header: a key, a type and a size.
+inline constexpr std::size_t roaring_header_size {7};
+
+inline std::size_t RoaringPayloadSize(const RoaringContainer& container) noexcept {
+    if (const auto* const vals {std::get_if<RoaringArray>(&container)}) {
+        return vals->size() * sizeof(std::uint16_t);
+    } else if (std::holds_alternative<RoaringBits>(container)) {
+        return roaring_chunk_size / CHAR_BIT;
+    }
+
+    return std::get_if<RoaringRuns>(&container)->size() * sizeof(RoaringRun);
+}
+
+}  // namespace detail
+
+/**
+ * @brief A compressed set of 32-bit unsigned integers.
+ *
+ * @details
+ * Chunks are kept sorted by their high words.
+ * Intersection and union work on chunks with equal high words,
+ * and choose an algorithm for each pair of container types.
+ */
+class RoaringBitmap {
+public:
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+
+    RoaringBitmap() noexcept = default;
+
+    //! Create a bitmap from values in any order.
+    explicit RoaringBitmap(const std::span<const value_type> vals) {
+        std::vector<value_type> sorted(vals.begin(), vals.end());
+        std::ranges::sort(sorted);
+        const auto [last, end] {std::ranges::unique(sorted)};
+        sorted.erase(last, end);
+        for (auto begin {sorted.begin()}; begin != sorted.end();) {
+            const auto key {GetHighWord(*begin)};
+            const auto chunk_end {std::find_if(begin, sorted.end(), [key](const auto val) noexcept {
+                return GetHighWord(val) != key;
+            })};
+            const auto count {static_cast<std::size_t>(chunk_end - begin)};
+            keys_.push_back(key);
+            if (count <= detail::roaring_array_limit) {
+                detail::RoaringArray chunk;
+                chunk.reserve(count);
+                std::transform(begin, chunk_end, std::back_inserter(chunk), GetLowWord);
+                containers_.emplace_back(std::move(chunk));
+            } else {
+                detail::RoaringBits chunk;
+                std::for_each(begin, chunk_end,
+                              [&chunk](const auto val) { chunk.bits.Set(GetLowWord(val)); });
+                chunk.count = count;
+                containers_.emplace_back(std::move(chunk));
+            }
+
+            begin = chunk_end;
+        }
+    }
+
+    //! Count the values.
+    size_type Count() const noexcept {
+        size_type count {0};
+        for (const auto& container : containers_) {
+            count += detail::RoaringCount(container);
+        }
+
+        return count;
+    }
+
+    constexpr bool empty() const noexcept {
+        return keys_.empty();
+    }
+
+    //! Check if a value is in the set.
+    bool Contains(const value_type val) const noexcept {
+        const auto idx {Find(GetHighWord(val))};
+        return idx != npos && detail::RoaringContains(containers_[idx], GetLowWord(val));
+    }
+
+    //! Add a value.
+    void Add(const value_type val) {
+        const auto key {GetHighWord(val)};
+        const auto pos {std::ranges::lower_bound(keys_, key)};
+        const auto idx {static_cast<std::size_t>(pos - keys_.begin())};
+        if (pos == keys_.end() || *pos != key) {
+            keys_.insert(pos, key);
+            containers_.emplace(containers_.begin() + idx);
+        }
+
+        detail::RoaringAdd(containers_[idx], GetLowWord(val));
+    }
+
+    //! Remove a value.
+    void Remove(const value_type val) {
+        const auto idx {Find(GetHighWord(val))};
+        if (idx == npos) {
+            return;
+        }
+
+        detail::RoaringRemove(containers_[idx], GetLowWord(val));
+        if (detail::RoaringCount(containers_[idx]) == 0) {
+            keys_.erase(keys_.begin() + idx);
+            containers_.erase(containers_.begin() + idx);
+        }
+    }
+
+    //! Store each chunk as runs, an array or a bitmap, whichever takes the fewest bytes.
+    void RunOptimize() {
+        for (auto& container : containers_) {
+            auto runs {detail::ToRuns(container)};
+            const auto count {detail::RoaringCount(container)};
+            const auto run_size {runs.size() * sizeof(detail::RoaringRun)};
+            const auto other_size {std::min(count * sizeof(std::uint16_t),
+                                            detail::roaring_chunk_size / CHAR_BIT)};
+            if (run_size < other_size) {
+                container = std::move(runs);
+            } else if (std::holds_alternative<detail::RoaringRuns>(container)) {
+                container = detail::Normalize(detail::ToBits(container));
+            }
+        }
+    }
+
+    //! Call a function with each value in ascending order.
+    template <std::invocable<value_type> Fn>
+    void ForEach(Fn fn) const {
+        for (std::size_t i {0}; i != keys_.size(); ++i) {
+            detail::ForEachValue(containers_[i], [&fn, key {keys_[i]}](const std::uint16_t low) {
+                fn(CombineWords(key, low));
+            });
+        }
+    }
+
+    //! Intersect with another bitmap.
+    RoaringBitmap& operator&=(const RoaringBitmap& other) {
+        std::size_t kept {0};
+        std::size_t j {0};
+        for (std::size_t i {0}; i != keys_.size(); ++i) {
+            while (j != other.keys_.size() && other.keys_[j] < keys_[i]) {
+                ++j;
+            }
+
+            if (j == other.keys_.size()) {
+                break;
+            } else if (other.keys_[j] != keys_[i]) {
+                continue;
+            }
+
+            auto chunk {detail::RoaringAnd(containers_[i], other.containers_[j])};
+            if (detail::RoaringCount(chunk) != 0) {
+                keys_[kept] = keys_[i];
+                containers_[kept++] = std::move(chunk);
+            }
+        }
+
+        keys_.resize(kept);
+        containers_.resize(kept);
+        return *this;
+    }
+
+    //! Unite with another bitmap.
+    RoaringBitmap& operator|=(const RoaringBitmap& other) {
+        std::vector<std::uint16_t> keys;
+        std::vector<detail::RoaringContainer> containers;
+        keys.reserve(keys_.size() + other.keys_.size());
+        containers.reserve(keys_.size() + other.keys_.size());
+        std::size_t i {0};
+        std::size_t j {0};
+        while (i != keys_.size() || j != other.keys_.size()) {
+            if (j == other.keys_.size() || (i != keys_.size() && keys_[i] < other.keys_[j])) {
+                keys.push_back(keys_[i]);
+                containers.push_back(std::move(containers_[i++]));
+            } else if (i == keys_.size() || other.keys_[j] < keys_[i]) {
+                keys.push_back(other.keys_[j]);
+                containers.push_back(other.containers_[j++]);
+            } else {
+                keys.push_back(keys_[i]);
+                containers.push_back(detail::RoaringOr(containers_[i++], other.containers_[j++]));
+            }
+        }
+
+        keys_ = std::move(keys);
+        containers_ = std::move(containers);
+        return *this;
+    }
+
+    friend RoaringBitmap operator&(RoaringBitmap lhs, const RoaringBitmap& rhs) {
+        lhs &= rhs;
+        return lhs;
+    }
+
+    friend RoaringBitmap operator|(RoaringBitmap lhs, const RoaringBitmap& rhs) {
+        lhs |= rhs;
+        return lhs;
+    }
+
+    //! Check if two bitmaps hold the same values, whatever their containers.
+    friend bool operator==(const RoaringBitmap& lhs, const RoaringBitmap& rhs) {
+        return lhs.keys_ == rhs.keys_
+               && std::ranges::equal(lhs.containers_, rhs.containers_, detail::RoaringEqual);
+    }
+
+    //! The number of bytes written by `Serialize`.
+    size_type SerializedSize() const noexcept {
+        size_type size {sizeof(std::uint32_t)};
+        for (const auto& container : containers_) {
+            size += detail::roaring_header_size + detail::RoaringPayloadSize(container);
+        }
+
+        return size;
+    }
+
+    /**
+     * @brief Write the bitmap as little-endian bytes.
+     *
+     * @details
+     * The bytes start with the number of chunks.
+     * Each chunk has a header of its high word, its container type and its number of values
+     * or runs, followed by the values, the bitmap words or the runs.
+     *
+     * @param out A span of at least `SerializedSize()` bytes.
+     * @return The number of written bytes.
+     */
+    size_type Serialize(const std::span<std::uint8_t> out) const noexcept {
+        assert(out.size() >= SerializedSize());
+        auto* dest {out.data()};
+        StoreLE(dest, static_cast<std::uint32_t>(keys_.size()));
+        dest += sizeof(std::uint32_t);
+        for (std::size_t i {0}; i != keys_.size(); ++i) {
+            const auto& container {containers_[i]};
+            StoreLE(dest, keys_[i]);
+            dest[sizeof(std::uint16_t)] = static_cast<std::uint8_t>(container.index());
+            const auto size {std::holds_alternative<detail::RoaringRuns>(container)
+                                 ? std::get_if<detail::RoaringRuns>(&container)->size()
+                                 : detail::RoaringCount(container)};
+            StoreLE(dest + sizeof(std::uint16_t) + 1, static_cast<std::uint32_t>(size));
+            dest += detail::roaring_header_size;
+            if (const auto* const vals {std::get_if<detail::RoaringArray>(&container)}) {
+                for (const auto val : *vals) {
+                    StoreLE(dest, val);
+                    dest += sizeof(val);
+                }
+            } else if (const auto* const bits {std::get_if<detail::RoaringBits>(&container)}) {
+                for (const auto word : bits->bits.words()) {
+                    StoreLE(dest, word);
+                    dest += sizeof(word);
+                }
+            } else {
+                for (const auto run : *std::get_if<detail::RoaringRuns>(&container)) {
+                    StoreLE(dest, run.start);
+                    StoreLE(dest + sizeof(run.start), run.length);
+                    dest += sizeof(run);
+                }
+            }
+        }
+
+        return static_cast<size_type>(dest - out.data());
+    }
+
+    /**
+     * @brief Read a bitmap written by `Serialize` from untrusted input.
+     *
+     * @details
+     * Bytes after the bitmap are ignored.
+     *
+     * @return The bitmap, or nothing if the input is truncated or malformed.
+     */
+    static std::optional<RoaringBitmap> Deserialize(std::span<const std::uint8_t> in) {
+        if (in.size() < sizeof(std::uint32_t)) {
+            return std::nullopt;
+        }
+
+        RoaringBitmap bitmap;
+        const auto chunks {LoadLE<std::uint32_t>(in.data())};
+        in = in.subspan(sizeof(std::uint32_t));
+        for (std::uint32_t chunk {0}; chunk != chunks; ++chunk) {
+            if (in.size() < detail::roaring_header_size) {
+                return std::nullopt;
+            }
+
+            const auto key {LoadLE<std::uint16_t>(in.data())};
+            const auto type {in[sizeof(key)]};
+            const auto size {LoadLE<std::uint32_t>(in.data() + sizeof(key) + 1)};
+            in = in.subspan(detail::roaring_header_size);
+            if (size == 0 || (!bitmap.empty() && key <= bitmap.keys_.back())) {
+                return std::nullopt;
+            }
+
+            std::optional<detail::RoaringContainer> container;
+            switch (type) {
+                case 0: container = ReadArray(in, size); break;
+                case 1: container = ReadBits(in, size); break;
+                case 2: container = ReadRuns(in, size); break;
+                default: break;
+            }
+
+            if (!container) {
+                return std::nullopt;
+            }
+
+            bitmap.keys_.push_back(key);
+            bitmap.containers_.push_back(std::move(*container));
+        }
+
+        return bitmap;
+    }
+
+private:
+    static constexpr std::size_t npos {static_cast<std::size_t>(-1)};
+
+    //! Find the chunk of a high word, or `npos` if there is none.
+    std::size_t Find(const std::uint16_t key) const noexcept {
+        const auto pos {std::ranges::lower_bound(keys_, key)};
+        return pos != keys_.end() && *pos == key ? static_cast<std::size_t>(pos - keys_.begin())
+                                                 : npos;
+    }
+
+    static std::optional<detail::RoaringContainer> ReadArray(std::span<const std::uint8_t>& in,
+                                                             const std::size_t size) {
+        if (size > detail::roaring_array_limit || in.size() < size * sizeof(std::uint16_t)) {
+            return std::nullopt;
+        }
+
+        detail::RoaringArray vals(size);
+        for (std::size_t i {0}; i != size; ++i) {
+            vals[i] = LoadLE<std::uint16_t>(in.data() + i * sizeof(std::uint16_t));
+            if (i != 0 && vals[i] <= vals[i - 1]) {
+                return std::nullopt;
+            }
+        }
+
+        in = in.subspan(size * sizeof(std::uint16_t));
+        return vals;
+    }
+
+    static std::optional<detail::RoaringContainer> ReadBits(std::span<const std::uint8_t>& in,
+                                                            const std::size_t size) {
+        constexpr std::size_t bytes {detail::roaring_chunk_size / CHAR_BIT};
+        if (in.size() < bytes) {
+            return std::nullopt;
+        }
+
+        detail::RoaringBits bits;
+        for (std::size_t i {0}; i != bytes / sizeof(Bitset::Word); ++i) {
+            auto word {LoadLE<Bitset::Word>(in.data() + i * sizeof(Bitset::Word))};
+            for (; word != 0; word &= word - 1) {
+                bits.bits.Set(i * Bitset::word_width
+                              + static_cast<std::size_t>(std::countr_zero(word)));
+            }
+        }
+
+        bits.count = bits.bits.Count();
+        if (bits.count != size) {
+            return std::nullopt;
+        }
+
+        in = in.subspan(bytes);
+        return bits;
+    }
+
+    static std::optional<detail::RoaringContainer> ReadRuns(std::span<const std::uint8_t>& in,
+                                                            const std::size_t size) {
+        if (size > detail::roaring_chunk_size / 2
+            || in.size() < size * sizeof(detail::RoaringRun)) {
+            return std::nullopt;
+        }
+
+        detail::RoaringRuns runs(size);
+        for (std::size_t i {0}; i != size; ++i) {
+            const auto* const src {in.data() + i * sizeof(detail::RoaringRun)};
+            runs[i] = {LoadLE<std::uint16_t>(src),
+                       LoadLE<std::uint16_t>(src + sizeof(std::uint16_t))};
+            if (runs[i].last() >= detail::roaring_chunk_size
+                || (i != 0 && runs[i].start <= runs[i - 1].last() + 1)) {
+                return std::nullopt;
+            }
+        }
+
+        in = in.subspan(size * sizeof(detail::RoaringRun));
+        return runs;
+    }
+
+    std::vector<std::uint16_t> keys_;
+    std::vector<detail::RoaringContainer> containers_;
+};
+
+}  // namespace bit
@@ -0,0 +1,170 @@
+/**
+ * @file scatter_gather.h
+ * @brief Gathering and scattering bits selected by non-contiguous masks.
+ *
+ * @details
+ * `ExtractBits` and `DepositBits` follow the semantics of the BMI2 `pext` and `pdep` instructions.
+ * At runtime they use BMI2 when the CPU runs it natively,
+ * and a branch-free software version on other CPUs,
+ * including AMD processors before Zen 3 that implement BMI2 in microcode.
+ * They are evaluated in software during constant evaluation.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "cpu.h"
+
+#include <bit>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define BIT_MANIP_BMI2
+    #include <immintrin.h>
+#endif
+
+namespace bit {
+
+namespace detail {
+
+//! Compute the prefix XOR of bits from least to most significant.
+template <std::unsigned_integral T>
+constexpr T PrefixXor(T val) noexcept {
+    for (std::size_t shift {1}; shift < sizeof(T) * CHAR_BIT; shift *= 2) {
+        val = static_cast<T>(val ^ (val << shift));
+    }
+
+    return val;
+}
+
+/**
+ * @brief Gather the bits of a value selected by a mask into its low bits.
+ *
+ * @details
+ * It moves each bit by the number of unselected bits below it,
+ * one power of two at a time, as in *Hacker's Delight* 7-4.
+ */
+template <std::unsigned_integral T>
+constexpr T CompressBits(T val, T mask) noexcept {
+    val &= mask;
+    // Bits that have an unselected bit just below them.
+    auto zeros {static_cast<T>(~mask << 1)};
+    for (std::size_t shift {1}; shift < sizeof(T) * CHAR_BIT; shift *= 2) {
+        const auto moves {PrefixXor(zeros)};
+        const auto moved_mask {static_cast<T>(moves & mask)};
+        mask = static_cast<T>((mask ^ moved_mask) | (moved_mask >> shift));
+        const auto moved_val {static_cast<T>(val & moved_mask)};
+        val = static_cast<T>((val ^ moved_val) | (moved_val >> shift));
+        zeros &= static_cast<T>(~moves);
+    }
+
+    return val;
+}
+
+/**
+ * @brief Scatter the low bits of a value to the positions selected by a mask.
+ *
+ * @details
+ * It reverses the moves of `CompressBits`, as in *Hacker's Delight* 7-5.
+ */
+template <std::unsigned_integral T>
+constexpr T ExpandBits(T val, T mask) noexcept {
+    constexpr std::size_t rounds {std::countr_zero(sizeof(T) * CHAR_BIT)};
+    const auto origin_mask {mask};
+    T moved_masks[rounds] {};
+    auto zeros {static_cast<T>(~mask << 1)};
+    for (std::size_t i {0}; i != rounds; ++i) {
+        const auto moves {PrefixXor(zeros)};
+        const auto moved_mask {static_cast<T>(moves & mask)};
+        moved_masks[i] = moved_mask;
+        mask = static_cast<T>((mask ^ moved_mask) | (moved_mask >> (1U << i)));
+        zeros &= static_cast<T>(~moves);
+    }
+
+    for (auto i {rounds}; i-- != 0;) {
+        const auto moved_mask {moved_masks[i]};
+        const auto shifted {static_cast<T>(val << (1U << i))};
+        val = static_cast<T>((val & ~moved_mask) | (shifted & moved_mask));
+    }
+
+    return static_cast<T>(val & origin_mask);
+}
+
+#if defined(BIT_MANIP_BMI2)
+
+    #if defined(__GNUC__) || defined(__clang__)
+        #define BIT_MANIP_TARGET_BMI2 __attribute__((target("bmi2")))
+    #else
+        #define BIT_MANIP_TARGET_BMI2
+    #endif
+
+BIT_MANIP_TARGET_BMI2 inline std::uint64_t Pext(const std::uint64_t val,
+                                                 const std::uint64_t mask) noexcept {
+    return _pext_u64(val, mask);
+}
+
+BIT_MANIP_TARGET_BMI2 inline std::uint32_t Pext(const std::uint32_t val,
+                                                 const std::uint32_t mask) noexcept {
+    return _pext_u32(val, mask);
+}
+
+BIT_MANIP_TARGET_BMI2 inline std::uint64_t Pdep(const std::uint64_t val,
+                                                 const std::uint64_t mask) noexcept {
+    return _pdep_u64(val, mask);
+}
+
+BIT_MANIP_TARGET_BMI2 inline std::uint32_t Pdep(const std::uint32_t val,
+                                                 const std::uint32_t mask) noexcept {
+    return _pdep_u32(val, mask);
+}
+
+#endif
+
+//! The type of BMI2 operands for a value type.
+template <std::unsigned_integral T>
+using Bmi2Operand =
+    std::conditional_t<(sizeof(T) > sizeof(std::uint32_t)), std::uint64_t, std::uint32_t>;
+
+}  // namespace detail
+
+/**
+ * @brief Gather the bits of a value selected by a mask into the low bits of the result.
+ *
+ * @details
+ * It is equivalent to `pext`. For example, `ExtractBits(0b1011'0110, 0b1111'0000)` is `0b1011`.
+ */
+template <std::unsigned_integral T>
+constexpr T ExtractBits(const T val, const std::type_identity_t<T> mask) noexcept {
+#if defined(BIT_MANIP_BMI2)
+    if (!std::is_constant_evaluated() && GetCpuFeatures().fast_pdep) {
+        using Operand = detail::Bmi2Operand<T>;
+        return static_cast<T>(detail::Pext(static_cast<Operand>(val), static_cast<Operand>(mask)));
+    }
+#endif
+    return detail::CompressBits(val, mask);
+}
+
+/**
+ * @brief Scatter the low bits of a value to the bits selected by a mask.
+ *
+ * @details
+ * It is equivalent to `pdep`. For example, `DepositBits(0b1011, 0b1111'0000)` is `0b1011'0000`.
+ */
+template <std::unsigned_integral T>
+constexpr T DepositBits(const T val, const std::type_identity_t<T> mask) noexcept {
+#if defined(BIT_MANIP_BMI2)
+    if (!std::is_constant_evaluated() && GetCpuFeatures().fast_pdep) {
+        using Operand = detail::Bmi2Operand<T>;
+        return static_cast<T>(detail::Pdep(static_cast<Operand>(val), static_cast<Operand>(mask)));
+    }
+#endif
+    return detail::ExpandBits(val, mask);
+}
+
+}  // namespace bit
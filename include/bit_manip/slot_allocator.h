@@ -0,0 +1,212 @@
+/**
+ * @file slot_allocator.h
+ * @brief A lock-free allocator of integer slots backed by a two-level bitmap.
+ *
+ * @details
+ * Each slot is a bit of a leaf quad word, set while the slot is allocated.
+ * A summary bit per leaf word is set while the word is full,
+ * so a scan skips 64 full words with one load.
+ * Slots are claimed with an atomic test-and-set and released with an atomic clear.
+ * Each thread starts scanning from its own cache line to avoid false sharing.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "aligned_allocator.h"
+#include "atomic.h"
+#include "bit_manip.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bit {
+
+//! A thread-safe allocator of slot indices from `0` to `capacity - 1`.
+class SlotAllocator {
+public:
+    using Word = std::uint64_t;
+    using size_type = std::size_t;
+
+    //! The index returned when no slot is free.
+    static constexpr size_type npos {static_cast<size_type>(-1)};
+
+    //! Create an allocator with `capacity` free slots.
+    explicit SlotAllocator(const size_type capacity) :
+        words_((capacity + word_width - 1) / word_width),
+        summary_((words_.size() + word_width - 1) / word_width),
+        capacity_ {capacity} {
+        // Bits beyond the capacity stay allocated forever and are never returned.
+        if (capacity % word_width != 0) {
+            FillBits(words_.back(), capacity % word_width, word_width - capacity % word_width);
+        }
+
+        if (words_.size() % word_width != 0) {
+            FillBits(summary_.back(), words_.size() % word_width,
+                     word_width - words_.size() % word_width);
+        }
+    }
+
+    SlotAllocator(const SlotAllocator&) = delete;
+    SlotAllocator& operator=(const SlotAllocator&) = delete;
+
+    constexpr size_type capacity() const noexcept {
+        return capacity_;
+    }
+
+    //! Allocate a free slot, or return `npos` if all slots are allocated.
+    size_type Allocate() noexcept {
+        if (words_.empty()) {
+            return npos;
+        }
+
+        auto& hint {ThreadHint()};
+        const auto start {hint < words_.size() ? hint : StartWord()};
+        const auto first_summary {start / word_width};
+        // Visit the first summary word twice: from the start and then the words before it.
+        for (size_type step {0}; step <= summary_.size(); ++step) {
+            const auto idx {(first_summary + step) % summary_.size()};
+            auto candidates {static_cast<Word>(~AtomicRef(summary_[idx]).load())};
+            if (step == 0) {
+                ClearBits(candidates, 0, start % word_width);
+            } else if (step == summary_.size()) {
+                candidates = GetBits(candidates, 0, start % word_width);
+            }
+
+            for (; candidates != 0; candidates &= candidates - 1) {
+                const auto word {idx * word_width
+                                 + static_cast<size_type>(std::countr_zero(candidates))};
+                if (const auto slot {AllocateIn(word)}; slot != npos) {
+                    hint = word;
+                    return slot;
+                }
+            }
+        }
+
+        return npos;
+    }
+
+    //! Free an allocated slot.
+    void Free(const size_type slot) noexcept {
+        assert(slot < capacity_);
+        const auto word {slot / word_width};
+        [[maybe_unused]] const auto allocated {
+            AtomicTestAndClearBit(words_[word], slot % word_width)};
+        assert(allocated);
+        if (AtomicIsBitSet(summary_[word / word_width], word % word_width)) {
+            AtomicClearBit(summary_[word / word_width], word % word_width);
+        }
+    }
+
+    //! Check if a slot is allocated.
+    bool IsAllocated(const size_type slot) const noexcept {
+        assert(slot < capacity_);
+        return AtomicIsBitSet(words_[slot / word_width], slot % word_width);
+    }
+
+    /**
+     * @brief Count the allocated slots.
+     *
+     * @details
+     * The count is exact only while no other thread allocates or frees slots.
+     */
+    size_type Count() const noexcept {
+        size_type count {0};
+        for (auto& word : words_) {
+            count += static_cast<size_type>(std::popcount(AtomicRef(word).load()));
+        }
+
+        const auto padding {words_.size() * word_width - capacity_};
+        return count - padding;
+    }
+
+private:
+    using Storage = std::vector<Word, AlignedAllocator<Word>>;
+
+    static constexpr std::size_t word_width {sizeof(Word) * CHAR_BIT};
+    static constexpr std::size_t line_words {cache_line_size / sizeof(Word)};
+    static constexpr Word full {static_cast<Word>(-1)};
+
+    //! The last word where the calling thread allocated a slot in an allocator.
+    struct Hint {
+        const SlotAllocator* owner {nullptr};
+        size_type word {npos};
+    };
+
+    /**
+     * @brief The last word where the calling thread allocated a slot in this allocator.
+     *
+     * @details
+     * Each thread remembers one allocator, so switching to another one starts from its `StartWord`.
+     */
+    size_type& ThreadHint() const noexcept {
+        thread_local Hint hint;
+        if (hint.owner != this) {
+            hint = {this, npos};
+        }
+
+        return hint.word;
+    }
+
+    static std::atomic_ref<Word> AtomicRef(Word& word) noexcept {
+        return detail::AtomicRef(word);
+    }
+
+    //! Spread the first words of threads over different cache lines.
+    size_type StartWord() const noexcept {
+        static std::atomic<size_type> next_thread {0};
+        thread_local const size_type thread {next_thread.fetch_add(1, std::memory_order_relaxed)};
+        const auto lines {(words_.size() + line_words - 1) / line_words};
+        const auto line {static_cast<size_type>(thread * 0x9E3779B97F4A7C15 % lines)};
+        return std::min(line * line_words, words_.size() - 1);
+    }
+
+    //! Try to allocate a slot in a leaf word.
+    size_type AllocateIn(const size_type word) noexcept {
+        auto& leaf {words_[word]};
+        for (auto val {AtomicRef(leaf).load(std::memory_order_relaxed)}; val != full;
+             val = AtomicRef(leaf).load(std::memory_order_relaxed)) {
+            const auto bit {static_cast<size_type>(std::countr_one(val))};
+            if (!AtomicTestAndSetBit(leaf, bit)) {
+                if (AtomicRef(leaf).load() == full) {
+                    MarkFull(word);
+                }
+
+                return word * word_width + bit;
+            }
+        }
+
+        MarkFull(word);
+        return npos;
+    }
+
+    /**
+     * @brief Set the summary bit of a full leaf word.
+     *
+     * @details
+     * A slot may be freed between seeing the word full and setting its summary bit,
+     * so the word is checked again. Either this check or the freeing thread clears the bit.
+     */
+    void MarkFull(const size_type word) noexcept {
+        auto& summary {summary_[word / word_width]};
+        AtomicSetBit(summary, word % word_width);
+        if (AtomicRef(words_[word]).load() != full) {
+            AtomicClearBit(summary, word % word_width);
+        }
+    }
+
+    // Words are only accessed atomically, so const queries can load them too.
+    mutable Storage words_;
+    mutable Storage summary_;
+    size_type capacity_ {0};
+};
+
+}  // namespace bit
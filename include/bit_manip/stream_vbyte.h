@@ -0,0 +1,237 @@
+/**
+ * @file stream_vbyte.h
+ * @brief Stream VByte coding of 32-bit unsigned integers.
+ *
+ * @details
+ * Each value takes 1 to 4 little-endian bytes.
+ * Lengths are stored apart from the data:
+ * every control byte holds the 2-bit length codes of four values,
+ * and all control bytes come before all data bytes.
+ *
+ * Decoding four values needs one control byte and one byte shuffle
+ * from a 256-entry table built at compile time, without branching on their lengths.
+ * Delta variants code the differences between neighboring values modulo `2^32`,
+ * so sorted sequences take fewer bytes.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "dispatch.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace bit {
+
+//! The number of control bytes of `count` values.
+constexpr std::size_t StreamVByteControlSize(const std::size_t count) noexcept {
+    return (count + 3) / 4;
+}
+
+//! The largest number of bytes of `count` encoded values.
+constexpr std::size_t StreamVByteMaxSize(const std::size_t count) noexcept {
+    return StreamVByteControlSize(count) + count * sizeof(std::uint32_t);
+}
+
+namespace detail {
+
+//! The number of data bytes of a value.
+constexpr std::size_t StreamVByteLength(const std::uint32_t val) noexcept {
+    return std::max<std::size_t>(1, (static_cast<std::size_t>(std::bit_width(val)) + 7) / 8);
+}
+
+//! A shuffle that decodes four values from the data bytes of a control byte.
+struct StreamVByteShuffle {
+    //! The source bytes of the 32-bit lanes. `0x80` clears a byte.
+    alignas(16) std::array<std::uint8_t, 16> lanes;
+
+    //! The number of data bytes of the four values.
+    std::uint8_t size;
+};
+
+//! Build a shuffle for each control byte.
+constexpr std::array<StreamVByteShuffle, 256> MakeStreamVByteShuffles() noexcept {
+    std::array<StreamVByteShuffle, 256> shuffles {};
+    for (std::size_t ctrl {0}; ctrl != shuffles.size(); ++ctrl) {
+        auto& shuffle {shuffles[ctrl]};
+        shuffle.lanes.fill(0x80);
+        std::size_t size {0};
+        for (std::size_t i {0}; i != 4; ++i) {
+            const auto len {GetBits(ctrl, i * 2, 2) + 1};
+            for (std::size_t byte {0}; byte != len; ++byte) {
+                shuffle.lanes[i * sizeof(std::uint32_t) + byte] =
+                    static_cast<std::uint8_t>(size++);
+            }
+        }
+
+        shuffle.size = static_cast<std::uint8_t>(size);
+    }
+
+    return shuffles;
+}
+
+inline constexpr auto stream_vbyte_shuffles {MakeStreamVByteShuffles()};
+
+template <bool Delta>
+std::size_t EncodeStreamVByte(const std::span<const std::uint32_t> vals,
+                              const std::span<std::uint8_t> out, std::uint32_t prev) noexcept {
+    const auto control_size {StreamVByteControlSize(vals.size())};
+    assert(out.size() >= control_size);
+    std::size_t pos {control_size};
+    std::uint8_t ctrl {0};
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        auto val {vals[i]};
+        if constexpr (Delta) {
+            val -= std::exchange(prev, vals[i]);
+        }
+
+        const auto len {StreamVByteLength(val)};
+        assert(out.size() - pos >= len);
+        SetBits(ctrl, len - 1, i % 4 * 2, 2);
+        for (std::size_t byte {0}; byte != len; ++byte) {
+            out[pos++] = GetByte(val, byte * CHAR_BIT);
+        }
+
+        if (i % 4 == 3 || i == vals.size() - 1) {
+            out[i / 4] = std::exchange(ctrl, 0);
+        }
+    }
+
+    return pos;
+}
+
+#if defined(BIT_MANIP_SSSE3)
+
+/**
+ * @brief Decode groups of four values with SSSE3 while 16 data bytes remain.
+ *
+ * @details
+ * Delta decoding adds the previous value to a prefix sum of the four lanes.
+ */
+template <bool Delta>
+BIT_MANIP_TARGET_SSSE3 void DecodeStreamVByteSsse3(const std::span<const std::uint8_t> controls,
+                                                   const std::span<const std::uint8_t> data,
+                                                   const std::span<std::uint32_t> out,
+                                                   std::size_t& pos, std::size_t& i,
+                                                   std::uint32_t& prev) noexcept {
+    constexpr std::size_t window {sizeof(__m128i)};
+    auto read {pos};
+    auto written {i};
+    auto last {_mm_set1_epi32(static_cast<int>(prev))};
+    while (out.size() - written >= 4 && data.size() - read >= window) {
+        const auto& shuffle {stream_vbyte_shuffles[controls[written / 4]]};
+        const auto bytes {_mm_loadu_si128(reinterpret_cast<const __m128i*>(data.data() + read))};
+        const auto* const lanes {reinterpret_cast<const __m128i*>(shuffle.lanes.data())};
+        auto vals {_mm_shuffle_epi8(bytes, _mm_load_si128(lanes))};
+        if constexpr (Delta) {
+            vals = _mm_add_epi32(vals, _mm_slli_si128(vals, 4));
+            vals = _mm_add_epi32(vals, _mm_slli_si128(vals, 8));
+            vals = _mm_add_epi32(vals, last);
+            last = _mm_shuffle_epi32(vals, 0xFF);
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + written), vals);
+        read += shuffle.size;
+        written += 4;
+    }
+
+    pos = read;
+    i = written;
+    prev = static_cast<std::uint32_t>(_mm_cvtsi128_si32(last));
+}
+
+#endif
+
+template <bool Delta>
+std::size_t DecodeStreamVByte(const std::span<const std::uint8_t> in,
+                              const std::span<std::uint32_t> out, std::uint32_t prev) noexcept {
+    const auto control_size {StreamVByteControlSize(out.size())};
+    assert(in.size() >= control_size);
+    const auto controls {in.first(control_size)};
+    const auto data {in.subspan(control_size)};
+    std::size_t pos {0};
+    std::size_t i {0};
+#if defined(BIT_MANIP_SSSE3)
+    if (CanUseSsse3()) {
+        DecodeStreamVByteSsse3<Delta>(controls, data, out, pos, i, prev);
+    }
+#endif
+    for (; i != out.size(); ++i) {
+        const auto len {static_cast<std::size_t>(GetBits(controls[i / 4], i % 4 * 2, 2)) + 1};
+        assert(data.size() - pos >= len);
+        std::uint32_t val {0};
+        for (std::size_t byte {0}; byte != len; ++byte) {
+            val |= static_cast<std::uint32_t>(data[pos++]) << (byte * CHAR_BIT);
+        }
+
+        if constexpr (Delta) {
+            prev += val;
+            val = prev;
+        }
+
+        out[i] = val;
+    }
+
+    return control_size + pos;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Encode values into control bytes followed by data bytes.
+ *
+ * @param out A span of at least `StreamVByteMaxSize(vals.size())` bytes.
+ * @return The number of written bytes.
+ */
+inline std::size_t EncodeStreamVByte(const std::span<const std::uint32_t> vals,
+                                     const std::span<std::uint8_t> out) noexcept {
+    return detail::EncodeStreamVByte<false>(vals, out, 0);
+}
+
+/**
+ * @brief Decode `out.size()` values from trusted input.
+ *
+ * @return The number of read bytes.
+ */
+inline std::size_t DecodeStreamVByte(const std::span<const std::uint8_t> in,
+                                     const std::span<std::uint32_t> out) noexcept {
+    return detail::DecodeStreamVByte<false>(in, out, 0);
+}
+
+/**
+ * @brief Encode the differences between neighboring values.
+ *
+ * @param out A span of at least `StreamVByteMaxSize(vals.size())` bytes.
+ * @param prev The value before the first one.
+ * @return The number of written bytes.
+ */
+inline std::size_t EncodeStreamVByteDelta(const std::span<const std::uint32_t> vals,
+                                          const std::span<std::uint8_t> out,
+                                          const std::uint32_t prev = 0) noexcept {
+    return detail::EncodeStreamVByte<true>(vals, out, prev);
+}
+
+/**
+ * @brief Decode `out.size()` values coded as differences from trusted input.
+ *
+ * @param prev The value before the first one.
+ * @return The number of read bytes.
+ */
+inline std::size_t DecodeStreamVByteDelta(const std::span<const std::uint8_t> in,
+                                          const std::span<std::uint32_t> out,
+                                          const std::uint32_t prev = 0) noexcept {
+    return detail::DecodeStreamVByte<true>(in, out, prev);
+}
+
+}  // namespace bit
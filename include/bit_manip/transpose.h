@@ -0,0 +1,294 @@
+/**
+ * @file transpose.h
+ * @brief Transposing bit matrices.
+ *
+ * @details
+ * A matrix is stored as rows of unsigned integers, so bit `j` of row `i` is `IsBitSet(rows[i], j)`.
+ * Square matrices are transposed by swapping off-diagonal blocks of halving sizes.
+ * Bulk transposes gather one byte of 16 or 32 rows into each vector register with byte unpacks,
+ * then extract one column at a time with `movemask`.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "aligned_allocator.h"
+#include "bit_manip.h"
+#include "dispatch.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+namespace bit {
+
+/**
+ * @brief Transpose an 8 × 8 bit matrix whose row `i` is byte `i`.
+ *
+ * @details
+ * Bit `j` of byte `i` becomes bit `i` of byte `j`.
+ */
+constexpr std::uint64_t Transpose8x8(std::uint64_t val) noexcept {
+    // Swap the off-diagonal bits of 2 × 2 blocks, then 2 × 2 blocks of 4 × 4 blocks and so on.
+    auto swapped {(val ^ (val >> 7)) & 0x00AA'00AA'00AA'00AA};
+    val ^= swapped ^ (swapped << 7);
+    swapped = (val ^ (val >> 14)) & 0x0000'CCCC'0000'CCCC;
+    val ^= swapped ^ (swapped << 14);
+    swapped = (val ^ (val >> 28)) & 0x0000'0000'F0F0'F0F0;
+    return val ^ swapped ^ (swapped << 28);
+}
+
+/**
+ * @brief Transpose a 64 × 64 bit matrix in place.
+ *
+ * @details
+ * Bit `j` of row `i` becomes bit `i` of row `j`.
+ * Each step swaps the off-diagonal blocks of all sub-matrices twice as small as the last.
+ */
+constexpr void Transpose64x64(const std::span<std::uint64_t, 64> rows) noexcept {
+    std::uint64_t mask {0x0000'0000'FFFF'FFFF};
+    for (std::size_t width {32}; width != 0; width /= 2, mask ^= mask << width) {
+        for (std::size_t i {0}; i != rows.size(); i = (i + width + 1) & ~width) {
+            const auto swapped {((rows[i] >> width) ^ rows[i + width]) & mask};
+            rows[i] ^= swapped << width;
+            rows[i + width] ^= swapped;
+        }
+    }
+}
+
+namespace detail {
+
+//! The number of rows in a column word.
+inline constexpr std::size_t column_word_rows {sizeof(std::uint64_t) * CHAR_BIT};
+
+//! The number of words of each column that bulk kernels collect before storing them.
+inline constexpr std::size_t column_line_words {cache_line_size / sizeof(std::uint64_t)};
+
+//! Store the bits of `T` consecutive rows starting at `row` into a line of a column.
+template <std::unsigned_integral T>
+void StoreColumnBits(std::uint64_t (&line)[column_line_words], const std::size_t row,
+                     const T bits) noexcept {
+    constexpr std::size_t bit_count {sizeof(T) * CHAR_BIT};
+    assert(row % bit_count == 0);
+    SetBits(line[row / column_word_rows], bits, row % column_word_rows, bit_count);
+}
+
+//! Store `count` collected words of each column starting at word `first`.
+template <std::size_t Cols>
+void StoreColumnLines(const std::uint64_t (&lines)[Cols][column_line_words],
+                      std::uint64_t* const* const cols, const std::size_t first,
+                      const std::size_t count) noexcept {
+    for (std::size_t j {0}; j != Cols; ++j) {
+        std::copy_n(lines[j], count, cols[j] + first);
+    }
+}
+
+#if defined(__SSE2__)
+
+//! Vector registers with 16 rows, holding one byte of all rows each once interleaved.
+template <std::size_t Size>
+struct ByteColumnsSse2 {
+    __m128i regs[Size];
+};
+
+//! Load 16 rows of `Size` bytes.
+template <std::size_t Size, std::size_t... K>
+ByteColumnsSse2<Size> LoadRowsSse2(const std::uint8_t* const src,
+                                    std::index_sequence<K...>) noexcept {
+    return {{_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + K * sizeof(__m128i)))...}};
+}
+
+//! Interleave the bytes of registers half the registers apart.
+template <std::size_t Size, std::size_t... K>
+ByteColumnsSse2<Size> InterleaveSse2(const ByteColumnsSse2<Size>& cols,
+                                      std::index_sequence<K...>) noexcept {
+    constexpr std::size_t half {Size / 2};
+    return {{(K % 2 == 0 ? _mm_unpacklo_epi8(cols.regs[K / 2], cols.regs[K / 2 + half])
+                         : _mm_unpackhi_epi8(cols.regs[K / 2], cols.regs[K / 2 + half]))...}};
+}
+
+//! Store the eight columns of a register of bytes.
+inline void StoreColumnsSse2(__m128i reg, std::uint64_t (*const lines)[column_line_words],
+                             const std::size_t row) noexcept {
+    for (std::size_t bit {CHAR_BIT}; bit-- != 0;) {
+        StoreColumnBits(lines[bit], row, static_cast<std::uint16_t>(_mm_movemask_epi8(reg)));
+        // Shift each byte left to move the next bit to the top.
+        reg = _mm_add_epi8(reg, reg);
+    }
+}
+
+/**
+ * @brief Transpose rows of `Size` bytes into columns 16 rows at a time with SSE2.
+ *
+ * @details
+ * Four rounds of byte unpacks leave byte `b` of 16 rows in register `b`.
+ * Columns are usually far apart in memory and conflict in the cache,
+ * so a cache line of each column is collected before it is stored.
+ * Rows from `first`, which is a multiple of 64, are transposed in whole column words.
+ *
+ * @return The first row left.
+ */
+template <std::size_t Size>
+std::size_t TransposeSse2(const void* const rows, const std::size_t first, const std::size_t size,
+                          std::uint64_t* const* const cols) noexcept {
+    constexpr std::size_t lanes {sizeof(__m128i)};
+    constexpr std::make_index_sequence<Size> regs;
+    const auto* const src {static_cast<const std::uint8_t*>(rows)};
+    const auto end {size / column_word_rows * column_word_rows};
+    for (auto i {first}; i < end; i += column_word_rows * column_line_words) {
+        const auto count {std::min(column_line_words, (end - i) / column_word_rows)};
+        std::uint64_t lines[Size * CHAR_BIT][column_line_words] {};
+        for (std::size_t row {0}; row != count * column_word_rows; row += lanes) {
+            auto bytes {LoadRowsSse2<Size>(src + (i + row) * Size, regs)};
+            if constexpr (Size > 1) {
+                for (std::size_t round {0}; round != 4; ++round) {
+                    bytes = InterleaveSse2<Size>(bytes, regs);
+                }
+            }
+
+            [&]<std::size_t... K>(std::index_sequence<K...>) {
+                (StoreColumnsSse2(bytes.regs[K], lines + K * CHAR_BIT, row), ...);
+            }(regs);
+        }
+
+        StoreColumnLines(lines, cols, i / column_word_rows, count);
+    }
+
+    return std::max(first, end);
+}
+
+#endif
+
+#if defined(BIT_MANIP_DISPATCH)
+
+//! Vector registers with 32 rows, holding one byte of all rows each once interleaved.
+template <std::size_t Size>
+struct ByteColumnsAvx2 {
+    __m256i regs[Size];
+};
+
+//! Load 32 rows of `Size` bytes, with the first 16 rows in the low halves.
+template <std::size_t Size, std::size_t... K>
+BIT_MANIP_TARGET_AVX2 ByteColumnsAvx2<Size> LoadRowsAvx2(const std::uint8_t* const src,
+                                                         std::index_sequence<K...>) noexcept {
+    constexpr std::size_t half {sizeof(__m128i)};
+    return {{_mm256_inserti128_si256(
+        _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + K * half))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (K + Size) * half)), 1)...}};
+}
+
+//! Interleave the bytes of registers half the registers apart within each half.
+template <std::size_t Size, std::size_t... K>
+BIT_MANIP_TARGET_AVX2 ByteColumnsAvx2<Size> InterleaveAvx2(const ByteColumnsAvx2<Size>& cols,
+                                                           std::index_sequence<K...>) noexcept {
+    constexpr std::size_t half {Size / 2};
+    return {{(K % 2 == 0 ? _mm256_unpacklo_epi8(cols.regs[K / 2], cols.regs[K / 2 + half])
+                         : _mm256_unpackhi_epi8(cols.regs[K / 2], cols.regs[K / 2 + half]))...}};
+}
+
+//! Store the eight columns of a register of bytes.
+BIT_MANIP_TARGET_AVX2 inline void StoreColumnsAvx2(__m256i reg,
+                                                   std::uint64_t (*const lines)[column_line_words],
+                                                   const std::size_t row) noexcept {
+    for (std::size_t bit {CHAR_BIT}; bit-- != 0;) {
+        StoreColumnBits(lines[bit], row, static_cast<std::uint32_t>(_mm256_movemask_epi8(reg)));
+        reg = _mm256_add_epi8(reg, reg);
+    }
+}
+
+//! Store the columns of all registers.
+template <std::size_t Size, std::size_t... K>
+BIT_MANIP_TARGET_AVX2 void StoreColumnsAvx2(const ByteColumnsAvx2<Size>& bytes,
+                                            std::uint64_t (*const lines)[column_line_words],
+                                            const std::size_t row,
+                                            std::index_sequence<K...>) noexcept {
+    (StoreColumnsAvx2(bytes.regs[K], lines + K * CHAR_BIT, row), ...);
+}
+
+/**
+ * @brief Transpose rows of `Size` bytes into columns 32 rows at a time with AVX2.
+ *
+ * @details
+ * The low and high halves of each register hold 16 rows each,
+ * so the byte unpacks of `TransposeSse2` work within halves and `movemask` yields 32 rows in order.
+ *
+ * @return The first row left.
+ */
+template <std::size_t Size>
+BIT_MANIP_TARGET_AVX2 std::size_t TransposeAvx2(const void* const rows, const std::size_t first,
+                                                const std::size_t size,
+                                                std::uint64_t* const* const cols) noexcept {
+    constexpr std::size_t lanes {sizeof(__m256i)};
+    constexpr std::make_index_sequence<Size> regs;
+    const auto* const src {static_cast<const std::uint8_t*>(rows)};
+    const auto end {size / column_word_rows * column_word_rows};
+    for (auto i {first}; i < end; i += column_word_rows * column_line_words) {
+        const auto count {std::min(column_line_words, (end - i) / column_word_rows)};
+        std::uint64_t lines[Size * CHAR_BIT][column_line_words] {};
+        for (std::size_t row {0}; row != count * column_word_rows; row += lanes) {
+            auto bytes {LoadRowsAvx2<Size>(src + (i + row) * Size, regs)};
+            if constexpr (Size > 1) {
+                for (std::size_t round {0}; round != 4; ++round) {
+                    bytes = InterleaveAvx2<Size>(bytes, regs);
+                }
+            }
+
+            StoreColumnsAvx2<Size>(bytes, lines, row, regs);
+        }
+
+        StoreColumnLines(lines, cols, i / column_word_rows, count);
+    }
+
+    return std::max(first, end);
+}
+
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief Transpose rows of unsigned integers into bit columns.
+ *
+ * @details
+ * Bit `i` of column `j` is bit `j` of `rows[i]`.
+ * Columns are stored in quad words, least significant bit first, like `Bitset`.
+ * Each column needs `(rows.size() + 63) / 64` words, and its bits beyond the rows are cleared.
+ */
+template <std::unsigned_integral T>
+void Transpose(const std::span<const std::type_identity_t<T>> rows,
+               const std::span<std::uint64_t* const, sizeof(T) * CHAR_BIT> cols) noexcept {
+    std::size_t i {0};
+#if defined(BIT_MANIP_DISPATCH)
+    if (GetCpuFeatures().avx2) {
+        i = detail::TransposeAvx2<sizeof(T)>(rows.data(), i, rows.size(), cols.data());
+    }
+#endif
+#if defined(__SSE2__)
+    i = detail::TransposeSse2<sizeof(T)>(rows.data(), i, rows.size(), cols.data());
+#endif
+    std::array<std::uint64_t, detail::column_word_rows> block;
+    for (; i < rows.size(); i += block.size()) {
+        const auto count {std::min(block.size(), rows.size() - i)};
+        std::ranges::copy(rows.subspan(i, count), block.begin());
+        std::fill(block.begin() + count, block.end(), 0);
+        Transpose64x64(block);
+        for (std::size_t j {0}; j != cols.size(); ++j) {
+            cols[j][i / block.size()] = block[j];
+        }
+    }
+}
+
+}  // namespace bit
@@ -0,0 +1,496 @@
+/**
+ * @file varint.h
+ * @brief LEB128 variable-length coding of 64-bit unsigned integers.
+ *
+ * @details
+ * Each byte holds seven bits of a value from least to most significant,
+ * and its most significant bit is set if more bytes follow.
+ * A value takes 1 to 10 bytes.
+ *
+ * Bulk encoding narrows eight values of up to 2 bytes to 16-bit lanes with SSSE3
+ * and packs their bytes with a shuffle chosen by which of them take 2 bytes.
+ *
+ * Bulk decoding follows *Masked VByte*.
+ * A SIMD byte mask of the continuation bits shows where values end.
+ * With SSSE3, the mask of 8 bytes chooses a shuffle from a compile-time table
+ * that decodes all values of up to 2 bytes in them at once.
+ * Other values are decoded from one 8-byte load,
+ * joining their 7-bit groups with a few shifts.
+ *
+ * Checked variants never read beyond their input and reject truncated values
+ * and values beyond 64 bits, so they are safe for untrusted input.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include "bit_manip.h"
+#include "dispatch.h"
+#include "endian.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <tuple>
+#include <utility>
+
+#if defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+namespace bit {
+
+//! The largest number of bytes of an encoded 64-bit value.
+inline constexpr std::size_t max_varint_size {10};
+
+//! The number of bytes of an encoded value.
+constexpr std::size_t VarintSize(const std::uint64_t val) noexcept {
+    return std::max<std::size_t>(1, (static_cast<std::size_t>(std::bit_width(val)) + 6) / 7);
+}
+
+/**
+ * @brief Encode a value.
+ *
+ * @param out A span of at least `VarintSize(val)` bytes.
+ * @return The number of written bytes.
+ */
+constexpr std::size_t EncodeVarint(std::uint64_t val, const std::span<std::uint8_t> out) noexcept {
+    assert(out.size() >= VarintSize(val));
+    std::size_t size {0};
+    for (; val >= 0x80; val >>= 7) {
+        out[size++] = static_cast<std::uint8_t>(GetBits(val, 0, 7) | 0x80);
+    }
+
+    out[size++] = static_cast<std::uint8_t>(val);
+    return size;
+}
+
+/**
+ * @brief Decode a value from trusted input.
+ *
+ * @details
+ * The input must start with a complete value.
+ *
+ * @return The number of read bytes.
+ */
+constexpr std::size_t DecodeVarint(const std::span<const std::uint8_t> in,
+                                   std::uint64_t& val) noexcept {
+    val = 0;
+    for (std::size_t i {0};; ++i) {
+        assert(i < in.size() && i < max_varint_size);
+        const auto byte {in[i]};
+        val |= static_cast<std::uint64_t>(GetBits(byte, 0, 7)) << (i * 7);
+        if (!IsBitSet(byte, 7)) {
+            return i + 1;
+        }
+    }
+}
+
+/**
+ * @brief Decode a value from untrusted input.
+ *
+ * @return
+ * The number of read bytes, or nothing if the value is truncated or does not fit in 64 bits.
+ */
+constexpr std::optional<std::size_t> DecodeVarintChecked(const std::span<const std::uint8_t> in,
+                                                         std::uint64_t& val) noexcept {
+    val = 0;
+    for (std::size_t i {0}; i != std::min(in.size(), max_varint_size); ++i) {
+        const auto byte {in[i]};
+        // The last byte can only hold the highest bit of a value.
+        if (i == max_varint_size - 1 && byte > 1) {
+            return std::nullopt;
+        }
+
+        val |= static_cast<std::uint64_t>(GetBits(byte, 0, 7)) << (i * 7);
+        if (!IsBitSet(byte, 7)) {
+            return i + 1;
+        }
+    }
+
+    return std::nullopt;
+}
+
+namespace detail {
+
+//! The continuation bits of a quad word of encoded bytes.
+inline constexpr std::uint64_t varint_continuations {0x8080'8080'8080'8080};
+
+/**
+ * @brief Join the 7-bit groups of up to 8 encoded bytes, ignoring continuation bits.
+ *
+ * @details
+ * Neighboring groups are merged into 14-bit, 28-bit and then 56-bit groups,
+ * which takes six shifts instead of one per byte.
+ */
+constexpr std::uint64_t JoinVarintGroups(std::uint64_t word) noexcept {
+    word &= ~varint_continuations;
+    word = ((word & 0x7F00'7F00'7F00'7F00) >> 1) | (word & 0x007F'007F'007F'007F);
+    word = ((word & 0x3FFF'0000'3FFF'0000) >> 2) | (word & 0x0000'3FFF'0000'3FFF);
+    return ((word & 0x0FFF'FFFF'0000'0000) >> 4) | (word & 0x0000'0000'0FFF'FFFF);
+}
+
+/**
+ * @brief Decode a value of up to 8 bytes from a little-endian quad word.
+ *
+ * @return The number of read bytes, or `0` if the value is longer than 8 bytes.
+ */
+constexpr std::size_t DecodeVarintWord(const std::uint64_t word, std::uint64_t& val) noexcept {
+    const auto stops {~word & varint_continuations};
+    if (stops == 0) {
+        return 0;
+    }
+
+    const auto size {static_cast<std::size_t>(std::countr_zero(stops)) / CHAR_BIT + 1};
+    val = JoinVarintGroups(GetBits(word, 0, size * CHAR_BIT));
+    return size;
+}
+
+#if defined(__SSE2__)
+
+//! Widen eight 16-bit lanes to quad words.
+inline void WidenWords(const __m128i words, std::uint64_t* const out) noexcept {
+    const auto zero {_mm_setzero_si128()};
+    const __m128i dwords[] {_mm_unpacklo_epi16(words, zero), _mm_unpackhi_epi16(words, zero)};
+    for (std::size_t i {0}; i != 2; ++i) {
+        auto* const dest {reinterpret_cast<__m128i*>(out + i * 4)};
+        _mm_storeu_si128(dest, _mm_unpacklo_epi32(dwords[i], zero));
+        _mm_storeu_si128(dest + 1, _mm_unpackhi_epi32(dwords[i], zero));
+    }
+}
+
+//! Widen 16 bytes to quad words.
+inline void WidenBytes(const __m128i bytes, std::uint64_t* const out) noexcept {
+    const auto zero {_mm_setzero_si128()};
+    WidenWords(_mm_unpacklo_epi8(bytes, zero), out);
+    WidenWords(_mm_unpackhi_epi8(bytes, zero), out + 8);
+}
+
+#endif
+
+#if defined(BIT_MANIP_SSSE3)
+
+//! A shuffle that decodes the values of up to 2 bytes ending in an 8-byte window.
+struct VarintShuffle {
+    //! The source bytes of the 16-bit lanes. `0x80` clears a byte.
+    alignas(16) std::array<std::uint8_t, 16> lanes;
+
+    //! The number of decoded values.
+    std::uint8_t count;
+
+    //! The number of bytes they take.
+    std::uint8_t size;
+};
+
+//! Build a shuffle for each pattern of continuation bits in an 8-byte window.
+constexpr std::array<VarintShuffle, 256> MakeVarintShuffles() noexcept {
+    std::array<VarintShuffle, 256> shuffles {};
+    for (std::size_t mask {0}; mask != shuffles.size(); ++mask) {
+        auto& shuffle {shuffles[mask]};
+        shuffle.lanes.fill(0x80);
+        std::size_t begin {0};
+        std::size_t count {0};
+        while (begin != CHAR_BIT) {
+            auto end {begin};
+            while (end != CHAR_BIT && IsBitSet(mask, end)) {
+                ++end;
+            }
+
+            // Stop before a value that continues after the window or takes more than 2 bytes.
+            if (end == CHAR_BIT || end - begin > 1) {
+                break;
+            }
+
+            shuffle.lanes[count * 2] = static_cast<std::uint8_t>(begin);
+            if (end != begin) {
+                shuffle.lanes[count * 2 + 1] = static_cast<std::uint8_t>(end);
+            }
+
+            ++count;
+            begin = end + 1;
+        }
+
+        shuffle.count = static_cast<std::uint8_t>(count);
+        shuffle.size = static_cast<std::uint8_t>(begin);
+    }
+
+    return shuffles;
+}
+
+inline constexpr auto varint_shuffles {MakeVarintShuffles()};
+
+//! A shuffle that packs eight values of up to 2 bytes from 16-bit lanes.
+struct VarintPack {
+    //! The source bytes of the packed bytes. `0x80` clears a byte.
+    alignas(16) std::array<std::uint8_t, 16> bytes;
+
+    //! The number of packed bytes.
+    std::uint8_t size;
+};
+
+//! Build a shuffle for each pattern of two-byte values in eight 16-bit lanes.
+constexpr std::array<VarintPack, 256> MakeVarintPacks() noexcept {
+    std::array<VarintPack, 256> packs {};
+    for (std::size_t mask {0}; mask != packs.size(); ++mask) {
+        auto& pack {packs[mask]};
+        pack.bytes.fill(0x80);
+        std::size_t size {0};
+        for (std::size_t lane {0}; lane != CHAR_BIT; ++lane) {
+            pack.bytes[size++] = static_cast<std::uint8_t>(lane * 2);
+            if (IsBitSet(mask, lane)) {
+                pack.bytes[size++] = static_cast<std::uint8_t>(lane * 2 + 1);
+            }
+        }
+
+        pack.size = static_cast<std::uint8_t>(size);
+    }
+
+    return packs;
+}
+
+inline constexpr auto varint_packs {MakeVarintPacks()};
+
+//! The most values encoded one by one after vector encoding stops.
+inline constexpr std::size_t max_varint_backoff {256};
+
+/**
+ * @brief Encode values with SSSE3 while 8 values of input and 16 bytes of output remain.
+ *
+ * @details
+ * Eight values below `0x4000` are narrowed to 16-bit lanes,
+ * where both of their 7-bit groups and the continuation bit are placed in parallel.
+ * A shuffle chosen by which values take 2 bytes then drops the unused high bytes.
+ * It stops early before a group with a longer value.
+ *
+ * @return The numbers of encoded values and written bytes.
+ */
+BIT_MANIP_TARGET_SSSE3 inline std::pair<std::size_t, std::size_t> EncodeVarintsSsse3(
+    const std::span<const std::uint64_t> vals, const std::span<std::uint8_t> out,
+    const std::size_t i, const std::size_t size) noexcept {
+    constexpr std::size_t group {CHAR_BIT};
+    constexpr std::size_t window {sizeof(__m128i)};
+    const auto zero {_mm_setzero_si128()};
+    const auto long_bits {_mm_set1_epi64x(~std::int64_t {0x3FFF})};
+    const auto low_groups {_mm_set1_epi16(0x007F)};
+    const auto high_groups {_mm_set1_epi16(0x7F00)};
+    const auto continuations {_mm_set1_epi16(0x0080)};
+
+    auto read {i};
+    auto written {size};
+    while (vals.size() - read >= group && out.size() - written >= window) {
+        const auto* const src {reinterpret_cast<const __m128i*>(vals.data() + read)};
+        const __m128i quads[] {_mm_loadu_si128(src), _mm_loadu_si128(src + 1),
+                               _mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3)};
+        const auto any {_mm_or_si128(_mm_or_si128(quads[0], quads[1]),
+                                     _mm_or_si128(quads[2], quads[3]))};
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(any, long_bits), zero)) != 0xFFFF) {
+            break;
+        }
+
+        // Values below `0x4000` pack to 16-bit lanes without saturating.
+        const auto words {_mm_packs_epi32(_mm_packs_epi32(quads[0], quads[1]),
+                                          _mm_packs_epi32(quads[2], quads[3]))};
+        const auto longs {_mm_cmpgt_epi16(words, low_groups)};
+        const auto encoded {
+            _mm_or_si128(_mm_or_si128(_mm_and_si128(words, low_groups),
+                                      _mm_and_si128(_mm_slli_epi16(words, 1), high_groups)),
+                         _mm_and_si128(longs, continuations))};
+
+        const auto mask {static_cast<std::size_t>(_mm_movemask_epi8(_mm_packs_epi16(longs, zero)))};
+        const auto& pack {varint_packs[mask]};
+        const auto* const bytes {reinterpret_cast<const __m128i*>(pack.bytes.data())};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out.data() + written),
+                         _mm_shuffle_epi8(encoded, _mm_load_si128(bytes)));
+        read += group;
+        written += pack.size;
+    }
+
+    return {read, written};
+}
+
+/**
+ * @brief Decode values with SSSE3 while 16 bytes of input and 16 values of output remain.
+ *
+ * @details
+ * Sixteen single-byte values are widened at once.
+ * Otherwise, the values of up to 2 bytes ending in the first 8 bytes are moved to 16-bit lanes
+ * by a shuffle chosen by their continuation bits, and their 7-bit groups are joined in parallel.
+ * A longer value of up to 8 bytes is decoded from a quad word.
+ * It stops early before a value longer than 8 bytes.
+ */
+BIT_MANIP_TARGET_SSSE3 inline void DecodeVarintsSsse3(const std::span<const std::uint8_t> in,
+                                                      const std::span<std::uint64_t> out,
+                                                      std::size_t& pos, std::size_t& i) noexcept {
+    constexpr std::size_t window {sizeof(__m128i)};
+    const auto low_groups {_mm_set1_epi16(0x007F)};
+    const auto high_groups {_mm_set1_epi16(0x7F00)};
+
+    // Local positions cannot alias the output, so they can stay in registers.
+    auto read {pos};
+    auto written {i};
+    while (in.size() - read >= window && out.size() - written >= window) {
+        const auto bytes {_mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + read))};
+        const auto mask {static_cast<std::uint32_t>(_mm_movemask_epi8(bytes))};
+        if (mask == 0) {
+            WidenBytes(bytes, out.data() + written);
+            read += window;
+            written += window;
+            continue;
+        }
+
+        if (const auto& shuffle {varint_shuffles[GetByte(mask, 0)]}; shuffle.count != 0) {
+            const auto* const lanes {reinterpret_cast<const __m128i*>(shuffle.lanes.data())};
+            const auto words {_mm_shuffle_epi8(bytes, _mm_load_si128(lanes))};
+            WidenWords(_mm_or_si128(_mm_and_si128(words, low_groups),
+                                    _mm_srli_epi16(_mm_and_si128(words, high_groups), 1)),
+                       out.data() + written);
+            read += shuffle.size;
+            written += shuffle.count;
+        } else if (const auto size {
+                       DecodeVarintWord(LoadLE<std::uint64_t>(in.data() + read), out[written])};
+                   size != 0) {
+            read += size;
+            ++written;
+        } else {
+            break;
+        }
+    }
+
+    pos = read;
+    i = written;
+}
+
+#endif
+
+template <bool Checked>
+std::optional<std::size_t> DecodeVarints(const std::span<const std::uint8_t> in,
+                                         const std::span<std::uint64_t> out) noexcept {
+    std::size_t pos {0};
+    std::size_t i {0};
+#if defined(BIT_MANIP_SSSE3)
+    const bool ssse3 {CanUseSsse3()};
+#endif
+    while (i != out.size()) {
+#if defined(BIT_MANIP_SSSE3)
+        if (ssse3) {
+            DecodeVarintsSsse3(in, out, pos, i);
+            if (i == out.size()) {
+                break;
+            }
+        }
+#endif
+#if defined(__SSE2__)
+        constexpr std::size_t window {sizeof(__m128i)};
+        if (in.size() - pos >= window && out.size() - i >= window) {
+            const auto bytes {_mm_loadu_si128(reinterpret_cast<const __m128i*>(in.data() + pos))};
+            if (_mm_movemask_epi8(bytes) == 0) {
+                WidenBytes(bytes, out.data() + i);
+                pos += window;
+                i += window;
+                continue;
+            }
+        }
+#endif
+        if (in.size() - pos >= sizeof(std::uint64_t)) {
+            const auto word {LoadLE<std::uint64_t>(in.data() + pos)};
+            if (const auto size {DecodeVarintWord(word, out[i])}; size != 0) {
+                pos += size;
+                ++i;
+                continue;
+            }
+        }
+
+        // Values longer than 8 bytes and values near the end of the input.
+        if constexpr (Checked) {
+            const auto size {DecodeVarintChecked(in.subspan(pos), out[i])};
+            if (!size) {
+                return std::nullopt;
+            }
+
+            pos += *size;
+        } else {
+            pos += DecodeVarint(in.subspan(pos), out[i]);
+        }
+
+        ++i;
+    }
+
+    return pos;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Encode values back to back.
+ *
+ * @param out A span of at least `vals.size() * max_varint_size` bytes,
+ * or the total `VarintSize` of the values.
+ * @return The number of written bytes.
+ */
+inline std::size_t EncodeVarints(const std::span<const std::uint64_t> vals,
+                                 const std::span<std::uint8_t> out) noexcept {
+    std::size_t size {0};
+    std::size_t i {0};
+#if defined(BIT_MANIP_SSSE3)
+    const bool ssse3 {detail::CanUseSsse3()};
+#endif
+    // The values to encode one by one before trying vector encoding again.
+    std::size_t scalar {CHAR_BIT};
+    while (i != vals.size()) {
+#if defined(BIT_MANIP_SSSE3)
+        if (ssse3) {
+            // Positions passed by reference would escape and be reloaded after each byte store.
+            const auto first {i};
+            std::tie(i, size) = detail::EncodeVarintsSsse3(vals, out, i, size);
+            if (i == vals.size()) {
+                break;
+            }
+
+            // Long values tend to come in runs, so back off while vector encoding keeps stopping.
+            scalar = i != first ? CHAR_BIT : std::min(scalar * 2, detail::max_varint_backoff);
+        }
+#endif
+        for (const auto end {std::min(vals.size(), i + scalar)}; i != end; ++i) {
+            if (const auto val {vals[i]}; val < 0x80) {
+                assert(size < out.size());
+                out[size++] = static_cast<std::uint8_t>(val);
+            } else {
+                size += EncodeVarint(val, out.subspan(size));
+            }
+        }
+    }
+
+    return size;
+}
+
+/**
+ * @brief Decode `out.size()` values from trusted input.
+ *
+ * @return The number of read bytes.
+ */
+inline std::size_t DecodeVarints(const std::span<const std::uint8_t> in,
+                                 const std::span<std::uint64_t> out) noexcept {
+    return *detail::DecodeVarints<false>(in, out);
+}
+
+/**
+ * @brief Decode `out.size()` values from untrusted input.
+ *
+ * @return
+ * The number of read bytes, or nothing if the input ends early
+ * or holds a value that does not fit in 64 bits.
+ */
+inline std::optional<std::size_t> DecodeVarintsChecked(
+    const std::span<const std::uint8_t> in, const std::span<std::uint64_t> out) noexcept {
+    return detail::DecodeVarints<true>(in, out);
+}
+
+}  // namespace bit
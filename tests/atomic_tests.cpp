@@ -0,0 +1,101 @@
+#include "bit_manip/atomic.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace bit;
+
+TEST(Atomic, SingleBits) {
+    std::uint32_t val {0};
+    AtomicSetBit(val, 3);
+    EXPECT_EQ(val, 0b1000);
+    EXPECT_TRUE(AtomicIsBitSet(val, 3, std::memory_order_acquire));
+    EXPECT_FALSE(AtomicIsBitSet(val, 2));
+
+    EXPECT_FALSE(AtomicTestAndSetBit(val, 31));
+    EXPECT_TRUE(AtomicTestAndSetBit(val, 31));
+    EXPECT_EQ(val, 0x8000'0008);
+
+    AtomicFlipBit(val, 0, std::memory_order_relaxed);
+    EXPECT_EQ(val, 0x8000'0009);
+    AtomicClearBit(val, 3, std::memory_order_release);
+    EXPECT_EQ(val, 0x8000'0001);
+
+    EXPECT_TRUE(AtomicTestAndClearBit(val, 31));
+    EXPECT_FALSE(AtomicTestAndClearBit(val, 31));
+    EXPECT_EQ(val, 1);
+}
+
+TEST(Atomic, Fields) {
+    std::uint64_t val {0};
+    AtomicFillBits(val, 8, 16);
+    EXPECT_EQ(val, 0x00FF'FF00);
+    AtomicClearBits(val, 12, 8);
+    EXPECT_EQ(val, 0x00F0'0F00);
+    EXPECT_EQ(AtomicGetBits(val, 8, 16), 0xF00F);
+
+    EXPECT_EQ(AtomicSetBits(val, 0b1010, 4, 4), 0x00F0'0F00);
+    EXPECT_EQ(val, 0x00F0'0FA0);
+    AtomicSetBits(val, 0xF, 28, 4);
+    EXPECT_EQ(val, 0xF0F0'0FA0);
+    AtomicSetBits(val, 0, 20, 12);
+    EXPECT_EQ(val, 0x0000'0FA0);
+    AtomicSetBits(val, std::uint64_t {0x1234'5678'9ABC'DEF0}, 0);
+    EXPECT_EQ(val, 0x1234'5678'9ABC'DEF0);
+
+    std::int16_t signed_val {0};
+    AtomicSetBits(signed_val, 0x5, 12, 4);
+    EXPECT_EQ(signed_val, 0x5000);
+}
+
+TEST(Atomic, ConcurrentBits) {
+    constexpr std::size_t thread_count {8};
+    std::uint64_t val {0};
+    std::uint8_t flag {0};
+    std::size_t first_setters {0};
+    std::vector<std::thread> threads;
+    for (std::size_t t {0}; t != thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for (auto idx {t}; idx < 64; idx += thread_count) {
+                AtomicSetBit(val, idx, std::memory_order_relaxed);
+            }
+
+            // Exactly one thread sees the bit cleared before setting it.
+            if (!AtomicTestAndSetBit(flag, 5)) {
+                std::atomic_ref {first_setters}.fetch_add(1);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(val, ~std::uint64_t {0});
+    EXPECT_EQ(flag, 0b10'0000);
+    EXPECT_EQ(first_setters, 1);
+}
+
+TEST(Atomic, ConcurrentFields) {
+    constexpr std::size_t thread_count {8};
+    constexpr std::size_t rounds {10'000};
+    std::uint64_t val {0};
+    std::vector<std::thread> threads;
+    for (std::size_t t {0}; t != thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            for (std::size_t i {0}; i != rounds; ++i) {
+                AtomicSetBits(val, (i + t) % 256, t * 8, 8, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (std::size_t t {0}; t != thread_count; ++t) {
+        EXPECT_EQ(GetBits(val, t * 8, 8), (rounds - 1 + t) % 256);
+    }
+}
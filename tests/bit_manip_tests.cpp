@@ -4,6 +4,24 @@
 
 using namespace bit;
 
+TEST(BitManip, LowMask) {
+    static_assert(LowMask<std::uint8_t>(0) == 0);
+    static_assert(LowMask<std::uint8_t>(3) == 0b111);
+    static_assert(LowMask<std::uint8_t>(8) == 0xFF);
+    static_assert(LowMask<std::uint8_t>(100) == 0xFF);
+    static_assert(LowMask<std::int32_t>(31) == 0x7FFF'FFFF);
+    static_assert(LowMask<std::uint64_t>(64) == 0xFFFF'FFFF'FFFF'FFFF);
+
+    // Runtime widths, including ones beyond the value.
+    for (std::size_t count {0}; count != 200; ++count) {
+        const auto expected {count < 64 ? (std::uint64_t {1} << count) - 1
+                                        : static_cast<std::uint64_t>(-1)};
+        EXPECT_EQ(LowMask<std::uint64_t>(count), expected);
+        EXPECT_EQ(LowMask<std::uint16_t>(count), static_cast<std::uint16_t>(expected));
+        EXPECT_EQ(LowMask<std::int8_t>(count), static_cast<std::uint8_t>(expected));
+    }
+}
+
 TEST(BitManip, GetBits) {
     constexpr std::uint32_t val {0x12345678};
 
@@ -58,6 +76,10 @@ TEST(BitManip, GetBits) {
 
     // Get 64 bits from a 32-bit value.
     EXPECT_EQ(GetBits(val, 0, sizeof(std::uint64_t) * CHAR_BIT), val);
+
+    // Get the high bits of a negative value.
+    EXPECT_EQ(GetBits(std::int64_t {-1}, 60, 4), 0xF);
+    EXPECT_EQ(GetBits(std::int8_t {-1}, 4, 4), 0xF);
 }
 
 TEST(BitManip, FillBits) {
@@ -327,6 +349,39 @@ TEST(BitManip, ClearBit) {
     EXPECT_EQ(val, 0b0110'1100);
 }
 
+TEST(BitManip, CountBits) {
+    static_assert(CountBits(std::uint8_t {0b1011'0001}) == 4);
+    static_assert(CountBits(std::uint8_t {0b1011'0001}, 4, 4) == 3);
+
+    EXPECT_EQ(CountBits(std::uint32_t {0}), 0);
+    EXPECT_EQ(CountBits(std::uint64_t {0xFFFF'FFFF'FFFF'FFFF}), 64);
+    EXPECT_EQ(CountBits(std::int16_t {-1}), 16);
+
+    // Count the bits of a range.
+    EXPECT_EQ(CountBits(std::uint32_t {0x1234'5678}, 0, 8), 4);
+    EXPECT_EQ(CountBits(std::uint32_t {0x1234'5678}, 28, 4), 1);
+    EXPECT_EQ(CountBits(std::int64_t {-1}, 60, 4), 4);
+    EXPECT_EQ(CountBits(std::uint16_t {0xFFFF}, 0, sizeof(std::uint16_t) * CHAR_BIT), 16);
+}
+
+TEST(BitManip, CountLeadingZeros) {
+    static_assert(CountLeadingZeros(std::uint8_t {0b0001'0000}) == 3);
+
+    EXPECT_EQ(CountLeadingZeros(std::uint8_t {0}), 8);
+    EXPECT_EQ(CountLeadingZeros(std::uint32_t {1}), 31);
+    EXPECT_EQ(CountLeadingZeros(std::uint64_t {0x8000'0000'0000'0000}), 0);
+    EXPECT_EQ(CountLeadingZeros(std::int16_t {-1}), 0);
+}
+
+TEST(BitManip, CountTrailingZeros) {
+    static_assert(CountTrailingZeros(std::uint8_t {0b0001'0000}) == 4);
+
+    EXPECT_EQ(CountTrailingZeros(std::uint16_t {0}), 16);
+    EXPECT_EQ(CountTrailingZeros(std::uint32_t {1}), 0);
+    EXPECT_EQ(CountTrailingZeros(std::uint64_t {0x8000'0000'0000'0000}), 63);
+    EXPECT_EQ(CountTrailingZeros(std::int8_t {-128}), 7);
+}
+
 TEST(BitManip, GetByte) {
     {
         constexpr std::uint32_t val {0x12345678};
@@ -0,0 +1,126 @@
+#include "bit_manip/bit_sliced.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+template <std::unsigned_integral T>
+std::vector<T> MakeValues(const std::size_t size, const std::uint64_t range) {
+    std::vector<T> vals;
+    for (const auto val : test::RandomValues<std::uint64_t>(size)) {
+        vals.push_back(static_cast<T>(range != 0 ? val % range : val));
+    }
+
+    return vals;
+}
+
+template <std::unsigned_integral T, typename Pred>
+Bitset Filter(const std::vector<T>& vals, Pred pred) {
+    Bitset rows {vals.size()};
+    for (std::size_t row {0}; row != vals.size(); ++row) {
+        if (pred(vals[row])) {
+            rows.Set(row);
+        }
+    }
+
+    return rows;
+}
+
+template <std::unsigned_integral T>
+void ExpectPredicates(const std::vector<T>& vals, const std::vector<T>& bounds) {
+    const BitSlicedIndex<T> index {vals};
+    ASSERT_EQ(index.size(), vals.size());
+    for (std::size_t row {0}; row != vals.size(); ++row) {
+        EXPECT_EQ(index[row], vals[row]);
+    }
+
+    for (const auto bound : bounds) {
+        EXPECT_EQ(index.LessThan(bound), Filter(vals, [bound](const T val) { return val < bound; }));
+        EXPECT_EQ(index.LessEqual(bound),
+                  Filter(vals, [bound](const T val) { return val <= bound; }));
+        EXPECT_EQ(index.Equal(bound), Filter(vals, [bound](const T val) { return val == bound; }));
+        for (const auto upper : bounds) {
+            EXPECT_EQ(index.Between(bound, upper), Filter(vals, [bound, upper](const T val) {
+                          return bound <= val && val <= upper;
+                      }));
+        }
+    }
+}
+
+}  // namespace
+
+TEST(BitSlicedIndex, Predicates) {
+    ExpectPredicates<std::uint8_t>(MakeValues<std::uint8_t>(1000, 0), {0, 1, 100, 254, 255});
+    ExpectPredicates<std::uint16_t>(MakeValues<std::uint16_t>(777, 300), {0, 7, 150, 299, 300});
+    ExpectPredicates<std::uint64_t>(MakeValues<std::uint64_t>(130, 0),
+                                    {0, std::uint64_t {1} << 63, static_cast<std::uint64_t>(-1)});
+    ExpectPredicates<std::uint32_t>({}, {0, 5});
+
+    // Rows beyond the size never match.
+    const BitSlicedIndex<std::uint32_t> index {std::vector<std::uint32_t>(70, 0)};
+    EXPECT_EQ(index.Equal(0).Count(), 70);
+    EXPECT_EQ(index.LessEqual(9).Count(), 70);
+}
+
+TEST(BitSlicedIndex, DefaultConstructed) {
+    const BitSlicedIndex<std::uint8_t> index;
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.slice(7).size(), 0);
+    EXPECT_EQ(index.Sum(), 0);
+    EXPECT_EQ(index.Sum(Bitset {}), 0);
+    EXPECT_EQ(index.Equal(0).size(), 0);
+    EXPECT_EQ(index.TopK(3).size(), 0);
+}
+
+TEST(BitSlicedIndex, Sum) {
+    const auto vals {MakeValues<std::uint32_t>(1000, 1'000'000)};
+    const BitSlicedIndex<std::uint32_t> index {vals};
+    EXPECT_EQ(index.Sum(), std::accumulate(vals.begin(), vals.end(), std::uint64_t {0}));
+
+    const auto rows {index.Between(1000, 500'000)};
+    std::uint64_t sum {0};
+    for (const auto val : vals) {
+        sum += 1000 <= val && val <= 500'000 ? val : 0;
+    }
+
+    EXPECT_EQ(index.Sum(rows), sum);
+    EXPECT_EQ(index.Sum(Bitset {vals.size()}), 0);
+}
+
+TEST(BitSlicedIndex, TopK) {
+    const auto vals {MakeValues<std::uint16_t>(500, 50)};
+    const BitSlicedIndex<std::uint16_t> index {vals};
+    auto sorted {vals};
+    std::ranges::sort(sorted, std::greater {});
+    for (const std::size_t count : {0, 1, 10, 37, 499, 500, 600}) {
+        const auto top {index.TopK(count)};
+        ASSERT_EQ(top.Count(), std::min(count, vals.size()));
+        if (count == 0 || count >= vals.size()) {
+            continue;
+        }
+
+        // The selected rows hold the largest values, and ties are the first rows.
+        const auto threshold {sorted[count - 1]};
+        std::size_t ties {
+            static_cast<std::size_t>(std::ranges::count_if(sorted, [threshold](const auto val) {
+                return val > threshold;
+            }))};
+        for (std::size_t row {0}; row != vals.size(); ++row) {
+            if (vals[row] > threshold) {
+                EXPECT_TRUE(top.IsSet(row));
+            } else if (vals[row] < threshold) {
+                EXPECT_FALSE(top.IsSet(row));
+            } else {
+                EXPECT_EQ(top.IsSet(row), ties++ < count);
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#include "bit_manip/bit_stream.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+//! Fields of every width from 1 to 64 with pseudo-random values.
+std::vector<std::pair<std::uint64_t, std::size_t>> MakeFields(const std::size_t size) {
+    std::vector<std::pair<std::uint64_t, std::size_t>> fields;
+    const auto vals {test::RandomValues<std::uint64_t>(size)};
+    for (std::size_t i {0}; i != size; ++i) {
+        const auto count {i % 64 + 1};
+        fields.emplace_back(GetBits(vals[i], 0, count), count);
+    }
+
+    return fields;
+}
+
+}  // namespace
+
+TEST(BitStream, BitOrder) {
+    BitWriter writer;
+    writer.Write(0b101, 3);
+    writer.Write(0b11110, 5);
+    writer.Write(0xABC, 12);
+    EXPECT_EQ(writer.size(), 20);
+
+    const auto bytes {writer.Release()};
+    ASSERT_EQ(bytes.size(), 3);
+    EXPECT_EQ(bytes[0], 0b1111'0101);
+    EXPECT_EQ(bytes[1], 0xBC);
+    EXPECT_EQ(bytes[2], 0x0A);
+
+    BitReader reader {bytes};
+    EXPECT_EQ(reader.Read(3), 0b101);
+    EXPECT_EQ(reader.Peek(5), 0b11110);
+    EXPECT_EQ(reader.Read(5), 0b11110);
+    EXPECT_EQ(reader.Read(12), 0xABC);
+    EXPECT_EQ(reader.position(), 20);
+    EXPECT_EQ(reader.remaining(), 4);
+    EXPECT_TRUE(reader.good());
+}
+
+TEST(BitStream, RoundTrip) {
+    const auto fields {MakeFields(1000)};
+    BitWriter writer;
+    std::size_t total {0};
+    for (const auto& [val, count] : fields) {
+        writer.Write(val, count);
+        total += count;
+    }
+
+    EXPECT_EQ(writer.size(), total);
+    const auto bytes {writer.Release()};
+    EXPECT_EQ(bytes.size(), (total + 7) / 8);
+
+    BitReader reader {bytes};
+    for (const auto& [val, count] : fields) {
+        ASSERT_EQ(reader.Read(count), val) << count;
+    }
+
+    EXPECT_TRUE(reader.good());
+    EXPECT_EQ(reader.position(), total);
+}
+
+TEST(BitStream, WriteIgnoresHighBits) {
+    BitWriter writer;
+    writer.Write(0xFF, 4);
+    writer.Write(0, 4);
+    EXPECT_EQ(writer.Flush()[0], 0x0F);
+}
+
+TEST(BitStream, AlignAndSkip) {
+    BitWriter writer;
+    writer.WriteBit(true);
+    writer.AlignToByte();
+    writer.Write(0x1234, 16);
+    writer.Write(0x5, 64);
+    const auto bytes {writer.Release()};
+    ASSERT_EQ(bytes.size(), 11);
+
+    BitReader reader {bytes};
+    EXPECT_TRUE(reader.ReadBit());
+    reader.AlignToByte();
+    EXPECT_EQ(reader.position(), 8);
+    reader.Skip(0);
+    EXPECT_EQ(reader.position(), 8);
+    EXPECT_EQ(reader.Peek(8), 0x34);
+    reader.Skip(8);
+    EXPECT_EQ(reader.Read(8), 0x12);
+    reader.Skip(64);
+    EXPECT_EQ(reader.remaining(), 0);
+}
+
+TEST(BitStream, CallerBuffer) {
+    std::array<std::uint8_t, 10> buf {};
+    BitWriter writer {buf};
+    writer.Write(0x0123'4567'89AB'CDEF, 64);
+    writer.Write(0xFFFF, 16);
+    EXPECT_TRUE(writer.good());
+    EXPECT_EQ(writer.Flush().size(), 10);
+    EXPECT_EQ(buf[0], 0xEF);
+    EXPECT_EQ(buf[9], 0xFF);
+
+    writer.Write(1, 1);
+    EXPECT_EQ(writer.Flush().size(), 10);
+    EXPECT_FALSE(writer.good());
+}
+
+TEST(BitStream, ReadBeyondEnd) {
+    const std::array<std::uint8_t, 2> bytes {0xFF, 0x01};
+    BitReader reader {bytes};
+    EXPECT_EQ(reader.Read(9), 0x1FF);
+    EXPECT_EQ(reader.Read(10), 0);
+    EXPECT_FALSE(reader.good());
+    EXPECT_EQ(reader.remaining(), 0);
+}
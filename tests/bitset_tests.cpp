@@ -0,0 +1,140 @@
+#include "bit_manip/bitset.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+std::vector<std::size_t> SetBits(const Bitset& bits) {
+    std::vector<std::size_t> indices;
+    for (auto idx {bits.FindFirst()}; idx != Bitset::npos; idx = bits.FindNext(idx)) {
+        indices.push_back(idx);
+    }
+
+    return indices;
+}
+
+}  // namespace
+
+TEST(Bitset, Storage) {
+    const Bitset bits {1000};
+    EXPECT_EQ(bits.size(), 1000);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(bits.words().data()) % cache_line_size, 0);
+    EXPECT_EQ(bits.words().size_bytes() % cache_line_size, 0);
+    EXPECT_TRUE(bits.None());
+}
+
+TEST(Bitset, SetBit) {
+    Bitset bits {130};
+
+    bits.Set(0);
+    bits.Set(64);
+    bits.Set(129);
+    EXPECT_TRUE(bits.IsSet(0));
+    EXPECT_FALSE(bits.IsSet(1));
+    EXPECT_TRUE(bits.IsSet(64));
+    EXPECT_TRUE(bits.IsSet(129));
+    EXPECT_EQ(bits.Count(), 3);
+
+    bits.Clear(64);
+    EXPECT_FALSE(bits.IsSet(64));
+
+    bits.Flip(1);
+    bits.Flip(0);
+    EXPECT_FALSE(bits.IsSet(0));
+    EXPECT_TRUE(bits.IsSet(1));
+    EXPECT_EQ(bits.Count(), 2);
+}
+
+TEST(Bitset, FillRange) {
+    Bitset bits {300};
+
+    // Inside a single word.
+    bits.Fill(3, 5);
+    EXPECT_EQ(SetBits(bits), (std::vector<std::size_t> {3, 4, 5, 6, 7}));
+
+    // Across several words.
+    bits.Fill(60, 200);
+    EXPECT_EQ(bits.Count(), 205);
+    EXPECT_FALSE(bits.IsSet(59));
+    EXPECT_TRUE(bits.IsSet(60));
+    EXPECT_TRUE(bits.IsSet(259));
+    EXPECT_FALSE(bits.IsSet(260));
+
+    bits.Clear(62, 196);
+    EXPECT_EQ(SetBits(bits), (std::vector<std::size_t> {3, 4, 5, 6, 7, 60, 61, 258, 259}));
+
+    bits.Fill();
+    EXPECT_TRUE(bits.All());
+    EXPECT_EQ(bits.Count(), 300);
+
+    bits.Clear();
+    EXPECT_TRUE(bits.None());
+}
+
+TEST(Bitset, Flip) {
+    Bitset bits {70};
+    bits.Set(3);
+    bits.Flip();
+
+    // Bits beyond the size stay cleared.
+    EXPECT_EQ(bits.Count(), 69);
+    EXPECT_FALSE(bits.IsSet(3));
+}
+
+TEST(Bitset, Find) {
+    Bitset bits {1000};
+    EXPECT_EQ(bits.FindFirst(), Bitset::npos);
+    EXPECT_EQ(Bitset {}.FindFirst(), Bitset::npos);
+
+    bits.Set(5);
+    bits.Set(63);
+    bits.Set(64);
+    bits.Set(999);
+    EXPECT_EQ(SetBits(bits), (std::vector<std::size_t> {5, 63, 64, 999}));
+    EXPECT_EQ(bits.FindNext(999), Bitset::npos);
+    EXPECT_EQ(bits.FindNext(Bitset::npos), Bitset::npos);
+}
+
+TEST(Bitset, Algebra) {
+    constexpr std::size_t size {2000};
+    Bitset twos {size};
+    Bitset threes {size};
+    for (std::size_t i {0}; i < size; i += 2) {
+        twos.Set(i);
+    }
+
+    for (std::size_t i {0}; i < size; i += 3) {
+        threes.Set(i);
+    }
+
+    const auto both {twos & threes};
+    const auto either {twos | threes};
+    const auto one {twos ^ threes};
+    auto only_twos {twos};
+    only_twos.AndNot(threes);
+    for (std::size_t i {0}; i != size; ++i) {
+        const bool two {i % 2 == 0};
+        const bool three {i % 3 == 0};
+        ASSERT_EQ(both.IsSet(i), two && three) << "index: " << i;
+        ASSERT_EQ(either.IsSet(i), two || three) << "index: " << i;
+        ASSERT_EQ(one.IsSet(i), two != three) << "index: " << i;
+        ASSERT_EQ(only_twos.IsSet(i), two && !three) << "index: " << i;
+    }
+
+    EXPECT_EQ(both.Count(), 334);
+    EXPECT_EQ(either.Count(), 1333);
+}
+
+TEST(Bitset, Resize) {
+    Bitset bits {100, true};
+    bits.resize(10);
+    EXPECT_EQ(bits.Count(), 10);
+
+    bits.resize(200);
+    EXPECT_EQ(bits.Count(), 10);
+    EXPECT_FALSE(bits.IsSet(10));
+}
@@ -0,0 +1,100 @@
+#include "bit_manip/block_codec.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+constexpr std::array codecs {Codec::frame_of_reference, Codec::delta, Codec::delta_of_delta};
+
+//! Make increasing timestamps with a period of `1000` and a jitter below `8`.
+std::vector<std::uint32_t> MakeTimestamps(const std::size_t size) {
+    auto vals {test::RandomValues<std::uint32_t>(size)};
+    std::uint32_t time {1'000'000};
+    for (auto& val : vals) {
+        time += 1000;
+        val = time + val % 8;
+    }
+
+    return vals;
+}
+
+void ExpectRoundTrip(const Codec codec, const std::vector<std::uint32_t>& vals) {
+    std::vector<std::uint32_t> encoded(MaxEncodedSize(vals.size()));
+    const auto size {Encode(codec, vals, encoded)};
+    ASSERT_LE(size, encoded.size());
+
+    std::vector<std::uint32_t> decoded(vals.size(), 0xFFFF'FFFF);
+    EXPECT_EQ(Decode(encoded, decoded), size);
+    EXPECT_EQ(decoded, vals);
+}
+
+}  // namespace
+
+TEST(BlockCodec, RoundTrip) {
+    for (const auto codec : codecs) {
+        for (const std::size_t size : {0, 1, 2, 3, 127, 128, 129, 1000}) {
+            SCOPED_TRACE(static_cast<int>(codec));
+            SCOPED_TRACE(size);
+            ExpectRoundTrip(codec, test::RandomValues<std::uint32_t>(size));
+            ExpectRoundTrip(codec, MakeTimestamps(size));
+        }
+    }
+}
+
+TEST(BlockCodec, BitWidth) {
+    const auto vals {MakeTimestamps(codec_block_size)};
+    std::vector<std::uint32_t> encoded(MaxEncodedSize(vals.size()));
+
+    // Frame-of-reference offsets span the whole block.
+    EXPECT_EQ(Encode(Codec::frame_of_reference, vals, encoded), 2 + PackedSize(128, 17));
+    EXPECT_EQ(GetByte(encoded[0], 0), 17);
+    EXPECT_EQ(GetByte(encoded[0], 8), static_cast<std::uint8_t>(Codec::frame_of_reference));
+    EXPECT_EQ(GetWord(encoded[0], 16), 128);
+    EXPECT_EQ(encoded[1], std::ranges::min(vals));
+
+    // Differences are between `993` and `1007`.
+    EXPECT_EQ(Encode(Codec::delta, vals, encoded), 2 + PackedSize(128, 10));
+    EXPECT_EQ(encoded[1], vals[0]);
+
+    // Changes of differences are between `-14` and `14`, zigzag-coded below `32`.
+    EXPECT_EQ(Encode(Codec::delta_of_delta, vals, encoded), 3 + PackedSize(128, 5));
+    EXPECT_EQ(encoded[2], vals[1] - vals[0]);
+}
+
+TEST(BlockCodec, EvenlySpacedValues) {
+    std::vector<std::uint32_t> vals(300);
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        vals[i] = static_cast<std::uint32_t>(500 + i * 60);
+    }
+
+    std::vector<std::uint32_t> encoded(MaxEncodedSize(vals.size()));
+    EXPECT_EQ(Encode(Codec::delta_of_delta, vals, encoded), 3 * 3);
+    ExpectRoundTrip(Codec::delta_of_delta, vals);
+}
+
+TEST(BlockCodec, PrefixSum) {
+    std::array<std::uint32_t, codec_block_size> vals;
+    std::ranges::fill(vals, 3);
+    vals[0] = 1;
+    detail::PrefixSum(vals, 10);
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        ASSERT_EQ(vals[i], 11 + i * 3) << i;
+    }
+}
+
+TEST(BlockCodec, Zigzag) {
+    EXPECT_EQ(detail::ZigzagEncode(0), 0);
+    EXPECT_EQ(detail::ZigzagEncode(static_cast<std::uint32_t>(-1)), 1);
+    EXPECT_EQ(detail::ZigzagEncode(1), 2);
+    EXPECT_EQ(detail::ZigzagEncode(0x8000'0000), 0xFFFF'FFFF);
+    for (const auto val : test::RandomValues<std::uint32_t>(100)) {
+        EXPECT_EQ(detail::ZigzagDecode(detail::ZigzagEncode(val)), val);
+    }
+}
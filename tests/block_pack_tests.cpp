@@ -0,0 +1,96 @@
+#include "bit_manip/block_pack.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+std::vector<std::uint32_t> MakeValues(const std::size_t size, const std::size_t width) {
+    auto vals {test::RandomValues<std::uint32_t>(size)};
+    for (auto& val : vals) {
+        val = GetBits(val, 0, width);
+    }
+
+    return vals;
+}
+
+//! Pack values one bit field at a time in the vertical layout.
+template <std::size_t BlockSize>
+std::vector<std::uint32_t> NaivePack(const std::vector<std::uint32_t>& vals,
+                                     const std::size_t width) {
+    constexpr std::size_t lanes {BlockSize / 32};
+    std::vector<std::uint32_t> packed(PackedSize(vals.size(), width));
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        const auto block {i / BlockSize};
+        const auto lane {i % lanes};
+        const auto row {i % BlockSize / lanes};
+        for (std::size_t bit {0}; bit != width; ++bit) {
+            const auto pos {row * width + bit};
+            if (IsBitSet(vals[i], bit)) {
+                SetBit(packed[block * BlockSize * width / 32 + pos / 32 * lanes + lane], pos % 32);
+            }
+        }
+    }
+
+    return packed;
+}
+
+template <std::size_t BlockSize>
+void ExpectRoundTrip() {
+    for (std::size_t width {0}; width <= 32; ++width) {
+        const auto vals {MakeValues(BlockSize * 3, width)};
+        EXPECT_EQ(MaxBitWidth(vals) <= width, true);
+        std::vector<std::uint32_t> packed(PackedSize(vals.size(), width));
+        Pack<BlockSize>(vals, width, packed);
+        ASSERT_EQ(packed, NaivePack<BlockSize>(vals, width)) << width;
+
+        std::vector<std::uint32_t> unpacked(vals.size(), 0xFFFF'FFFF);
+        Unpack<BlockSize>(packed, width, unpacked);
+        ASSERT_EQ(unpacked, vals) << width;
+    }
+}
+
+}  // namespace
+
+TEST(BlockPack, PackedSize) {
+    EXPECT_EQ(PackedSize(128, 0), 0);
+    EXPECT_EQ(PackedSize(128, 5), 20);
+    EXPECT_EQ(PackedSize(256, 32), 256);
+}
+
+TEST(BlockPack, MaxBitWidth) {
+    EXPECT_EQ(MaxBitWidth(std::vector<std::uint32_t> {}), 0);
+    EXPECT_EQ(MaxBitWidth(std::vector<std::uint32_t> {0, 0}), 0);
+    EXPECT_EQ(MaxBitWidth(std::vector<std::uint32_t> {1, 6, 2}), 3);
+    EXPECT_EQ(MaxBitWidth(std::vector<std::uint32_t> {0x8000'0000}), 32);
+}
+
+TEST(BlockPack, RoundTrip128) {
+    ExpectRoundTrip<128>();
+}
+
+TEST(BlockPack, RoundTrip256) {
+    ExpectRoundTrip<256>();
+}
+
+TEST(BlockPack, DropsHighBits) {
+    const std::vector<std::uint32_t> vals(128, 0xFFFF'FFF5);
+    std::vector<std::uint32_t> packed(PackedSize(vals.size(), 4));
+    Pack(vals, 4, packed);
+    std::vector<std::uint32_t> unpacked(vals.size());
+    Unpack(packed, 4, unpacked);
+    EXPECT_EQ(unpacked, std::vector<std::uint32_t>(128, 0x5));
+}
+
+TEST(BlockPack, Isa) {
+#if defined(__AVX2__)
+    EXPECT_EQ(GetBlockPackIsa<256>(), Isa::avx2);
+#elif defined(__SSE2__)
+    EXPECT_EQ(GetBlockPackIsa<128>(), Isa::sse2);
+    EXPECT_EQ(GetBlockPackIsa<256>(), Isa::sse2);
+#endif
+}
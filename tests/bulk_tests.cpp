@@ -0,0 +1,104 @@
+#include "bit_manip/bulk.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <numeric>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+template <std::unsigned_integral T>
+void ExpectGetBitsMatchesScalar() {
+    constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+    // A size that is not a multiple of any vector register exercises the scalar tail.
+    const auto vals {test::RandomValues<T>(131)};
+    std::vector<T> out(vals.size());
+    for (std::size_t begin {0}; begin != width; ++begin) {
+        for (std::size_t count {0}; count <= width; ++count) {
+            GetBits(vals, std::span {out}, begin, count);
+            for (std::size_t i {0}; i != vals.size(); ++i) {
+                ASSERT_EQ(out[i], GetBits(vals[i], begin, count))
+                    << "begin: " << begin << ", count: " << count << ", index: " << i;
+            }
+        }
+    }
+}
+
+template <std::unsigned_integral T>
+void ExpectSetBitsMatchesScalar() {
+    constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+    const auto origin {test::RandomValues<T>(131)};
+    const auto bits {test::RandomValues<T>(origin.size() + 1)};
+    for (std::size_t begin {0}; begin != width; ++begin) {
+        for (std::size_t count {0}; count <= width; ++count) {
+            auto vals {origin};
+            SetBits(std::span {vals}, bits, begin, count);
+            for (std::size_t i {0}; i != vals.size(); ++i) {
+                auto expected {origin[i]};
+                SetBits(expected, bits[i], begin, count);
+                ASSERT_EQ(vals[i], expected)
+                    << "begin: " << begin << ", count: " << count << ", index: " << i;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Bulk, PopcountSpan) {
+    // Sizes around whole vectors and Harley-Seal blocks of 64 quad words.
+    const auto words {test::RandomValues<std::uint64_t>(1000)};
+    for (const std::size_t size : {0, 3, 4, 63, 64, 67, 203, 1000}) {
+        const std::span<const std::uint64_t> span {words.data(), size};
+        std::size_t expected {0};
+        for (const auto word : span) {
+            expected += static_cast<std::size_t>(std::popcount(word));
+        }
+
+        EXPECT_EQ(PopcountSpan(span), expected);
+    }
+
+    const std::vector<std::uint64_t> ones(200, static_cast<std::uint64_t>(-1));
+    EXPECT_EQ(PopcountSpan(ones), 200 * 64);
+}
+
+TEST(Bulk, GetBits) {
+    {
+        const std::vector<std::uint32_t> vals {0x12345678, 0x9ABCDEF0, 0x0F0F0F0F};
+        std::vector<std::uint32_t> out(vals.size());
+        GetBits(vals, std::span {out}, CHAR_BIT, sizeof(std::uint16_t) * CHAR_BIT);
+        EXPECT_EQ(out, (std::vector<std::uint32_t> {0x3456, 0xBCDE, 0x0F0F}));
+    }
+
+    ExpectGetBitsMatchesScalar<std::uint8_t>();
+    ExpectGetBitsMatchesScalar<std::uint16_t>();
+    ExpectGetBitsMatchesScalar<std::uint32_t>();
+    ExpectGetBitsMatchesScalar<std::uint64_t>();
+}
+
+TEST(Bulk, GetBitsInPlace) {
+    std::vector<std::uint32_t> vals(100);
+    std::iota(vals.begin(), vals.end(), 0);
+    GetBits(vals, std::span {vals}, 1, 3);
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        EXPECT_EQ(vals[i], (i >> 1) & 0b111);
+    }
+}
+
+TEST(Bulk, SetBits) {
+    {
+        std::vector<std::uint32_t> vals {0x12345678, 0x9ABCDEF0, 0x0F0F0F0F};
+        const std::vector<std::uint32_t> bits {0xFFFF, 0x0000, 0xABCD};
+        SetBits(std::span {vals}, bits, 0, sizeof(std::uint16_t) * CHAR_BIT);
+        EXPECT_EQ(vals, (std::vector<std::uint32_t> {0x1234FFFF, 0x9ABC0000, 0x0F0FABCD}));
+    }
+
+    ExpectSetBitsMatchesScalar<std::uint8_t>();
+    ExpectSetBitsMatchesScalar<std::uint16_t>();
+    ExpectSetBitsMatchesScalar<std::uint32_t>();
+    ExpectSetBitsMatchesScalar<std::uint64_t>();
+}
@@ -0,0 +1,151 @@
+#include "bit_manip/bulk.h"
+#include "bit_manip/dispatch.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+#if defined(BIT_MANIP_DISPATCH)
+
+//! Check every dispatchable bulk kernel supported by the CPU against the scalar operations.
+template <std::unsigned_integral T>
+void ExpectBulkKernelsMatchScalar() {
+    const auto& cpu {GetCpuFeatures()};
+    std::vector<detail::BulkKernels<T>> candidates;
+    if (cpu.avx2) {
+        candidates.push_back({&detail::GetBitsAvx2<T>, &detail::SetBitsAvx2<T>, Isa::avx2});
+    }
+
+    if (cpu.avx512f && cpu.avx512bw) {
+        candidates.push_back({&detail::GetBitsAvx512<T>, &detail::SetBitsAvx512<T>, Isa::avx512});
+    }
+
+    constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+    const auto vals {test::RandomValues<T>(131)};
+    const auto bits {test::RandomValues<T>(262)};
+    for (const auto& kernels : candidates) {
+        for (std::size_t begin {0}; begin != width; ++begin) {
+            const auto count {(width - begin) / 2 + 1};
+            const auto mask {LowMask<T>(count)};
+            std::vector<T> out(vals.size());
+            const auto done {kernels.get_bits(vals.data(), out.data(), vals.size(), begin, mask)};
+            // Only a tail shorter than an AVX-512 register is left to the caller.
+            EXPECT_LE(done, vals.size());
+            EXPECT_LT(vals.size() - done, 64 / sizeof(T));
+            for (std::size_t i {0}; i != done; ++i) {
+                ASSERT_EQ(out[i], GetBits(vals[i], begin, count)) << ToString(kernels.isa);
+            }
+
+            auto updated {vals};
+            const auto shifted {static_cast<T>(mask << begin)};
+            kernels.set_bits(updated.data(), bits.data(), updated.size(), begin, shifted);
+            for (std::size_t i {0}; i != done; ++i) {
+                auto expected {vals[i]};
+                SetBits(expected, bits[i], begin, count);
+                ASSERT_EQ(updated[i], expected) << ToString(kernels.isa);
+            }
+        }
+    }
+}
+
+#endif
+
+}  // namespace
+
+TEST(Dispatch, ToString) {
+    EXPECT_EQ(ToString(Isa::scalar), "scalar");
+    EXPECT_EQ(ToString(Isa::avx2), "avx2");
+    EXPECT_EQ(ToString(Isa::avx512), "avx512");
+}
+
+TEST(Dispatch, KernelPaths) {
+    const auto paths {GetKernelPaths()};
+    const auto& cpu {GetCpuFeatures()};
+#if defined(BIT_MANIP_DISPATCH)
+    if (cpu.avx2 && cpu.popcnt) {
+        EXPECT_NE(paths.popcount, Isa::scalar);
+        EXPECT_TRUE(paths.bitwise == Isa::avx2 || paths.bitwise == Isa::avx512);
+        EXPECT_TRUE(paths.bulk == Isa::avx2 || paths.bulk == Isa::avx512);
+    }
+
+    if (cpu.avx512f && cpu.avx512bw && cpu.popcnt) {
+        EXPECT_EQ(paths.bitwise, Isa::avx512);
+        EXPECT_EQ(paths.bulk, Isa::avx512);
+    }
+#endif
+    if (!cpu.popcnt) {
+        EXPECT_NE(paths.popcount, Isa::popcnt);
+    }
+}
+
+TEST(Dispatch, Popcount) {
+    const auto words {test::RandomValues<std::uint64_t>(203)};
+    std::size_t expected {0};
+    for (const auto word : words) {
+        expected += static_cast<std::size_t>(std::popcount(word));
+    }
+
+    EXPECT_EQ(detail::PopcountWords(words.data(), words.size()), expected);
+#if defined(BIT_MANIP_DISPATCH)
+    const auto& cpu {GetCpuFeatures()};
+    if (cpu.popcnt) {
+        EXPECT_EQ(detail::PopcountWordsPopcnt(words.data(), words.size()), expected);
+    }
+
+    if (cpu.popcnt && cpu.avx2) {
+        EXPECT_EQ(detail::PopcountWordsAvx2(words.data(), words.size()), expected);
+    }
+
+    if (cpu.popcnt && cpu.avx512f && cpu.avx512vpopcntdq) {
+        EXPECT_EQ(detail::PopcountWordsAvx512(words.data(), words.size()), expected);
+    }
+#endif
+}
+
+#if defined(BIT_MANIP_DISPATCH)
+
+TEST(Dispatch, BitwiseKernels) {
+    const auto& cpu {GetCpuFeatures()};
+    const auto lhs {test::RandomValues<std::uint64_t>(64)};
+    const auto rhs {test::RandomValues<std::uint64_t>(128)};
+    const auto check {[&](const detail::WordsKernel kernel, const auto op) {
+        auto result {lhs};
+        EXPECT_EQ(kernel(result.data(), rhs.data(), result.size()), result.size());
+        for (std::size_t i {0}; i != result.size(); ++i) {
+            ASSERT_EQ(result[i], op(lhs[i], rhs[i]));
+        }
+    }};
+
+    const auto and_op {[](const auto l, const auto r) { return l & r; }};
+    const auto or_op {[](const auto l, const auto r) { return l | r; }};
+    const auto xor_op {[](const auto l, const auto r) { return l ^ r; }};
+    const auto and_not_op {[](const auto l, const auto r) { return l & ~r; }};
+    if (cpu.avx2) {
+        check(&detail::ApplyWordsAvx2<detail::WordOp::and_words>, and_op);
+        check(&detail::ApplyWordsAvx2<detail::WordOp::or_words>, or_op);
+        check(&detail::ApplyWordsAvx2<detail::WordOp::xor_words>, xor_op);
+        check(&detail::ApplyWordsAvx2<detail::WordOp::and_not_words>, and_not_op);
+    }
+
+    if (cpu.avx512f && cpu.avx512bw) {
+        check(&detail::ApplyWordsAvx512<detail::WordOp::and_words>, and_op);
+        check(&detail::ApplyWordsAvx512<detail::WordOp::or_words>, or_op);
+        check(&detail::ApplyWordsAvx512<detail::WordOp::xor_words>, xor_op);
+        check(&detail::ApplyWordsAvx512<detail::WordOp::and_not_words>, and_not_op);
+    }
+}
+
+TEST(Dispatch, BulkKernels) {
+    ExpectBulkKernelsMatchScalar<std::uint8_t>();
+    ExpectBulkKernelsMatchScalar<std::uint16_t>();
+    ExpectBulkKernelsMatchScalar<std::uint32_t>();
+    ExpectBulkKernelsMatchScalar<std::uint64_t>();
+}
+
+#endif
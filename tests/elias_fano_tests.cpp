@@ -0,0 +1,111 @@
+#include "bit_manip/elias_fano.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+//! Make a non-decreasing sequence whose gaps are below `max_gap`.
+std::vector<std::uint32_t> MakeSorted(const std::size_t size, const std::uint32_t max_gap) {
+    std::vector<std::uint32_t> vals;
+    std::uint32_t val {0};
+    for (const auto gap : test::RandomValues<std::uint64_t>(size)) {
+        val += static_cast<std::uint32_t>(gap % max_gap);
+        vals.push_back(val);
+    }
+
+    return vals;
+}
+
+void ExpectMatches(const std::vector<std::uint32_t>& vals) {
+    const EliasFano seq {vals};
+    ASSERT_EQ(seq.size(), vals.size());
+    for (std::size_t i {0}; i != vals.size(); ++i) {
+        ASSERT_EQ(seq[i], vals[i]) << "index: " << i;
+    }
+
+    std::vector<std::uint32_t> iterated;
+    for (auto it {seq.begin()}; it != seq.end(); ++it) {
+        ASSERT_EQ(it.index(), iterated.size());
+        iterated.push_back(*it);
+    }
+
+    ASSERT_EQ(iterated, vals);
+
+    const auto last {vals.empty() ? 0 : static_cast<std::uint64_t>(vals.back())};
+    for (std::uint64_t x {0}; x <= last + 1 && x <= 0xFFFF'FFFF; x += 1 + x / 1000) {
+        const auto val {static_cast<std::uint32_t>(x)};
+        const auto expected {std::ranges::lower_bound(vals, val)};
+        const auto it {seq.NextGeq(val)};
+        if (expected == vals.end()) {
+            ASSERT_EQ(it, seq.end()) << "value: " << val;
+        } else {
+            ASSERT_EQ(it.index(), static_cast<std::size_t>(expected - vals.begin()))
+                << "value: " << val;
+            ASSERT_EQ(*it, *expected);
+        }
+    }
+}
+
+}  // namespace
+
+TEST(EliasFano, Empty) {
+    const EliasFano seq {std::vector<std::uint32_t> {}};
+    EXPECT_TRUE(seq.empty());
+    EXPECT_EQ(seq.begin(), seq.end());
+    EXPECT_EQ(seq.NextGeq(0), seq.end());
+}
+
+TEST(EliasFano, LowWidth) {
+    const auto low_width {[](const std::vector<std::uint32_t>& vals) {
+        return EliasFano {vals}.low_width();
+    }};
+
+    EXPECT_EQ(low_width({0, 1, 2, 3}), 0);
+    EXPECT_EQ(low_width({5, 100, 1023}), 8);
+    EXPECT_EQ(low_width({0xFFFF'FFFF}), 32);
+}
+
+TEST(EliasFano, Extremes) {
+    ExpectMatches({0});
+    ExpectMatches({0xFFFF'FFFF});
+    ExpectMatches({0, 0, 0});
+    ExpectMatches({7, 7, 0xFFFF'FFFE, 0xFFFF'FFFF, 0xFFFF'FFFF});
+}
+
+TEST(EliasFano, MatchesVector) {
+    ExpectMatches(MakeSorted(1000, 2));
+    ExpectMatches(MakeSorted(10000, 16));
+    ExpectMatches(MakeSorted(30000, 1000));
+    ExpectMatches(MakeSorted(3, 1'000'000'000));
+}
+
+TEST(EliasFano, Move) {
+    const auto vals {MakeSorted(5000, 100)};
+    EliasFano seq {vals};
+    const EliasFano moved {std::move(seq)};
+    EXPECT_EQ(moved[4999], vals[4999]);
+    EXPECT_EQ(*moved.NextGeq(vals[2000]), vals[2000]);
+}
+
+TEST(EliasFano, MemorySize) {
+    // Gaps average 64, so each value takes 5 low bits and at most 3 high bits plus the index.
+    const auto vals {MakeSorted(1 << 16, 128)};
+    const EliasFano seq {vals};
+    EXPECT_EQ(seq.low_width(), 5);
+    EXPECT_LE(seq.memory_size() * CHAR_BIT, vals.size() * 9);
+}
+
+TEST(EliasFano, MemorySizeOfMaxValue) {
+    // All 32 bits of a single maximum value go to the low part, leaving a tiny high bitset.
+    const std::vector<std::uint32_t> vals {0xFFFF'FFFF};
+    const EliasFano seq {vals};
+    EXPECT_EQ(seq.low_width(), 32);
+    EXPECT_LE(seq.memory_size(), 256);
+    EXPECT_EQ(seq[0], 0xFFFF'FFFF);
+}
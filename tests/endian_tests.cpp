@@ -0,0 +1,106 @@
+#include "bit_manip/endian.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+constexpr std::array<std::byte, 9> bytes {std::byte {0x01}, std::byte {0x23}, std::byte {0x45},
+                                          std::byte {0x67}, std::byte {0x89}, std::byte {0xAB},
+                                          std::byte {0xCD}, std::byte {0xEF}, std::byte {0xFF}};
+
+template <typename T>
+T ByteSwapLoop(const T val) {
+    using Bits = std::make_unsigned_t<T>;
+    Bits swapped {0};
+    for (std::size_t i {0}; i != sizeof(T); ++i) {
+        SetByte(swapped, GetByte(val, i * CHAR_BIT), (sizeof(T) - 1 - i) * CHAR_BIT);
+    }
+
+    return static_cast<T>(swapped);
+}
+
+template <typename T>
+void ExpectBulkByteSwap() {
+    for (const std::size_t size : {0, 1, 7, 15, 16, 33, 1003}) {
+        const auto vals {test::RandomValues<T>(size)};
+        std::vector<T> out(size);
+        ByteSwap<T>(vals, out);
+        for (std::size_t i {0}; i != size; ++i) {
+            EXPECT_EQ(out[i], ByteSwapLoop(vals[i]));
+        }
+
+        ByteSwap(std::span {out});
+        EXPECT_EQ(out, vals);
+    }
+}
+
+}  // namespace
+
+TEST(Endian, ByteSwap) {
+    static_assert(ByteSwap(std::uint8_t {0x12}) == 0x12);
+    static_assert(ByteSwap(std::uint16_t {0x1234}) == 0x3412);
+    static_assert(ByteSwap(std::uint32_t {0x12345678}) == 0x78563412);
+    static_assert(ByteSwap(std::uint64_t {0x0123456789ABCDEF}) == 0xEFCDAB8967452301);
+    static_assert(ByteSwap(std::int16_t {-2}) == static_cast<std::int16_t>(0xFEFF));
+
+    const auto vals {test::RandomValues<std::uint64_t>(64)};
+    for (const auto val : vals) {
+        EXPECT_EQ(ByteSwap(val), ByteSwapLoop(val));
+        EXPECT_EQ(ByteSwap(static_cast<std::uint32_t>(val)),
+                  ByteSwapLoop(static_cast<std::uint32_t>(val)));
+    }
+}
+
+TEST(Endian, Load) {
+    static_assert(LoadBE<std::uint32_t>(bytes.data()) == 0x01234567);
+    static_assert(LoadLE<std::uint32_t>(bytes.data()) == 0x67452301);
+    static_assert(LoadBE<std::uint16_t>(bytes.data() + 7) == 0xEFFF);
+
+    EXPECT_EQ(LoadBE<std::uint16_t>(bytes.data() + 1), 0x2345);
+    EXPECT_EQ(LoadLE<std::uint16_t>(bytes.data() + 1), 0x4523);
+    EXPECT_EQ(LoadBE<std::uint32_t>(bytes.data() + 3), 0x6789ABCD);
+    EXPECT_EQ(LoadLE<std::uint32_t>(bytes.data() + 3), 0xCDAB8967);
+    EXPECT_EQ(LoadBE<std::uint64_t>(bytes.data() + 1), 0x23456789ABCDEFFF);
+    EXPECT_EQ(LoadLE<std::uint64_t>(bytes.data() + 1), 0xFFEFCDAB89674523);
+    EXPECT_EQ(LoadBE<std::int16_t>(bytes.data() + 7), static_cast<std::int16_t>(0xEFFF));
+
+    const auto* const raw {reinterpret_cast<const std::uint8_t*>(bytes.data())};
+    EXPECT_EQ(LoadBE<std::uint32_t>(raw + 5), 0xABCDEFFF);
+    EXPECT_EQ(LoadLE<std::uint8_t>(raw + 8), 0xFF);
+}
+
+TEST(Endian, Store) {
+    static_assert([] {
+        std::array<std::byte, 4> buf {};
+        StoreBE(buf.data(), std::uint32_t {0x01234567});
+        return buf == std::array {bytes[0], bytes[1], bytes[2], bytes[3]};
+    }());
+
+    using Buffer = std::array<std::uint8_t, 9>;
+    Buffer buf {};
+    StoreBE(buf.data() + 1, std::uint64_t {0x0123456789ABCDEF});
+    EXPECT_EQ(buf, (Buffer {0, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF}));
+    StoreLE(buf.data() + 1, std::uint64_t {0x0123456789ABCDEF});
+    EXPECT_EQ(buf, (Buffer {0, 0xEF, 0xCD, 0xAB, 0x89, 0x67, 0x45, 0x23, 0x01}));
+
+    StoreLE(buf.data() + 3, std::uint16_t {0xBEEF});
+    EXPECT_EQ(LoadLE<std::uint16_t>(buf.data() + 3), 0xBEEF);
+    EXPECT_EQ(LoadBE<std::uint16_t>(buf.data() + 3), 0xEFBE);
+    StoreBE(buf.data() + 3, std::int32_t {-2});
+    EXPECT_EQ(LoadBE<std::int32_t>(buf.data() + 3), -2);
+    EXPECT_EQ(LoadLE<std::uint32_t>(buf.data() + 3), 0xFEFFFFFF);
+}
+
+TEST(Endian, BulkByteSwap) {
+    ExpectBulkByteSwap<std::uint8_t>();
+    ExpectBulkByteSwap<std::uint16_t>();
+    ExpectBulkByteSwap<std::uint32_t>();
+    ExpectBulkByteSwap<std::uint64_t>();
+    ExpectBulkByteSwap<std::int32_t>();
+}
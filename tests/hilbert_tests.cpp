@@ -0,0 +1,131 @@
+#include "bit_manip/hilbert.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+std::vector<std::uint32_t> MakeCoords(const std::size_t size, const std::uint64_t seed,
+                                      const std::size_t width) {
+    auto coords {test::RandomValues<std::uint32_t>(size, seed)};
+    for (auto& coord : coords) {
+        coord = GetBits(coord, 0, width);
+    }
+
+    return coords;
+}
+
+//! The distance between two points along the axes.
+template <std::size_t Dims>
+std::int64_t Distance(const std::array<std::uint32_t, Dims>& lhs,
+                      const std::array<std::uint32_t, Dims>& rhs) {
+    std::int64_t dist {0};
+    for (std::size_t i {0}; i != Dims; ++i) {
+        dist += std::abs(static_cast<std::int64_t>(lhs[i]) - static_cast<std::int64_t>(rhs[i]));
+    }
+
+    return dist;
+}
+
+}  // namespace
+
+TEST(Hilbert, States) {
+    static_assert(detail::hilbert_state_count<2> == 8);
+    static_assert(detail::hilbert_state_count<3> == 48);
+}
+
+TEST(Hilbert, Curve2D) {
+    static_assert(HilbertEncode2D(0, 0) == 0);
+
+    // The first keys fill a square and each key is next to the previous one.
+    constexpr std::uint32_t side {64};
+    std::vector<bool> visited(side * side);
+    auto prev {HilbertDecode2D(0)};
+    for (std::uint64_t key {0}; key != side * side; ++key) {
+        const auto point {HilbertDecode2D(key)};
+        ASSERT_LT(point[0], side);
+        ASSERT_LT(point[1], side);
+        ASSERT_FALSE(visited[point[1] * side + point[0]]);
+        visited[point[1] * side + point[0]] = true;
+        ASSERT_EQ(HilbertEncode2D(point[0], point[1]), key);
+        if (key != 0) {
+            ASSERT_EQ(Distance(prev, point), 1) << "key: " << key;
+        }
+
+        prev = point;
+    }
+}
+
+TEST(Hilbert, Curve3D) {
+    static_assert(HilbertEncode3D(0, 0, 0) == 0);
+
+    constexpr std::uint32_t side {16};
+    std::vector<bool> visited(side * side * side);
+    auto prev {HilbertDecode3D(0)};
+    for (std::uint64_t key {0}; key != side * side * side; ++key) {
+        const auto point {HilbertDecode3D(key)};
+        const auto idx {(point[2] * side + point[1]) * side + point[0]};
+        ASSERT_LT(idx, visited.size());
+        ASSERT_FALSE(visited[idx]);
+        visited[idx] = true;
+        ASSERT_EQ(HilbertEncode3D(point[0], point[1], point[2]), key);
+        if (key != 0) {
+            ASSERT_EQ(Distance(prev, point), 1) << "key: " << key;
+        }
+
+        prev = point;
+    }
+}
+
+TEST(Hilbert, Extremes) {
+    constexpr std::uint32_t max_2d {0xFFFF'FFFF};
+    const auto key_2d {HilbertEncode2D(max_2d, 0)};
+    EXPECT_EQ(HilbertDecode2D(key_2d), (std::array<std::uint32_t, 2> {max_2d, 0}));
+    EXPECT_EQ(HilbertDecode2D(0xFFFF'FFFF'FFFF'FFFF)[1], 0);
+
+    constexpr std::uint32_t max_3d {(1U << morton_3d_width) - 1};
+    const auto key_3d {HilbertEncode3D(max_3d, max_3d, 0)};
+    EXPECT_LT(key_3d, 1ULL << (morton_3d_width * 3));
+    EXPECT_EQ(HilbertDecode3D(key_3d), (std::array<std::uint32_t, 3> {max_3d, max_3d, 0}));
+}
+
+TEST(Hilbert, Bulk) {
+    constexpr std::size_t size {1003};
+    const auto xs {MakeCoords(size, 1, 32)};
+    const auto ys {MakeCoords(size, 2, 32)};
+    std::vector<std::uint64_t> keys(size);
+    HilbertEncode2D(xs, ys, keys);
+    for (std::size_t i {0}; i != size; ++i) {
+        ASSERT_EQ(keys[i], HilbertEncode2D(xs[i], ys[i])) << "index: " << i;
+    }
+
+    std::vector<std::uint32_t> decoded_xs(size);
+    std::vector<std::uint32_t> decoded_ys(size);
+    HilbertDecode2D(keys, decoded_xs, decoded_ys);
+    EXPECT_EQ(decoded_xs, xs);
+    EXPECT_EQ(decoded_ys, ys);
+
+    const auto zs {MakeCoords(size, 3, morton_3d_width)};
+    auto narrow_xs {xs};
+    auto narrow_ys {ys};
+    for (std::size_t i {0}; i != size; ++i) {
+        narrow_xs[i] = GetBits(xs[i], 0, morton_3d_width);
+        narrow_ys[i] = GetBits(ys[i], 0, morton_3d_width);
+    }
+
+    HilbertEncode3D(narrow_xs, narrow_ys, zs, keys);
+    for (std::size_t i {0}; i != size; ++i) {
+        ASSERT_EQ(keys[i], HilbertEncode3D(narrow_xs[i], narrow_ys[i], zs[i])) << "index: " << i;
+    }
+
+    std::vector<std::uint32_t> decoded_zs(size);
+    HilbertDecode3D(keys, decoded_xs, decoded_ys, decoded_zs);
+    EXPECT_EQ(decoded_xs, narrow_xs);
+    EXPECT_EQ(decoded_ys, narrow_ys);
+    EXPECT_EQ(decoded_zs, zs);
+}
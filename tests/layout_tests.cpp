@@ -0,0 +1,83 @@
+#include "bit_manip/layout.h"
+
+#include <gtest/gtest.h>
+
+using namespace bit;
+
+namespace {
+
+using Header = BitLayout<std::uint32_t, Field<"ver", 0, 4>, Field<"len", 4, 12>,
+                         Field<"flags", 16, 8>, Field<"type", 24, 8>>;
+
+struct UnpackedHeader {
+    std::uint32_t ver;
+    std::uint32_t len;
+    std::uint32_t flags;
+    std::uint32_t type;
+};
+
+}  // namespace
+
+TEST(BitLayout, IndexOf) {
+    static_assert(Header::size == 4);
+    EXPECT_EQ(Header::IndexOf<"ver">(), 0);
+    EXPECT_EQ(Header::IndexOf<"type">(), 3);
+}
+
+TEST(BitLayout, Get) {
+    constexpr std::uint32_t word {0x12345678};
+    static_assert(Header::Get<"ver">(word) == 0x8);
+
+    EXPECT_EQ(Header::Get<"ver">(word), 0x8);
+    EXPECT_EQ(Header::Get<"len">(word), 0x567);
+    EXPECT_EQ(Header::Get<"flags">(word), 0x34);
+    EXPECT_EQ(Header::Get<"type">(word), 0x12);
+}
+
+TEST(BitLayout, Set) {
+    std::uint32_t word {0x12345678};
+
+    Header::Set<"ver">(word, 0xF);
+    EXPECT_EQ(word, 0x1234567F);
+
+    Header::Set<"len">(word, 0xABC);
+    EXPECT_EQ(word, 0x1234ABCF);
+
+    // Bits that do not fit in the field are dropped.
+    Header::Set<"flags">(word, 0x1FF);
+    EXPECT_EQ(word, 0x12FFABCF);
+
+    Header::Set<"type">(word, 0x00);
+    EXPECT_EQ(word, 0x00FFABCF);
+}
+
+TEST(BitLayout, Clear) {
+    std::uint32_t word {0x12345678};
+
+    Header::Clear<"len">(word);
+    EXPECT_EQ(word, 0x12340008);
+
+    Header::Clear<"type">(word);
+    EXPECT_EQ(word, 0x00340008);
+}
+
+TEST(BitLayout, Unpack) {
+    constexpr std::uint32_t word {0x12345678};
+
+    EXPECT_EQ(Header::Unpack(word), (std::array<std::uint32_t, 4> {0x8, 0x567, 0x34, 0x12}));
+
+    const auto header {Header::Unpack<UnpackedHeader>(word)};
+    EXPECT_EQ(header.ver, 0x8);
+    EXPECT_EQ(header.len, 0x567);
+    EXPECT_EQ(header.flags, 0x34);
+    EXPECT_EQ(header.type, 0x12);
+}
+
+TEST(BitLayout, Pack) {
+    static_assert(Header::Pack(0x8, 0x567, 0x34, 0x12) == 0x12345678);
+
+    // A layout with gaps leaves the unused bits cleared.
+    using Sparse = BitLayout<std::uint16_t, Field<"low", 0, 3>, Field<"high", 12, 4>>;
+    EXPECT_EQ(Sparse::Pack(0xF, 0xF), 0xF007);
+    EXPECT_EQ(Sparse::Unpack(0xFFFF), (std::array<std::uint16_t, 2> {0x7, 0xF}));
+}
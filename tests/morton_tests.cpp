@@ -0,0 +1,110 @@
+#include "bit_manip/bit_manip.h"
+#include "bit_manip/morton.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+//! Interleave coordinates bit by bit.
+std::uint64_t InterleaveNaive(const std::vector<std::uint32_t>& coords, const std::size_t width) {
+    std::uint64_t key {0};
+    for (std::size_t i {0}; i != width; ++i) {
+        for (std::size_t dim {0}; dim != coords.size(); ++dim) {
+            if (IsBitSet(coords[dim], i)) {
+                SetBit(key, i * coords.size() + dim);
+            }
+        }
+    }
+
+    return key;
+}
+
+std::vector<std::uint32_t> MakeCoords(const std::size_t size, const std::uint64_t seed,
+                                      const std::size_t width) {
+    auto coords {test::RandomValues<std::uint32_t>(size, seed)};
+    for (auto& coord : coords) {
+        coord = GetBits(coord, 0, width);
+    }
+
+    return coords;
+}
+
+}  // namespace
+
+TEST(Morton, Encode2D) {
+    static_assert(MortonEncode2D<std::uint8_t>(0b11, 0b01) == 0b0111);
+    static_assert(MortonEncode2D<std::uint8_t>(0xFF, 0) == 0x5555);
+    static_assert(MortonEncode2D<std::uint16_t>(0, 0xFFFF) == 0xAAAA'AAAA);
+
+    EXPECT_EQ(MortonEncode2D<std::uint8_t>(0b11, 0b01), 0b0111);
+    EXPECT_EQ(MortonEncode2D<std::uint32_t>(0xFFFF'FFFF, 0), 0x5555'5555'5555'5555);
+    EXPECT_EQ(MortonEncode2D<std::uint32_t>(0, 0xFFFF'FFFF), 0xAAAA'AAAA'AAAA'AAAA);
+    EXPECT_EQ(MortonEncode2D<std::uint32_t>(0x1234'5678, 0x9ABC'DEF0),
+              InterleaveNaive({0x1234'5678, 0x9ABC'DEF0}, 32));
+}
+
+TEST(Morton, Decode2D) {
+    static_assert(MortonDecode2D(std::uint16_t {0b0111}) == std::array<std::uint8_t, 2> {3, 1});
+
+    const auto [x, y] {MortonDecode2D(std::uint64_t {0xAAAA'AAAA'5555'5555})};
+    EXPECT_EQ(x, 0x0000'FFFF);
+    EXPECT_EQ(y, 0xFFFF'0000);
+    EXPECT_EQ(MortonDecode2D(std::uint32_t {0xFFFF'FFFF}),
+              (std::array<std::uint16_t, 2> {0xFFFF, 0xFFFF}));
+}
+
+TEST(Morton, Encode3D) {
+    static_assert(MortonEncode3D(1, 0, 0) == 0b001);
+    static_assert(MortonEncode3D(0, 0, 1) == 0b100);
+    static_assert(MortonEncode3D(0x1F'FFFF, 0, 0) == 0x1249'2492'4924'9249);
+
+    constexpr std::uint32_t max {(1U << morton_3d_width) - 1};
+    EXPECT_EQ(MortonEncode3D(max, max, max), 0x7FFF'FFFF'FFFF'FFFF);
+    EXPECT_EQ(MortonEncode3D(0x12'3456, 0x0A'BCDE, 0x1F'0F0F),
+              InterleaveNaive({0x12'3456, 0x0A'BCDE, 0x1F'0F0F}, morton_3d_width));
+    EXPECT_EQ(MortonDecode3D(MortonEncode3D(0x12'3456, 0x0A'BCDE, 0x1F'0F0F)),
+              (std::array<std::uint32_t, 3> {0x12'3456, 0x0A'BCDE, 0x1F'0F0F}));
+}
+
+TEST(Morton, Bulk2D) {
+    // Sizes that are not multiples of the vector width leave a scalar tail.
+    constexpr std::size_t size {1003};
+    const auto xs {MakeCoords(size, 1, 32)};
+    const auto ys {MakeCoords(size, 2, 32)};
+    std::vector<std::uint64_t> keys(size);
+    MortonEncode2D(xs, ys, keys);
+    for (std::size_t i {0}; i != size; ++i) {
+        ASSERT_EQ(keys[i], MortonEncode2D(xs[i], ys[i])) << "index: " << i;
+    }
+
+    std::vector<std::uint32_t> decoded_xs(size);
+    std::vector<std::uint32_t> decoded_ys(size);
+    MortonDecode2D(keys, decoded_xs, decoded_ys);
+    EXPECT_EQ(decoded_xs, xs);
+    EXPECT_EQ(decoded_ys, ys);
+}
+
+TEST(Morton, Bulk3D) {
+    constexpr std::size_t size {1003};
+    const auto xs {MakeCoords(size, 1, morton_3d_width)};
+    const auto ys {MakeCoords(size, 2, morton_3d_width)};
+    const auto zs {MakeCoords(size, 3, morton_3d_width)};
+    std::vector<std::uint64_t> keys(size);
+    MortonEncode3D(xs, ys, zs, keys);
+    for (std::size_t i {0}; i != size; ++i) {
+        ASSERT_EQ(keys[i], MortonEncode3D(xs[i], ys[i], zs[i])) << "index: " << i;
+    }
+
+    std::vector<std::uint32_t> decoded_xs(size);
+    std::vector<std::uint32_t> decoded_ys(size);
+    std::vector<std::uint32_t> decoded_zs(size);
+    MortonDecode3D(keys, decoded_xs, decoded_ys, decoded_zs);
+    EXPECT_EQ(decoded_xs, xs);
+    EXPECT_EQ(decoded_ys, ys);
+    EXPECT_EQ(decoded_zs, zs);
+}
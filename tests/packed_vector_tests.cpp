@@ -0,0 +1,120 @@
+#include "bit_manip/packed_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+
+using namespace bit;
+
+static_assert(std::random_access_iterator<PackedVector<11>::const_iterator>);
+
+namespace {
+
+template <std::size_t Width>
+void ExpectRoundTrip(PackedVector<Width> vec, const std::size_t size) {
+    const auto mask {static_cast<std::uint32_t>((std::uint64_t {1} << vec.width()) - 1)};
+    for (std::size_t i {0}; i != size; ++i) {
+        vec.push_back(static_cast<std::uint32_t>(i * 2654435761U));
+    }
+
+    ASSERT_EQ(vec.size(), size);
+    for (std::size_t i {0}; i != size; ++i) {
+        ASSERT_EQ(vec[i], static_cast<std::uint32_t>(i * 2654435761U) & mask) << "index: " << i;
+    }
+}
+
+}  // namespace
+
+TEST(PackedVector, PushBack) {
+    ExpectRoundTrip(PackedVector<1> {}, 100);
+    ExpectRoundTrip(PackedVector<11> {}, 1000);
+    ExpectRoundTrip(PackedVector<17> {}, 1000);
+    ExpectRoundTrip(PackedVector<32> {}, 100);
+
+    for (std::size_t width {1}; width <= 32; ++width) {
+        ExpectRoundTrip(PackedVector<> {width}, 200);
+    }
+}
+
+TEST(PackedVector, Set) {
+    PackedVector<11> vec(100);
+    EXPECT_EQ(vec.size(), 100);
+    EXPECT_TRUE(std::ranges::all_of(vec, [](const auto val) { return val == 0; }));
+
+    // Index 2 straddles the first double word boundary.
+    vec[2] = 0x7FF;
+    EXPECT_EQ(vec[1], 0);
+    EXPECT_EQ(vec[2], 0x7FF);
+    EXPECT_EQ(vec[3], 0);
+
+    // Bits that do not fit in the width are dropped.
+    vec[3] = 0xFFFF;
+    EXPECT_EQ(vec[3], 0x7FF);
+
+    vec[2] = vec[1];
+    EXPECT_EQ(vec[2], 0);
+    EXPECT_EQ(vec[3], 0x7FF);
+}
+
+TEST(PackedVector, MemorySize) {
+    constexpr std::size_t size {1000};
+    const PackedVector<11> vec(size);
+    EXPECT_LE(vec.memory_size(), size * 11 / CHAR_BIT + 2 * sizeof(std::uint32_t));
+}
+
+TEST(PackedVector, Resize) {
+    PackedVector<> vec {17, 10, 0x1FFFF};
+    EXPECT_EQ(vec.width(), 17);
+    EXPECT_EQ(vec.back(), 0x1FFFF);
+
+    vec.resize(3);
+    vec.resize(5);
+    EXPECT_EQ(vec[2], 0x1FFFF);
+    EXPECT_EQ(vec[3], 0);
+    EXPECT_EQ(vec[4], 0);
+
+    vec.pop_back();
+    vec.push_back(1);
+    EXPECT_EQ(vec.size(), 5);
+    EXPECT_EQ(vec.back(), 1);
+
+    vec.clear();
+    EXPECT_TRUE(vec.empty());
+    vec.push_back(2);
+    EXPECT_EQ(vec.front(), 2);
+}
+
+TEST(PackedVector, Iterator) {
+    PackedVector<5> vec;
+    for (std::uint32_t i {0}; i != 20; ++i) {
+        vec.push_back(i);
+    }
+
+    EXPECT_EQ(vec.end() - vec.begin(), 20);
+    EXPECT_EQ(vec.begin()[7], 7);
+    EXPECT_EQ(*(vec.end() - 1), 19);
+    EXPECT_EQ(std::accumulate(vec.begin(), vec.end(), 0U), 190);
+    EXPECT_TRUE(std::ranges::is_sorted(vec));
+}
+
+TEST(PackedVector, Unpack) {
+    PackedVector<13> fixed;
+    PackedVector<> dynamic {13};
+    for (std::uint32_t i {0}; i != 300; ++i) {
+        fixed.push_back(i * 7);
+        dynamic.push_back(i * 7);
+    }
+
+    for (const std::size_t first : {0, 1, 31, 32, 33}) {
+        std::vector<std::uint32_t> fixed_out(fixed.size() - first);
+        std::vector<std::uint32_t> dynamic_out(fixed_out.size());
+        fixed.Unpack(fixed_out, first);
+        dynamic.Unpack(dynamic_out, first);
+        for (std::size_t i {0}; i != fixed_out.size(); ++i) {
+            ASSERT_EQ(fixed_out[i], fixed[first + i]) << "first: " << first << ", index: " << i;
+            ASSERT_EQ(dynamic_out[i], fixed[first + i]) << "first: " << first << ", index: " << i;
+        }
+    }
+}
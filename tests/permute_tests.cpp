@@ -0,0 +1,171 @@
+#include "bit_manip/permute.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <numeric>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+template <std::unsigned_integral T>
+T PermuteLoop(const T val, const typename BitPermutation<T>::Sources& sources) {
+    T permuted {0};
+    for (std::size_t i {0}; i != sources.size(); ++i) {
+        if (IsBitSet(val, sources[i])) {
+            SetBit(permuted, i);
+        }
+    }
+
+    return permuted;
+}
+
+template <std::integral T>
+T ReverseBitsLoop(const T val) {
+    constexpr std::size_t width {sizeof(T) * CHAR_BIT};
+    T reversed {0};
+    for (std::size_t i {0}; i != width; ++i) {
+        if (IsBitSet(val, i)) {
+            SetBit(reversed, width - 1 - i);
+        }
+    }
+
+    return reversed;
+}
+
+template <std::integral T>
+void ExpectBulkReverseBits() {
+    for (const std::size_t size : {0, 1, 7, 16, 33, 1003}) {
+        const auto vals {test::RandomValues<T>(size)};
+        std::vector<T> out(size);
+        ReverseBits<T>(vals, out);
+        for (std::size_t i {0}; i != size; ++i) {
+            EXPECT_EQ(out[i], ReverseBitsLoop(vals[i]));
+        }
+
+        ReverseBits(std::span {out});
+        EXPECT_EQ(out, vals);
+
+        SwapNibbles<T>(vals, out);
+        for (std::size_t i {0}; i != size; ++i) {
+            EXPECT_EQ(out[i], SwapNibbles(vals[i]));
+        }
+
+        SwapNibbles(std::span {out});
+        EXPECT_EQ(out, vals);
+    }
+}
+
+//! Make permutations with a shuffle of a seed, a rotation and a reversal.
+template <std::unsigned_integral T>
+std::vector<typename BitPermutation<T>::Sources> MakePermutations() {
+    using Sources = typename BitPermutation<T>::Sources;
+    std::vector<Sources> perms(3);
+    auto seed {test::default_seed};
+    std::iota(perms[0].begin(), perms[0].end(), std::uint8_t {0});
+    for (std::size_t i {perms[0].size() - 1}; i != 0; --i) {
+        std::swap(perms[0][i], perms[0][test::NextRandom(seed) % (i + 1)]);
+    }
+
+    for (std::size_t i {0}; i != perms[1].size(); ++i) {
+        perms[1][i] = static_cast<std::uint8_t>((i + 3) % perms[1].size());
+        perms[2][i] = static_cast<std::uint8_t>(perms[2].size() - 1 - i);
+    }
+
+    return perms;
+}
+
+template <std::unsigned_integral T>
+void ExpectBitPermutation() {
+    const auto vals {test::RandomValues<T>(131)};
+    for (const auto& sources : MakePermutations<T>()) {
+        const BitPermutation<T> perm {sources};
+        std::vector<T> out(vals.size());
+        perm(vals, out);
+        for (std::size_t i {0}; i != vals.size(); ++i) {
+            EXPECT_EQ(perm(vals[i]), PermuteLoop(vals[i], sources));
+            EXPECT_EQ(out[i], PermuteLoop(vals[i], sources));
+        }
+    }
+}
+
+}  // namespace
+
+TEST(Permute, ReverseBits) {
+    static_assert(ReverseBits(std::uint8_t {0b0000'0001}) == 0b1000'0000);
+    static_assert(ReverseBits(std::uint8_t {0b1100'1010}) == 0b0101'0011);
+    static_assert(ReverseBits(std::uint16_t {0x0001}) == 0x8000);
+    static_assert(ReverseBits(std::uint32_t {0x0000'00F1}) == 0x8F00'0000);
+    static_assert(ReverseBits(std::uint64_t {0x0123'4567'89AB'CDEF}) == 0xF7B3'D591'E6A2'C480);
+    static_assert(ReverseBits(std::int8_t {1}) == std::int8_t {-128});
+
+    for (const auto val : test::RandomValues<std::uint64_t>(64)) {
+        EXPECT_EQ(ReverseBits(val), ReverseBitsLoop(val));
+        EXPECT_EQ(ReverseBits(static_cast<std::uint16_t>(val)),
+                  ReverseBitsLoop(static_cast<std::uint16_t>(val)));
+    }
+}
+
+TEST(Permute, SwapNibbles) {
+    static_assert(SwapNibbles(std::uint8_t {0x12}) == 0x21);
+    static_assert(SwapNibbles(std::uint32_t {0x1234'ABCD}) == 0x2143'BADC);
+    static_assert(SwapNibbles(std::uint64_t {0x0F00'0000'0000'00F0}) == 0xF000'0000'0000'000F);
+}
+
+TEST(Permute, BulkReverseBits) {
+    ExpectBulkReverseBits<std::uint8_t>();
+    ExpectBulkReverseBits<std::uint16_t>();
+    ExpectBulkReverseBits<std::uint32_t>();
+    ExpectBulkReverseBits<std::uint64_t>();
+    ExpectBulkReverseBits<std::int64_t>();
+}
+
+#if defined(BIT_MANIP_DISPATCH)
+
+TEST(Permute, ReverseBitsKernels) {
+    using Kernel = std::size_t (*)(const void*, void*, std::size_t);
+    const auto& cpu {GetCpuFeatures()};
+    std::vector<Kernel> kernels;
+    if (cpu.ssse3) {
+        kernels.push_back(&detail::ReverseBitsSsse3<sizeof(std::uint32_t)>);
+    }
+
+    if (cpu.avx2) {
+        kernels.push_back(&detail::ReverseBitsAvx2<sizeof(std::uint32_t)>);
+    }
+
+    if (cpu.avx2 && cpu.gfni) {
+        kernels.push_back(&detail::ReverseBitsGfni<sizeof(std::uint32_t)>);
+    }
+
+    const auto vals {test::RandomValues<std::uint32_t>(67)};
+    for (const auto kernel : kernels) {
+        std::vector<std::uint32_t> out(vals.size());
+        const auto done {kernel(vals.data(), out.data(), vals.size())};
+        EXPECT_EQ(done, 64);
+        for (std::size_t i {0}; i != done; ++i) {
+            EXPECT_EQ(out[i], ReverseBitsLoop(vals[i]));
+        }
+    }
+}
+
+#endif
+
+TEST(Permute, BitPermutation) {
+    static_assert([] {
+        BitPermutation<std::uint8_t>::Sources sources {};
+        for (std::size_t i {0}; i != sources.size(); ++i) {
+            sources[i] = static_cast<std::uint8_t>(sources.size() - 1 - i);
+        }
+
+        return BitPermutation<std::uint8_t> {sources}(0b1100'1010) == 0b0101'0011;
+    }());
+
+    ExpectBitPermutation<std::uint8_t>();
+    ExpectBitPermutation<std::uint16_t>();
+    ExpectBitPermutation<std::uint32_t>();
+    ExpectBitPermutation<std::uint64_t>();
+}
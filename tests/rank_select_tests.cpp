@@ -0,0 +1,121 @@
+#include "bit_manip/rank_select.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+//! Build a bitset where each bit is set with a probability of about `1 / period`.
+Bitset MakeBitset(const std::size_t size, const std::uint64_t period) {
+    Bitset bits {size};
+    const auto vals {test::RandomValues<std::uint64_t>(size)};
+    for (std::size_t i {0}; i != size; ++i) {
+        if (vals[i] % period == 0) {
+            bits.Set(i);
+        }
+    }
+
+    return bits;
+}
+
+void ExpectMatchesScan(const Bitset& bits) {
+    const RankSelect index {bits};
+    std::vector<std::size_t> positions;
+    std::vector<std::size_t> zero_positions;
+    std::size_t rank {0};
+    for (std::size_t i {0}; i != bits.size(); ++i) {
+        ASSERT_EQ(index.Rank1(i), rank) << "index: " << i;
+        if (bits.IsSet(i)) {
+            positions.push_back(i);
+            ++rank;
+        } else {
+            zero_positions.push_back(i);
+        }
+    }
+
+    ASSERT_EQ(index.Rank1(bits.size()), rank);
+    ASSERT_EQ(index.ones(), rank);
+    for (std::size_t i {0}; i != positions.size(); ++i) {
+        ASSERT_EQ(index.Select1(i), positions[i]) << "rank: " << i;
+    }
+
+    EXPECT_EQ(index.Select1(positions.size()), RankSelect::npos);
+    for (std::size_t i {0}; i != zero_positions.size(); ++i) {
+        ASSERT_EQ(index.Select0(i), zero_positions[i]) << "rank: " << i;
+    }
+
+    EXPECT_EQ(index.Select0(zero_positions.size()), RankSelect::npos);
+}
+
+}  // namespace
+
+TEST(RankSelect, SelectInWord) {
+    constexpr std::uint64_t word {0x8000'0100'0000'0013};
+    static_assert(SelectInWord(word, 0) == 0);
+
+    EXPECT_EQ(SelectInWord(word, 1), 1);
+    EXPECT_EQ(SelectInWord(word, 2), 4);
+    EXPECT_EQ(SelectInWord(word, 3), 40);
+    EXPECT_EQ(SelectInWord(word, 4), 63);
+}
+
+TEST(RankSelect, Rank) {
+    Bitset bits {5000};
+    bits.Set(0);
+    bits.Set(511);
+    bits.Set(512);
+    bits.Set(2048);
+    bits.Set(4999);
+
+    const RankSelect index {bits};
+    EXPECT_EQ(index.Rank1(0), 0);
+    EXPECT_EQ(index.Rank1(1), 1);
+    EXPECT_EQ(index.Rank1(512), 2);
+    EXPECT_EQ(index.Rank1(513), 3);
+    EXPECT_EQ(index.Rank1(2048), 3);
+    EXPECT_EQ(index.Rank1(2049), 4);
+    EXPECT_EQ(index.Rank1(5000), 5);
+    EXPECT_EQ(index.Rank0(5000), 4995);
+}
+
+TEST(RankSelect, Select) {
+    Bitset bits {5000};
+    bits.Set(7);
+    bits.Set(2047);
+    bits.Set(4999);
+
+    const RankSelect index {bits};
+    EXPECT_EQ(index.Select1(0), 7);
+    EXPECT_EQ(index.Select1(1), 2047);
+    EXPECT_EQ(index.Select1(2), 4999);
+    EXPECT_EQ(index.Select1(3), RankSelect::npos);
+
+    EXPECT_EQ(index.Select0(0), 0);
+    EXPECT_EQ(index.Select0(7), 8);
+    EXPECT_EQ(index.Select0(2046), 2048);
+    EXPECT_EQ(index.Select0(4996), 4998);
+    EXPECT_EQ(index.Select0(4997), RankSelect::npos);
+}
+
+TEST(RankSelect, MatchesScan) {
+    ExpectMatchesScan(Bitset {0});
+    ExpectMatchesScan(Bitset {10000});
+    ExpectMatchesScan(Bitset {10000, true});
+    ExpectMatchesScan(MakeBitset(100000, 2));
+    ExpectMatchesScan(MakeBitset(100000, 37));
+    ExpectMatchesScan(MakeBitset(100003, 1000));
+
+    auto dense {MakeBitset(100003, 1000)};
+    dense.Flip();
+    ExpectMatchesScan(dense);
+}
+
+TEST(RankSelect, MemorySize) {
+    const Bitset bits {1 << 20, true};
+    const RankSelect index {bits};
+    EXPECT_LE(index.memory_size() * CHAR_BIT, bits.size() * 4 / 100);
+}
@@ -0,0 +1,182 @@
+#include "bit_manip/roaring.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+std::vector<std::uint32_t> Values(const RoaringBitmap& bitmap) {
+    std::vector<std::uint32_t> vals;
+    bitmap.ForEach([&vals](const std::uint32_t val) { vals.push_back(val); });
+    return vals;
+}
+
+/**
+ * @brief Make sorted values of four chunks with a seed.
+ *
+ * @details
+ * The chunks are sparse, dense, made of long runs, and sparse with a key that only some seeds use.
+ */
+std::vector<std::uint32_t> MakeValues(std::uint64_t seed) {
+    const auto next {[&seed] { return test::NextRandom(seed); }};
+
+    std::vector<std::uint32_t> vals;
+    for (std::size_t i {0}; i != 1000; ++i) {
+        vals.push_back(static_cast<std::uint32_t>(next() % 8192));
+    }
+
+    for (std::size_t i {0}; i != 20000; ++i) {
+        vals.push_back(CombineWords(3, static_cast<std::uint16_t>(next())));
+    }
+
+    for (std::uint32_t start {0}; start < 0x10000; start += next() % 4096 + 1) {
+        const auto length {next() % 2048};
+        for (std::uint32_t val {start}; val <= std::min<std::uint32_t>(start + length, 0xFFFF);
+             ++val) {
+            vals.push_back(CombineWords(7, static_cast<std::uint16_t>(val)));
+        }
+    }
+
+    if (seed % 2 == 0) {
+        vals.push_back(0xFFFF'FFFF);
+    }
+
+    std::ranges::sort(vals);
+    const auto [last, end] {std::ranges::unique(vals)};
+    vals.erase(last, end);
+    return vals;
+}
+
+}  // namespace
+
+TEST(RoaringBitmap, AddRemove) {
+    RoaringBitmap bitmap;
+    EXPECT_TRUE(bitmap.empty());
+    bitmap.Add(5);
+    bitmap.Add(0x1'0000);
+    bitmap.Add(5);
+    bitmap.Add(0xFFFF'FFFF);
+    EXPECT_EQ(bitmap.Count(), 3);
+    EXPECT_TRUE(bitmap.Contains(5));
+    EXPECT_TRUE(bitmap.Contains(0x1'0000));
+    EXPECT_TRUE(bitmap.Contains(0xFFFF'FFFF));
+    EXPECT_FALSE(bitmap.Contains(6));
+    EXPECT_EQ(Values(bitmap), (std::vector<std::uint32_t> {5, 0x1'0000, 0xFFFF'FFFF}));
+
+    bitmap.Remove(0x1'0000);
+    bitmap.Remove(7);
+    EXPECT_EQ(Values(bitmap), (std::vector<std::uint32_t> {5, 0xFFFF'FFFF}));
+    bitmap.Remove(5);
+    bitmap.Remove(0xFFFF'FFFF);
+    EXPECT_TRUE(bitmap.empty());
+}
+
+TEST(RoaringBitmap, Containers) {
+    // Grow an array into a bitmap and shrink it back.
+    RoaringBitmap bitmap;
+    for (std::uint32_t val {0}; val != 10000; ++val) {
+        bitmap.Add(val * 3);
+    }
+
+    const auto dense_size {bitmap.SerializedSize()};
+    EXPECT_EQ(bitmap.Count(), 10000);
+    EXPECT_TRUE(bitmap.Contains(9999 * 3));
+    EXPECT_FALSE(bitmap.Contains(9999 * 3 + 1));
+    for (std::uint32_t val {0}; val != 9000; ++val) {
+        bitmap.Remove(val * 3);
+    }
+
+    EXPECT_EQ(bitmap.Count(), 1000);
+    EXPECT_LT(bitmap.SerializedSize(), dense_size);
+    EXPECT_EQ(Values(bitmap).front(), 9000 * 3);
+
+    // Runs are chosen when they are the smallest.
+    RoaringBitmap runs;
+    for (std::uint32_t val {100}; val != 60000; ++val) {
+        runs.Add(val);
+    }
+
+    const auto before {runs};
+    runs.RunOptimize();
+    EXPECT_EQ(runs, before);
+    EXPECT_LT(runs.SerializedSize(), before.SerializedSize());
+    EXPECT_EQ(runs.Count(), 59900);
+
+    // Updating runs splits and joins them.
+    runs.Remove(100);
+    runs.Remove(500);
+    runs.Remove(59999);
+    runs.Add(500);
+    runs.Add(99);
+    runs.Add(60000);
+    runs.Add(60002);
+    runs.Add(60001);
+    EXPECT_FALSE(runs.Contains(100));
+    EXPECT_TRUE(runs.Contains(99));
+    EXPECT_FALSE(runs.Contains(59999));
+    EXPECT_TRUE(runs.Contains(60002));
+    EXPECT_EQ(runs.Count(), 59902);
+}
+
+TEST(RoaringBitmap, SetAlgebra) {
+    for (const bool optimize : {false, true}) {
+        const auto lhs_vals {MakeValues(0x9E3779B97F4A7C15)};
+        const auto rhs_vals {MakeValues(0x2545F4914F6CDD1E)};
+        RoaringBitmap lhs {lhs_vals};
+        RoaringBitmap rhs {rhs_vals};
+        if (optimize) {
+            lhs.RunOptimize();
+        }
+
+        std::vector<std::uint32_t> expected;
+        std::ranges::set_intersection(lhs_vals, rhs_vals, std::back_inserter(expected));
+        EXPECT_EQ(Values(lhs & rhs), expected);
+        EXPECT_EQ(Values(rhs & lhs), expected);
+
+        expected.clear();
+        std::ranges::set_union(lhs_vals, rhs_vals, std::back_inserter(expected));
+        EXPECT_EQ(Values(lhs | rhs), expected);
+        EXPECT_EQ(Values(rhs | lhs), expected);
+        EXPECT_EQ((lhs | rhs).Count(), expected.size());
+
+        rhs.RunOptimize();
+        EXPECT_EQ(Values(lhs & rhs), Values(RoaringBitmap {lhs_vals} & RoaringBitmap {rhs_vals}));
+        EXPECT_EQ(Values(lhs | rhs), expected);
+    }
+}
+
+TEST(RoaringBitmap, Serialize) {
+    const auto vals {MakeValues(0x9E3779B97F4A7C15)};
+    for (const bool optimize : {false, true}) {
+        RoaringBitmap bitmap {vals};
+        if (optimize) {
+            bitmap.RunOptimize();
+        }
+
+        std::vector<std::uint8_t> bytes(bitmap.SerializedSize());
+        EXPECT_EQ(bitmap.Serialize(bytes), bytes.size());
+        const auto copy {RoaringBitmap::Deserialize(bytes)};
+        ASSERT_TRUE(copy.has_value());
+        EXPECT_EQ(*copy, bitmap);
+        EXPECT_EQ(Values(*copy), vals);
+
+        for (const std::size_t size : {std::size_t {0}, std::size_t {3}, bytes.size() - 1}) {
+            EXPECT_FALSE(RoaringBitmap::Deserialize({bytes.data(), size}).has_value());
+        }
+    }
+
+    RoaringBitmap bitmap {std::vector<std::uint32_t> {1, 2}};
+    std::vector<std::uint8_t> bytes(bitmap.SerializedSize());
+    bitmap.Serialize(bytes);
+    EXPECT_EQ(bytes, (std::vector<std::uint8_t> {1, 0, 0, 0, 0, 0, 0, 2, 0, 0, 0, 1, 0, 2, 0}));
+    std::swap(bytes[11], bytes[13]);
+    EXPECT_FALSE(RoaringBitmap::Deserialize(bytes).has_value());
+    bytes[6] = 3;
+    EXPECT_FALSE(RoaringBitmap::Deserialize(bytes).has_value());
+}
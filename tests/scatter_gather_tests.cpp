@@ -0,0 +1,77 @@
+#include "bit_manip/scatter_gather.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+using namespace bit;
+
+namespace {
+
+template <std::unsigned_integral T>
+T NaiveExtract(const T val, const T mask) {
+    T result {0};
+    std::size_t out {0};
+    for (std::size_t i {0}; i != sizeof(T) * CHAR_BIT; ++i) {
+        if ((mask >> i) & 1) {
+            result |= static_cast<T>(((val >> i) & 1) << out++);
+        }
+    }
+
+    return result;
+}
+
+template <std::unsigned_integral T>
+T NaiveDeposit(const T val, const T mask) {
+    T result {0};
+    std::size_t in {0};
+    for (std::size_t i {0}; i != sizeof(T) * CHAR_BIT; ++i) {
+        if ((mask >> i) & 1) {
+            result |= static_cast<T>(((val >> in++) & 1) << i);
+        }
+    }
+
+    return result;
+}
+
+template <std::unsigned_integral T>
+void ExpectMatchesNaive() {
+    auto seed {test::default_seed};
+    const auto next {[&seed] { return static_cast<T>(test::NextRandom(seed)); }};
+
+    for (std::size_t i {0}; i != 1000; ++i) {
+        const auto val {next()};
+        // Mix dense and sparse masks.
+        const auto mask {static_cast<T>(i % 2 == 0 ? next() : next() & next() & next())};
+        ASSERT_EQ(ExtractBits(val, mask), NaiveExtract(val, mask));
+        ASSERT_EQ(DepositBits(val, mask), NaiveDeposit(val, mask));
+        ASSERT_EQ(detail::CompressBits(val, mask), NaiveExtract(val, mask));
+        ASSERT_EQ(detail::ExpandBits(val, mask), NaiveDeposit(val, mask));
+    }
+}
+
+}  // namespace
+
+TEST(ScatterGather, ExtractBits) {
+    static_assert(ExtractBits<std::uint8_t>(0b1011'0110, 0b1111'0000) == 0b1011);
+    static_assert(ExtractBits<std::uint32_t>(0x12345678, 0xFF00FF00) == 0x1256);
+
+    EXPECT_EQ(ExtractBits<std::uint16_t>(0xFFFF, 0), 0);
+    EXPECT_EQ(ExtractBits<std::uint16_t>(0x1234, 0xFFFF), 0x1234);
+    EXPECT_EQ(ExtractBits<std::uint64_t>(0x8000'0000'0000'0001, 0x8000'0000'0000'0001), 0b11);
+}
+
+TEST(ScatterGather, DepositBits) {
+    static_assert(DepositBits<std::uint8_t>(0b1011, 0b1111'0000) == 0b1011'0000);
+    static_assert(DepositBits<std::uint32_t>(0x1256, 0xFF00FF00) == 0x12005600);
+
+    EXPECT_EQ(DepositBits<std::uint16_t>(0xFFFF, 0), 0);
+    EXPECT_EQ(DepositBits<std::uint16_t>(0x1234, 0xFFFF), 0x1234);
+    EXPECT_EQ(DepositBits<std::uint64_t>(0b11, 0x8000'0000'0000'0001), 0x8000'0000'0000'0001);
+}
+
+TEST(ScatterGather, MatchesNaive) {
+    ExpectMatchesNaive<std::uint8_t>();
+    ExpectMatchesNaive<std::uint16_t>();
+    ExpectMatchesNaive<std::uint32_t>();
+    ExpectMatchesNaive<std::uint64_t>();
+}
@@ -0,0 +1,106 @@
+#include "bit_manip/slot_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace bit;
+
+TEST(SlotAllocator, AllocateAll) {
+    for (const std::size_t capacity : {0, 1, 63, 64, 100, 4096, 5000}) {
+        SlotAllocator slots {capacity};
+        EXPECT_EQ(slots.capacity(), capacity);
+        std::vector<bool> seen(capacity);
+        for (std::size_t i {0}; i != capacity; ++i) {
+            const auto slot {slots.Allocate()};
+            ASSERT_LT(slot, capacity);
+            ASSERT_FALSE(seen[slot]);
+            seen[slot] = true;
+            EXPECT_TRUE(slots.IsAllocated(slot));
+        }
+
+        EXPECT_EQ(slots.Allocate(), SlotAllocator::npos);
+        EXPECT_EQ(slots.Count(), capacity);
+    }
+}
+
+TEST(SlotAllocator, FreeAndReuse) {
+    SlotAllocator slots {200};
+    std::vector<std::size_t> allocated;
+    for (std::size_t i {0}; i != 200; ++i) {
+        allocated.push_back(slots.Allocate());
+    }
+
+    slots.Free(allocated[70]);
+    slots.Free(allocated[150]);
+    EXPECT_FALSE(slots.IsAllocated(allocated[70]));
+    EXPECT_EQ(slots.Count(), 198);
+
+    std::vector<std::size_t> reused {slots.Allocate(), slots.Allocate()};
+    std::ranges::sort(reused);
+    std::vector<std::size_t> freed {allocated[70], allocated[150]};
+    std::ranges::sort(freed);
+    EXPECT_EQ(reused, freed);
+    EXPECT_EQ(slots.Allocate(), SlotAllocator::npos);
+
+    for (const auto slot : allocated) {
+        slots.Free(slot);
+    }
+
+    EXPECT_EQ(slots.Count(), 0);
+}
+
+TEST(SlotAllocator, HintPerAllocator) {
+    // Allocating elsewhere must not move where a fresh allocator starts.
+    SlotAllocator first {10'000};
+    const auto start {first.Allocate()};
+    SlotAllocator other {10'000};
+    for (std::size_t i {0}; i != 5000; ++i) {
+        other.Allocate();
+    }
+
+    SlotAllocator second {10'000};
+    EXPECT_EQ(second.Allocate(), start);
+}
+
+TEST(SlotAllocator, Concurrent) {
+    constexpr std::size_t thread_count {8};
+    constexpr std::size_t capacity {10'000};
+    constexpr std::size_t rounds {20};
+    SlotAllocator slots {capacity};
+    std::vector<std::vector<std::size_t>> owned(thread_count);
+    std::vector<std::thread> threads;
+    for (std::size_t t {0}; t != thread_count; ++t) {
+        threads.emplace_back([&, t] {
+            // Churn through allocations and keep the last round.
+            for (std::size_t round {0}; round != rounds; ++round) {
+                for (const auto slot : owned[t]) {
+                    slots.Free(slot);
+                }
+
+                owned[t].clear();
+                for (std::size_t i {0}; i != capacity / thread_count; ++i) {
+                    owned[t].push_back(slots.Allocate());
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<std::size_t> all;
+    for (const auto& slots_of_thread : owned) {
+        all.insert(all.end(), slots_of_thread.begin(), slots_of_thread.end());
+    }
+
+    std::ranges::sort(all);
+    EXPECT_EQ(all.size(), capacity);
+    EXPECT_EQ(std::ranges::adjacent_find(all), all.end());
+    EXPECT_LT(all.back(), capacity);
+    EXPECT_EQ(slots.Count(), capacity);
+    EXPECT_EQ(slots.Allocate(), SlotAllocator::npos);
+}
@@ -0,0 +1,85 @@
+#include "bit_manip/stream_vbyte.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+//! Make values whose encoded lengths are spread from 1 to 4 bytes.
+std::vector<std::uint32_t> MakeMixedValues(const std::size_t size) {
+    std::vector<std::uint32_t> vals;
+    for (const auto val : test::RandomValues<std::uint64_t>(size)) {
+        vals.push_back(static_cast<std::uint32_t>(val >> (val % 32 + 32)));
+    }
+
+    return vals;
+}
+
+void ExpectRoundTrip(const std::vector<std::uint32_t>& vals) {
+    std::vector<std::uint8_t> encoded(StreamVByteMaxSize(vals.size()));
+    const auto size {EncodeStreamVByte(vals, encoded)};
+    std::vector<std::uint32_t> decoded(vals.size());
+    EXPECT_EQ(DecodeStreamVByte({encoded.data(), size}, decoded), size);
+    EXPECT_EQ(decoded, vals);
+
+    const auto delta_size {EncodeStreamVByteDelta(vals, encoded, 7)};
+    std::ranges::fill(decoded, 0);
+    EXPECT_EQ(DecodeStreamVByteDelta({encoded.data(), delta_size}, decoded, 7), delta_size);
+    EXPECT_EQ(decoded, vals);
+}
+
+}  // namespace
+
+TEST(StreamVByte, Size) {
+    static_assert(StreamVByteControlSize(0) == 0);
+    static_assert(StreamVByteControlSize(4) == 1);
+    static_assert(StreamVByteControlSize(5) == 2);
+    static_assert(StreamVByteMaxSize(5) == 22);
+}
+
+TEST(StreamVByte, Encode) {
+    const std::vector<std::uint32_t> vals {1, 0x1234, 0x12'3456, 0x1234'5678, 0};
+    std::vector<std::uint8_t> encoded(StreamVByteMaxSize(vals.size()));
+    ASSERT_EQ(EncodeStreamVByte(vals, encoded), 2 + 11);
+
+    // Length codes of four values in one byte, from the lowest bits.
+    EXPECT_EQ(encoded[0], 0b11'10'01'00);
+    EXPECT_EQ(encoded[1], 0b00);
+
+    const std::vector<std::uint8_t> data {0x01, 0x34, 0x12, 0x56, 0x34, 0x12,
+                                          0x78, 0x56, 0x34, 0x12, 0x00};
+    EXPECT_TRUE(std::ranges::equal(std::span {encoded}.subspan(2, data.size()), data));
+}
+
+TEST(StreamVByte, RoundTrip) {
+    ExpectRoundTrip({});
+    ExpectRoundTrip({0xFFFF'FFFF});
+    for (const std::size_t size : {3, 4, 17, 1000, 1003}) {
+        ExpectRoundTrip(MakeMixedValues(size));
+    }
+
+    ExpectRoundTrip(std::vector<std::uint32_t>(100, 0));
+}
+
+TEST(StreamVByte, DeltaOfSorted) {
+    auto vals {MakeMixedValues(1000)};
+    for (auto& val : vals) {
+        val %= 200;
+    }
+
+    std::partial_sum(vals.begin(), vals.end(), vals.begin());
+    ExpectRoundTrip(vals);
+
+    // Sorted values with small gaps take about one data byte each.
+    std::vector<std::uint8_t> encoded(StreamVByteMaxSize(vals.size()));
+    EXPECT_LE(EncodeStreamVByteDelta(vals, encoded, 0),
+              StreamVByteControlSize(vals.size()) + vals.size() * 2);
+    EXPECT_GT(EncodeStreamVByte(vals, encoded), StreamVByteControlSize(vals.size())
+                                                    + vals.size() * 2);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file test_utils.h
+ * @brief Shared helpers of tests.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bit::test {
+
+//! The seed of pseudo-random values unless a test chooses another one.
+inline constexpr std::uint64_t default_seed {0x9E3779B97F4A7C15};
+
+//! Advance a xorshift state and return it.
+constexpr std::uint64_t NextRandom(std::uint64_t& seed) noexcept {
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+//! Make pseudo-random values, each truncated from the next state of `seed`.
+template <std::integral T>
+std::vector<T> RandomValues(const std::size_t size, std::uint64_t seed = default_seed) {
+    std::vector<T> vals(size);
+    for (auto& val : vals) {
+        val = static_cast<T>(NextRandom(seed));
+    }
+
+    return vals;
+}
+
+}  // namespace bit::test
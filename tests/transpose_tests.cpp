@@ -0,0 +1,137 @@
+#include "bit_manip/bit_manip.h"
+#include "bit_manip/transpose.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+//! Transposed rows, with columns of `words` quad words each.
+template <std::unsigned_integral T>
+std::vector<std::uint64_t> TransposeLoop(const std::vector<T>& rows, const std::size_t words) {
+    std::vector<std::uint64_t> cols(sizeof(T) * CHAR_BIT * words);
+    for (std::size_t i {0}; i != rows.size(); ++i) {
+        for (std::size_t j {0}; j != sizeof(T) * CHAR_BIT; ++j) {
+            if (IsBitSet(rows[i], j)) {
+                SetBit(cols[j * words + i / 64], i % 64);
+            }
+        }
+    }
+
+    return cols;
+}
+
+template <std::unsigned_integral T>
+std::array<std::uint64_t*, sizeof(T) * CHAR_BIT> ColumnPointers(std::vector<std::uint64_t>& cols,
+                                                                 const std::size_t words) {
+    std::array<std::uint64_t*, sizeof(T) * CHAR_BIT> ptrs;
+    for (std::size_t j {0}; j != ptrs.size(); ++j) {
+        ptrs[j] = cols.data() + j * words;
+    }
+
+    return ptrs;
+}
+
+template <std::unsigned_integral T>
+void ExpectTranspose() {
+    for (const std::size_t size : {0, 1, 63, 64, 100, 128, 1000}) {
+        const auto rows {test::RandomValues<T>(size)};
+        const auto words {(size + 63) / 64};
+        // Fill the columns to check that bits beyond the rows are cleared.
+        std::vector<std::uint64_t> cols(sizeof(T) * CHAR_BIT * words,
+                                        static_cast<std::uint64_t>(-1));
+        Transpose<T>(rows, ColumnPointers<T>(cols, words));
+        EXPECT_EQ(cols, TransposeLoop(rows, words));
+    }
+}
+
+}  // namespace
+
+TEST(Transpose, Transpose8x8) {
+    static_assert(Transpose8x8(0x0000'0000'0000'00FF) == 0x0101'0101'0101'0101);
+    static_assert(Transpose8x8(0x8040'2010'0804'0201) == 0x8040'2010'0804'0201);
+    static_assert(Transpose8x8(0x0000'0000'0000'0002) == 0x0000'0000'0000'0100);
+
+    for (const auto val : test::RandomValues<std::uint64_t>(64)) {
+        const auto transposed {Transpose8x8(val)};
+        for (std::size_t i {0}; i != 8; ++i) {
+            for (std::size_t j {0}; j != 8; ++j) {
+                EXPECT_EQ(IsBitSet(transposed, j * 8 + i), IsBitSet(val, i * 8 + j));
+            }
+        }
+
+        EXPECT_EQ(Transpose8x8(transposed), val);
+    }
+}
+
+TEST(Transpose, Transpose64x64) {
+    static_assert([] {
+        std::array<std::uint64_t, 64> rows {};
+        rows[0] = 0b110;
+        Transpose64x64(rows);
+        return rows[0] == 0 && rows[1] == 1 && rows[2] == 1 && rows[3] == 0;
+    }());
+
+    const auto vals {test::RandomValues<std::uint64_t>(64)};
+    std::array<std::uint64_t, 64> rows;
+    std::ranges::copy(vals, rows.begin());
+    Transpose64x64(rows);
+    for (std::size_t i {0}; i != rows.size(); ++i) {
+        for (std::size_t j {0}; j != rows.size(); ++j) {
+            EXPECT_EQ(IsBitSet(rows[j], i), IsBitSet(vals[i], j));
+        }
+    }
+
+    Transpose64x64(rows);
+    EXPECT_TRUE(std::ranges::equal(rows, vals));
+}
+
+TEST(Transpose, Bulk) {
+    ExpectTranspose<std::uint8_t>();
+    ExpectTranspose<std::uint16_t>();
+    ExpectTranspose<std::uint32_t>();
+    ExpectTranspose<std::uint64_t>();
+}
+
+#if defined(BIT_MANIP_DISPATCH)
+
+template <std::unsigned_integral T>
+void ExpectKernels() {
+    using Kernel = std::size_t (*)(const void*, std::size_t, std::size_t, std::uint64_t* const*);
+    constexpr std::size_t bit_count {sizeof(T) * CHAR_BIT};
+    std::vector<Kernel> kernels {&detail::TransposeSse2<sizeof(T)>};
+    if (GetCpuFeatures().avx2) {
+        kernels.push_back(&detail::TransposeAvx2<sizeof(T)>);
+    }
+
+    const auto rows {test::RandomValues<T>(300)};
+    for (const auto kernel : kernels) {
+        std::vector<std::uint64_t> cols(bit_count * 5);
+        const auto ptrs {ColumnPointers<T>(cols, 5)};
+        EXPECT_EQ(kernel(rows.data(), 64, rows.size(), ptrs.data()), 256);
+
+        auto expected {TransposeLoop(rows, 5)};
+        for (std::size_t j {0}; j != bit_count; ++j) {
+            // Only the second to fourth words are written.
+            expected[j * 5] = 0;
+            expected[j * 5 + 4] = 0;
+        }
+
+        EXPECT_EQ(cols, expected);
+    }
+}
+
+TEST(Transpose, Kernels) {
+    ExpectKernels<std::uint8_t>();
+    ExpectKernels<std::uint16_t>();
+    ExpectKernels<std::uint32_t>();
+    ExpectKernels<std::uint64_t>();
+}
+
+#endif
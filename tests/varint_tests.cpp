@@ -0,0 +1,146 @@
+#include "bit_manip/varint.h"
+#include "test_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <limits>
+#include <vector>
+
+using namespace bit;
+
+namespace {
+
+//! Make values whose encoded sizes are spread from 1 to 10 bytes.
+std::vector<std::uint64_t> MakeMixedValues(const std::size_t size) {
+    auto vals {test::RandomValues<std::uint64_t>(size)};
+    for (auto& val : vals) {
+        val >>= val % 64;
+    }
+
+    return vals;
+}
+
+void ExpectRoundTrip(const std::vector<std::uint64_t>& vals) {
+    std::vector<std::uint8_t> encoded(vals.size() * max_varint_size);
+    const auto size {EncodeVarints(vals, encoded)};
+    encoded.resize(size);
+
+    std::size_t expected_size {0};
+    for (const auto val : vals) {
+        expected_size += VarintSize(val);
+    }
+
+    ASSERT_EQ(size, expected_size);
+
+    // A buffer of the exact size is enough.
+    std::vector<std::uint8_t> exact(expected_size);
+    EXPECT_EQ(EncodeVarints(vals, exact), size);
+    EXPECT_EQ(exact, encoded);
+
+    std::vector<std::uint64_t> decoded(vals.size());
+    EXPECT_EQ(DecodeVarints(encoded, decoded), size);
+    EXPECT_EQ(decoded, vals);
+
+    std::ranges::fill(decoded, 0);
+    EXPECT_EQ(DecodeVarintsChecked(encoded, decoded), size);
+    EXPECT_EQ(decoded, vals);
+}
+
+}  // namespace
+
+TEST(Varint, Size) {
+    static_assert(VarintSize(0) == 1);
+    static_assert(VarintSize(0x7F) == 1);
+    static_assert(VarintSize(0x80) == 2);
+    static_assert(VarintSize(0x3FFF) == 2);
+    static_assert(VarintSize(0x4000) == 3);
+    static_assert(VarintSize(std::numeric_limits<std::uint64_t>::max()) == max_varint_size);
+}
+
+TEST(Varint, Encode) {
+    std::vector<std::uint8_t> out(max_varint_size);
+    EXPECT_EQ(EncodeVarint(0, out), 1);
+    EXPECT_EQ(out[0], 0);
+
+    EXPECT_EQ(EncodeVarint(300, out), 2);
+    EXPECT_EQ(out[0], 0xAC);
+    EXPECT_EQ(out[1], 0x02);
+
+    EXPECT_EQ(EncodeVarint(std::numeric_limits<std::uint64_t>::max(), out), 10);
+    EXPECT_EQ(out[8], 0xFF);
+    EXPECT_EQ(out[9], 0x01);
+}
+
+TEST(Varint, Decode) {
+    const std::vector<std::uint8_t> in {0xAC, 0x02, 0x7F};
+    std::uint64_t val {0};
+    EXPECT_EQ(DecodeVarint(in, val), 2);
+    EXPECT_EQ(val, 300);
+    EXPECT_EQ(DecodeVarintChecked(in, val), 2);
+    EXPECT_EQ(val, 300);
+
+    // A redundant zero group is accepted.
+    EXPECT_EQ(DecodeVarintChecked(std::vector<std::uint8_t> {0x81, 0x00}, val), 2);
+    EXPECT_EQ(val, 1);
+}
+
+TEST(Varint, RejectMalformed) {
+    std::uint64_t val {0};
+    EXPECT_EQ(DecodeVarintChecked({}, val), std::nullopt);
+    EXPECT_EQ(DecodeVarintChecked(std::vector<std::uint8_t> {0x80, 0x80}, val), std::nullopt);
+
+    // The tenth byte can only hold bit 63.
+    std::vector<std::uint8_t> in(max_varint_size, 0xFF);
+    in.back() = 0x01;
+    EXPECT_EQ(DecodeVarintChecked(in, val), max_varint_size);
+    in.back() = 0x02;
+    EXPECT_EQ(DecodeVarintChecked(in, val), std::nullopt);
+    in.back() = 0x81;
+    in.push_back(0x00);
+    EXPECT_EQ(DecodeVarintChecked(in, val), std::nullopt);
+}
+
+TEST(Varint, RoundTrip) {
+    ExpectRoundTrip({});
+    ExpectRoundTrip({0, 1, 0x7F, 0x80, std::numeric_limits<std::uint64_t>::max()});
+    ExpectRoundTrip(std::vector<std::uint64_t>(100, 5));
+    ExpectRoundTrip(MakeMixedValues(1000));
+
+    auto small {MakeMixedValues(1000)};
+    for (auto& val : small) {
+        val %= 0x100;
+    }
+
+    ExpectRoundTrip(small);
+
+    // Mix single-byte and two-byte values with a few longer ones.
+    auto short_vals {MakeMixedValues(1000)};
+    for (std::size_t i {0}; i != short_vals.size(); ++i) {
+        short_vals[i] %= i % 97 == 0 ? 0x100'0000 : 0x4000;
+    }
+
+    ExpectRoundTrip(short_vals);
+
+    // Return to short values after a run of long ones.
+    auto runs {MakeMixedValues(2000)};
+    for (std::size_t i {runs.size() / 2}; i != runs.size(); ++i) {
+        runs[i] %= 0x4000;
+    }
+
+    ExpectRoundTrip(runs);
+}
+
+TEST(Varint, BulkRejectsTruncated) {
+    const auto vals {MakeMixedValues(100)};
+    std::vector<std::uint8_t> encoded(vals.size() * max_varint_size);
+    encoded.resize(EncodeVarints(vals, encoded));
+
+    std::vector<std::uint64_t> decoded(vals.size());
+    const std::span<const std::uint8_t> truncated {encoded.data(), encoded.size() - 1};
+    EXPECT_EQ(DecodeVarintsChecked(truncated, decoded), std::nullopt);
+
+    // Asking for fewer values stops before the end.
+    decoded.resize(vals.size() - 1);
+    EXPECT_EQ(DecodeVarintsChecked(truncated, decoded),
+              encoded.size() - VarintSize(vals.back()));
+}